@@ -2,6 +2,8 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "schema.hpp"
 
@@ -68,6 +70,14 @@ private:
     /// @param out_fields Output vector to append fields to.
     static void _flatten_message_fields(const Schema& schema, const Message& message, std::vector<const Type*>& out_fields);
 
+    /// @brief Flatten message unions including inherited unions from parent.
+    /// @param schema The schema containing all messages.
+    /// @param message The message to flatten.
+    /// @param out_unions Output vector of (flattened field index, union) pairs.
+    /// @return Number of flattened fields of the message.
+    static std::size_t _flatten_message_unions(const Schema& schema, const Message& message,
+                                               std::vector<std::pair<std::size_t, const UnionDecl*>>& out_unions);
+
     /// @brief Check if a field is the special "msgType" field.
     /// @param field The field to check.
     /// @return True if this is a MessageType msgType field.
@@ -83,6 +93,12 @@ private:
     /// @param message The message to write.
     void _write_struct(std::ostringstream& output, const Message& message) const;
 
+    /// @brief Write a union block inside a struct declaration.
+    /// @param output The output stream to write to.
+    /// @param union_decl The union to write.
+    /// @param field_ordinal Next free ordinal; advanced past the union's fields.
+    static void _write_union(std::ostringstream& output, const UnionDecl& union_decl, std::size_t& field_ordinal);
+
     /// @brief Write all struct declarations in deterministic order.
     /// @param output The output stream to write to.
     void _write_all_structs(std::ostringstream& output) const;
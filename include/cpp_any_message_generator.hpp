@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "schema.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+/// @brief Generates the AnyMessage.hpp file with a closed std::variant over all messages.
+/// @details Creates AnyMessage, decode_any() and dispatch(), which select the concrete message
+///          from the msgType header with a switch and decode it in place, without the factory's
+///          heap allocation or dynamic casts in user code.
+class CppAnyMessageGenerator
+{
+public:
+    /// @brief Create a generator and immediately write the AnyMessage.hpp file to disk.
+    /// @param schema Parsed DSL schema.
+    /// @param output_directory Destination directory for the AnyMessage.hpp file.
+    /// @param include_prefix Include prefix for the generated file (e.g., "network/").
+    CppAnyMessageGenerator(const Schema& schema, const std::string& output_directory, const std::string& include_prefix = "");
+
+private:
+    /// @brief Reference to the schema being generated.
+    const Schema& _schema;
+
+    /// @brief Output directory path.
+    std::string _outputDirectory;
+
+    /// @brief Include prefix for the generated file.
+    std::string _includePrefix;
+
+    /// @brief Resolve the output directory path.
+    /// @param path The user-provided path.
+    /// @return The resolved output directory path.
+    static std::string _resolve_output_directory(const std::string& path);
+
+    /// @brief Convert message name to MessageType enum value name.
+    /// @param message_name The message name (e.g., "YoutubeVideo").
+    /// @return The enum value name (e.g., "youtubeVideo").
+    static std::string _to_enum_value_name(const std::string& message_name);
+
+    /// @brief Get the names of all messages (value types excluded), sorted.
+    /// @return Message names.
+    std::vector<std::string> _get_message_names() const;
+
+    /// @brief Generate the complete AnyMessage.hpp file content.
+    /// @return The complete header file content.
+    std::string _generate_any_message_content();
+};
+
+} // namespace curious::dsl::capnpgen
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include "schema.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+/// @brief Generates <Message>Chunks.hpp for messages with a `@chunked` list field.
+/// @details Each file holds a splitter that encodes the message as a sequence of frames whose
+///          list slices stay under the configured size, and a reassembler that rebuilds the
+///          message or streams the list elements to a callback as the frames arrive.
+class CppChunkedGenerator
+{
+public:
+    /// @brief Create a generator and immediately write the chunking headers to disk.
+    /// @param schema Parsed DSL schema.
+    /// @param output_directory Destination directory for the header files.
+    /// @param include_prefix Include prefix for the generated files (e.g., "network/").
+    CppChunkedGenerator(const Schema& schema, const std::string& output_directory, const std::string& include_prefix = "");
+
+private:
+    /// @brief Reference to the schema being generated.
+    const Schema& _schema;
+
+    /// @brief Output directory path.
+    std::string _outputDirectory;
+
+    /// @brief Include prefix for the generated files.
+    std::string _includePrefix;
+
+    /// @brief Resolve the output directory path.
+    /// @param path The user-provided path.
+    /// @return The resolved output directory path.
+    static std::string _resolve_output_directory(const std::string& path);
+
+    /// @brief Convert field name to Cap'n Proto method name.
+    /// @param field_name The field name (e.g., "viewCount").
+    /// @return The method name suffix (e.g., "ViewCount").
+    static std::string _to_capnp_method_name(const std::string& field_name);
+
+    /// @brief Get all fields including inherited ones, parents first.
+    /// @param message The message to flatten.
+    /// @return All fields in Cap'n Proto field order.
+    std::vector<Type> _get_all_fields(const Message& message) const;
+
+    /// @brief Get all unions including inherited ones, parents first.
+    /// @param message The message to flatten.
+    /// @return All unions in Cap'n Proto field order.
+    std::vector<UnionDecl> _get_all_unions(const Message& message) const;
+
+    /// @brief Check if a type names a message (not an enum).
+    /// @param type The type to check.
+    /// @return True if the type is a nested message or value type.
+    bool _is_message_type(const Type& type) const;
+
+    /// @brief Generate the code copying one non-chunked field from the source into the first chunk.
+    /// @param content Output stream for the code.
+    /// @param field The field to copy.
+    void _generate_field_copy(std::ostringstream& content, const Type& field) const;
+
+    /// @brief Generate the code copying the active alternative of a union into the first chunk.
+    /// @param content Output stream for the code.
+    /// @param union_decl The union to copy.
+    void _generate_union_copy(std::ostringstream& content, const UnionDecl& union_decl) const;
+
+    /// @brief Generate the complete <Message>Chunks.hpp file content.
+    /// @param message The message with a `@chunked` field.
+    /// @return The complete header file content.
+    std::string _generate_chunks_content(const Message& message) const;
+};
+
+} // namespace curious::dsl::capnpgen
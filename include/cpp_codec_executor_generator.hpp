@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include "schema.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+/// @brief Generates the CodecExecutor.hpp file containing the batch codec worker pool.
+/// @details Creates the CodecExecutor class that decodes and encodes batches of independent
+///          messages on a work-stealing thread pool while preserving input order.
+class CppCodecExecutorGenerator
+{
+public:
+    /// @brief Create a generator and immediately write the CodecExecutor.hpp file to disk.
+    /// @param schema Parsed DSL schema containing namespace information.
+    /// @param output_directory Destination directory for the CodecExecutor.hpp file.
+    /// @param include_prefix Include prefix for the generated file (e.g., "network/").
+    CppCodecExecutorGenerator(const Schema& schema, const std::string& output_directory, const std::string& include_prefix = "");
+
+private:
+    /// @brief Reference to the schema being generated.
+    const Schema& _schema;
+
+    /// @brief Output directory path.
+    std::string _outputDirectory;
+
+    /// @brief Include prefix for the generated file.
+    std::string _includePrefix;
+
+    /// @brief Resolve the output directory path.
+    /// @param path The user-provided path.
+    /// @return The resolved output directory path.
+    static std::string _resolve_output_directory(const std::string& path);
+
+    /// @brief Generate the complete CodecExecutor.hpp file content.
+    /// @return The complete header file content.
+    std::string _generate_codec_executor_content();
+};
+
+} // namespace curious::dsl::capnpgen
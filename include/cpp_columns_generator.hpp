@@ -0,0 +1,75 @@
+#pragma once
+
+#include <set>
+#include <string>
+#include <vector>
+#include "schema.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+/// @brief Generates columnar (struct-of-arrays) batch types for messages used as list elements.
+/// @details Writes Columns.hpp (string columns and the columnar file writer/reader) and one
+///          <Message>Columns.hpp per message that appears as the element type of a list field.
+class CppColumnsGenerator
+{
+public:
+    /// @brief Create a generator and immediately write the columnar headers to disk.
+    /// @param schema Parsed DSL schema.
+    /// @param output_directory Destination directory for the header files.
+    /// @param include_prefix Include prefix for the generated files (e.g., "network/").
+    /// @param validate_utf8 Validate Text fields as UTF-8 in push_back_capnp().
+    CppColumnsGenerator(const Schema& schema, const std::string& output_directory, const std::string& include_prefix = "",
+                        bool validate_utf8 = false);
+
+private:
+    /// @brief Reference to the schema being generated.
+    const Schema& _schema;
+
+    /// @brief Output directory path.
+    std::string _outputDirectory;
+
+    /// @brief Include prefix for the generated files.
+    std::string _includePrefix;
+
+    /// @brief Whether push_back_capnp() checks Text fields with MessageBase::requireUtf8().
+    bool _validateUtf8;
+
+    /// @brief Wrapper namespace for generated code.
+    std::string _namespace;
+
+    /// @brief Resolve the output directory path.
+    /// @param path The user-provided path.
+    /// @return The resolved output directory path.
+    static std::string _resolve_output_directory(const std::string& path);
+
+    /// @brief Convert field name to Cap'n Proto method name.
+    /// @param field_name The C++ field name.
+    /// @return Cap'n Proto method name (camelCase with capital first letter).
+    static std::string _to_capnp_method_name(const std::string& field_name);
+
+    /// @brief Write a generated file.
+    /// @param file_name File name relative to the output directory.
+    /// @param content File content.
+    void _write_file(const std::string& file_name, const std::string& content) const;
+
+    /// @brief Collect the messages used as the element type of a list field.
+    /// @return Sorted message names.
+    std::set<std::string> _get_list_element_messages() const;
+
+    /// @brief Get all fields including inherited ones from parent classes.
+    /// @param message The message.
+    /// @return Vector of all fields (parent fields first, then own fields).
+    std::vector<Type> _get_all_fields(const Message& message) const;
+
+    /// @brief Generate the shared Columns.hpp file content.
+    /// @return The complete header file content.
+    std::string _generate_columns_runtime_content();
+
+    /// @brief Generate the <Message>Columns.hpp file content.
+    /// @param message The row message.
+    /// @return The complete header file content.
+    std::string _generate_message_columns_content(const Message& message);
+};
+
+} // namespace curious::dsl::capnpgen
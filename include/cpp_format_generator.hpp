@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include "schema.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+/// @brief Generates Format.hpp, the text formatting runtime used by the generated format_to() methods.
+/// @details The file holds truncation limits, a fixed-buffer output iterator, compile-time
+///          dispatching value formatters, and std::formatter support where <format> exists.
+///          Enum names come from the JsonEnumTraits tables in Json.hpp.
+class CppFormatGenerator
+{
+public:
+    /// @brief Create a generator and immediately write Format.hpp to disk.
+    /// @param schema Parsed DSL schema.
+    /// @param output_directory Destination directory for the header file.
+    /// @param include_prefix Include prefix for the generated file (e.g., "network/").
+    CppFormatGenerator(const Schema& schema, const std::string& output_directory, const std::string& include_prefix = "");
+
+private:
+    /// @brief Reference to the schema being generated.
+    const Schema& _schema;
+
+    /// @brief Output directory path.
+    std::string _outputDirectory;
+
+    /// @brief Include prefix for the generated file.
+    std::string _includePrefix;
+
+    /// @brief Resolve the output directory path.
+    /// @param path The user-provided path.
+    /// @return The resolved output directory path.
+    static std::string _resolve_output_directory(const std::string& path);
+
+    /// @brief Generate FormatLimits, FixedBufferIterator and the value formatters.
+    /// @return The declarations.
+    static std::string _generate_formatters();
+
+    /// @brief Generate the std::formatter specialization for generated types.
+    /// @param ns The C++ namespace of the generated types.
+    /// @return The specialization, guarded by __cpp_lib_format.
+    static std::string _generate_std_formatter(const std::string& ns);
+
+    /// @brief Generate the complete Format.hpp file content.
+    /// @return The complete header file content.
+    std::string _generate_format_content() const;
+};
+
+} // namespace curious::dsl::capnpgen
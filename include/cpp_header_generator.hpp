@@ -1,8 +1,12 @@
 #pragma once
 
+#include <set>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 #include "schema.hpp"
+#include "struct_layout.hpp"
 
 namespace curious::dsl::capnpgen
 {
@@ -15,7 +19,10 @@ public:
     /// @brief Create a generator and immediately write header files to disk.
     /// @param schema Parsed DSL schema.
     /// @param output_directory Destination directory for header files.
-    CppHeaderGenerator(const Schema& schema, const std::string& output_directory);
+    /// @param static_dispatch Mark leaf messages final and derive them from MessageImpl<Leaf>.
+    /// @param validate_utf8 Validate Text fields as UTF-8 while decoding them.
+    CppHeaderGenerator(const Schema& schema, const std::string& output_directory, bool static_dispatch = false,
+                       bool validate_utf8 = false);
 
 private:
     /// @brief Reference to the schema being generated.
@@ -24,6 +31,12 @@ private:
     /// @brief Output directory path.
     std::string _outputDirectory;
 
+    /// @brief Whether leaf messages are generated final with the MessageImpl CRTP base.
+    bool _staticDispatch;
+
+    /// @brief Whether decoding checks Text fields with MessageBase::requireUtf8().
+    bool _validateUtf8;
+
     /// @brief Resolve the output directory path.
     /// @param path The user-provided path.
     /// @return The resolved output directory path.
@@ -55,6 +68,15 @@ private:
                                           const std::string& user_protected,
                                           const std::string& user_private);
 
+    /// @brief Write the header of a generated value type (e.g., YoutubeVideoData.hpp).
+    /// @param message The value type.
+    void _generate_value_struct_for_message(const Message& message);
+
+    /// @brief Generate the value type header content.
+    /// @param message The value type.
+    /// @return The complete header file content.
+    std::string _generate_value_struct_content(const Message& message);
+
     /// @brief Generate field declarations section.
     /// @param message The message.
     /// @return Generated field declarations.
@@ -70,15 +92,87 @@ private:
     /// @return The parent class name, or "MessageBase" if no parent.
     std::string _get_parent_class_name(const Message& message);
 
+    /// @brief Check if no other message extends this one.
+    /// @param message The message.
+    /// @return True for leaf messages.
+    bool _is_leaf_message(const Message& message) const;
+
+    /// @brief Collect the names of all schema enums (for TypeConverter).
+    /// @return Set of enum type names.
+    std::set<std::string> _get_known_enum_names() const;
+
+    /// @brief Get the data section slots of this message's own fixed-width fields.
+    /// @param message The message.
+    /// @return Own fields paired with their slots, in declaration order.
+    std::vector<std::pair<Type, DataFieldSlot>> _get_own_patch_slots(const Message& message) const;
+
+    /// @brief Get all fields including inherited ones from parent classes.
+    /// @param message The message.
+    /// @return Vector of all fields (parent fields first, then own fields).
+    std::vector<Type> _get_all_fields(const Message& message) const;
+
+    /// @brief Get all unions including inherited ones from parent classes.
+    /// @param message The message.
+    /// @return Vector of all unions (parent unions first, then own unions).
+    std::vector<UnionDecl> _get_all_unions(const Message& message) const;
+
+    /// @brief Generate the member declaration of a union.
+    /// @param union_decl The union.
+    /// @return Generated declaration with its doc comment.
+    static std::string _generate_union_declaration(const UnionDecl& union_decl);
+
+    /// @brief Generate masked from_capnp_struct code for a single field.
+    /// @param content Output stream.
+    /// @param field The field.
+    /// @param helper_scope Qualifier for MessageBase helpers (e.g., "MessageBase::"), empty inside messages.
+    void _generate_masked_from_capnp_struct_field(std::ostringstream& content, const Type& field,
+                                                  const std::string& helper_scope = "") const;
+
+    /// @brief Generate masked from_capnp_struct code for a union, selected by its member name.
+    /// @param content Output stream.
+    /// @param union_decl The union.
+    void _generate_masked_from_capnp_struct_union(std::ostringstream& content, const UnionDecl& union_decl) const;
+
     /// @brief Generate to_capnp_struct code for a single field.
     /// @param content Output stream.
     /// @param field The field.
-    void _generate_to_capnp_struct_field(std::ostringstream& content, const Type& field) const;
+    /// @param helper_scope Qualifier for MessageBase helpers (e.g., "MessageBase::"), empty inside messages.
+    void _generate_to_capnp_struct_field(std::ostringstream& content, const Type& field,
+                                         const std::string& helper_scope = "") const;
 
     /// @brief Generate from_capnp_struct code for a single field.
     /// @param content Output stream.
     /// @param field The field.
-    void _generate_from_capnp_struct_field(std::ostringstream& content, const Type& field) const;
+    /// @param helper_scope Qualifier for MessageBase helpers (e.g., "MessageBase::"), empty inside messages.
+    void _generate_from_capnp_struct_field(std::ostringstream& content, const Type& field,
+                                           const std::string& helper_scope = "") const;
+
+    /// @brief Generate the in-class JSON field-name table and method declarations.
+    /// @param content Output stream.
+    /// @param fields All fields written to JSON, in order.
+    /// @param unions All unions, written after the fields as {"alternative": value} objects.
+    static void _generate_json_declarations(std::ostringstream& content, const std::vector<Type>& fields,
+                                            const std::vector<UnionDecl>& unions);
+
+    /// @brief Generate the inline to_json/from_json definitions.
+    /// @param content Output stream.
+    /// @param class_name The message or value type name.
+    /// @param fields All fields written to JSON, in the same order as the declarations.
+    /// @param unions All unions, in the same order as the declarations.
+    static void _generate_json_definitions(std::ostringstream& content, const std::string& class_name,
+                                           const std::vector<Type>& fields, const std::vector<UnionDecl>& unions);
+
+    /// @brief Generate the in-class format_to declaration.
+    /// @param content Output stream.
+    static void _generate_format_declaration(std::ostringstream& content);
+
+    /// @brief Generate the format_to template definition.
+    /// @param content Output stream.
+    /// @param class_name The message or value type name.
+    /// @param fields All fields to print, in order.
+    /// @param unions All unions, printed after the fields with their active alternative.
+    static void _generate_format_definition(std::ostringstream& content, const std::string& class_name,
+                                            const std::vector<Type>& fields, const std::vector<UnionDecl>& unions);
 };
 
 } // namespace curious::dsl::capnpgen
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include "schema.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+/// @brief Generates Json.hpp, the JSON runtime used by the generated to_json()/from_json() methods.
+/// @details The file holds a streaming JsonWriter, a single-pass JsonReader, compile-time
+///          dispatching field codecs, and a name table for every enum in the schema.
+class CppJsonGenerator
+{
+public:
+    /// @brief Create a generator and immediately write Json.hpp to disk.
+    /// @param schema Parsed DSL schema.
+    /// @param output_directory Destination directory for the header file.
+    /// @param include_prefix Include prefix for the generated file (e.g., "network/").
+    CppJsonGenerator(const Schema& schema, const std::string& output_directory, const std::string& include_prefix = "");
+
+private:
+    /// @brief Reference to the schema being generated.
+    const Schema& _schema;
+
+    /// @brief Output directory path.
+    std::string _outputDirectory;
+
+    /// @brief Include prefix for the generated file.
+    std::string _includePrefix;
+
+    /// @brief Resolve the output directory path.
+    /// @param path The user-provided path.
+    /// @return The resolved output directory path.
+    static std::string _resolve_output_directory(const std::string& path);
+
+    /// @brief Generate the JsonWriter class.
+    /// @return The class definition.
+    static std::string _generate_writer();
+
+    /// @brief Generate the JsonReader tokenizer class.
+    /// @return The class definition.
+    static std::string _generate_reader();
+
+    /// @brief Generate jsonWrite()/jsonRead() and their map key and enum helpers.
+    /// @return The function templates.
+    static std::string _generate_field_codecs();
+
+    /// @brief Generate the JsonEnumTraits specialization for one enum.
+    /// @param enum_decl The enum declaration.
+    /// @return The specialization.
+    static std::string _generate_enum_traits(const EnumDecl& enum_decl);
+
+    /// @brief Generate the complete Json.hpp file content.
+    /// @return The complete header file content.
+    std::string _generate_json_content() const;
+};
+
+} // namespace curious::dsl::capnpgen
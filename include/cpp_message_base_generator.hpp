@@ -35,6 +35,42 @@ private:
     /// @brief Generate the complete MessageBase.hpp file content.
     /// @return The complete header file content.
     std::string _generate_message_base_content();
+
+    /// @brief Generate the SharedSerializedData refcounted buffer class.
+    /// @return The class definition code.
+    std::string _generate_shared_serialized_data();
+
+    /// @brief Generate the public bulk list copy and prefetch helpers of MessageBase.
+    /// @return The helper method definitions.
+    std::string _generate_list_copy_helpers();
+
+    /// @brief Generate the public UTF-8 validation helpers of MessageBase.
+    /// @return The helper method definitions.
+    std::string _generate_utf8_helpers();
+
+    /// @brief Generate the protected in-place patching helpers of MessageBase.
+    /// @return The helper method definitions.
+    std::string _generate_patch_helpers();
+
+    /// @brief Generate the SharedField copy-on-write template for @shared fields.
+    /// @return The template definition code.
+    std::string _generate_shared_field();
+
+    /// @brief Generate the ParallelExecutor interface and its inline/async implementations.
+    /// @return The class definitions code.
+    std::string _generate_parallel_executors();
+
+    /// @brief Generate the FieldMask class used by masked deserialization.
+    /// @return The class definition code.
+    std::string _generate_field_mask();
+
+    /// @brief Generate the MessageImpl CRTP base for statically dispatched encode/decode.
+    /// @return The template definition code.
+    std::string _generate_message_impl();
+
+    /// @brief Generate the ListAppender orphan-backed list builder used by builder classes and writers.
+    /// @return The template definition code.
+    std::string _generate_list_appender();
 };
 
 } // namespace curious::dsl::capnpgen
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "schema.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+/// @brief Generates builder-backed <Message>Builder.hpp classes for all messages.
+/// @details Each builder owns a Cap'n Proto message arena and writes every setter straight into
+///          it, with lists grown in place through ListAppender, so serialization is a hand-off
+///          of the arena segments instead of a second copy out of C++ containers. Messages with
+///          list fields also get a forward-only <Message>Writer.hpp for streaming huge lists.
+class CppMessageBuilderGenerator
+{
+public:
+    /// @brief Create a generator and immediately write the builder headers to disk.
+    /// @param schema Parsed DSL schema.
+    /// @param output_directory Destination directory for the header files.
+    /// @param include_prefix Include prefix for the generated files (e.g., "network/").
+    CppMessageBuilderGenerator(const Schema& schema, const std::string& output_directory, const std::string& include_prefix = "");
+
+private:
+    /// @brief Reference to the schema being generated.
+    const Schema& _schema;
+
+    /// @brief Output directory path.
+    std::string _outputDirectory;
+
+    /// @brief Include prefix for the generated files.
+    std::string _includePrefix;
+
+    /// @brief Resolve the output directory path.
+    /// @param path The user-provided path.
+    /// @return The resolved output directory path.
+    static std::string _resolve_output_directory(const std::string& path);
+
+    /// @brief Convert message name to MessageType enum value name.
+    /// @param message_name The message name (e.g., "YoutubeVideo").
+    /// @return The enum value name (e.g., "youtubeVideo").
+    static std::string _to_enum_value_name(const std::string& message_name);
+
+    /// @brief Convert field name to Cap'n Proto method name.
+    /// @param field_name The field name (e.g., "viewCount").
+    /// @return The method name suffix (e.g., "ViewCount").
+    static std::string _to_capnp_method_name(const std::string& field_name);
+
+    /// @brief Get all fields including inherited ones, parents first.
+    /// @param message The message to flatten.
+    /// @return All fields in Cap'n Proto field order.
+    std::vector<Type> _get_all_fields(const Message& message) const;
+
+    /// @brief Check if a type names an enum (including MessageType).
+    /// @param type The type to check.
+    /// @return True if the type is an enum.
+    bool _is_enum_type(const Type& type) const;
+
+    /// @brief Check if a type names a message (not an enum).
+    /// @param type The type to check.
+    /// @return True if the type is a nested message or value type.
+    bool _is_message_type(const Type& type) const;
+
+    /// @brief Write one generated header to the output directory.
+    /// @param file_name The header file name.
+    /// @param content The file content.
+    void _write_file(const std::string& file_name, const std::string& content) const;
+
+    /// @brief Generate the accessors for one field.
+    /// @param field The field to generate accessors for.
+    /// @param capnp_ns The Cap'n Proto C++ namespace.
+    /// @param with_getters False for forward-only writers, which only set and append.
+    /// @param public_content Receives the public accessors.
+    /// @param private_content Receives list appender members and helpers.
+    void _generate_field_accessors(const Type& field, const std::string& capnp_ns,
+                                   bool with_getters, std::ostringstream& public_content, std::ostringstream& private_content) const;
+
+    /// @brief Generate the complete <Message>Builder.hpp or <Message>Writer.hpp file content.
+    /// @param message The message to generate a builder for.
+    /// @param forward_only True for the <Message>Writer variant.
+    /// @return The complete header file content.
+    std::string _generate_builder_content(const Message& message, bool forward_only) const;
+};
+
+} // namespace curious::dsl::capnpgen
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include "schema.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+/// @brief Generates MessageLog.hpp, an append-only message log over memory-mapped segment files.
+/// @details The file holds MessageLogWriter (framed appends, segment rotation, a sparse offset
+///          and timestamp index, compaction by key) and MessageLogReader (zero-copy iteration,
+///          seeking, and timed replay through the factory).
+class CppMessageLogGenerator
+{
+public:
+    /// @brief Create a generator and immediately write MessageLog.hpp to disk.
+    /// @param schema Parsed DSL schema.
+    /// @param output_directory Destination directory for the header file.
+    /// @param include_prefix Include prefix for the generated file (e.g., "network/").
+    CppMessageLogGenerator(const Schema& schema, const std::string& output_directory, const std::string& include_prefix = "");
+
+private:
+    /// @brief Reference to the schema being generated.
+    const Schema& _schema;
+
+    /// @brief Output directory path.
+    std::string _outputDirectory;
+
+    /// @brief Include prefix for the generated file.
+    std::string _includePrefix;
+
+    /// @brief Resolve the output directory path.
+    /// @param path The user-provided path.
+    /// @return The resolved output directory path.
+    static std::string _resolve_output_directory(const std::string& path);
+
+    /// @brief Generate the record layout, segment, writer and reader classes.
+    /// @return The class definitions.
+    static std::string _generate_log_classes();
+
+    /// @brief Generate the complete MessageLog.hpp file content.
+    /// @return The complete header file content.
+    std::string _generate_message_log_content() const;
+};
+
+} // namespace curious::dsl::capnpgen
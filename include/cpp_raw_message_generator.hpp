@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include "schema.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+/// @brief Generates the RawMessage.hpp file containing the zero-decode forwarding handle.
+/// @details Creates the RawMessage class that owns a received buffer, validates it, and lets
+///          proxies peek the message type and routing fields before forwarding the bytes as-is.
+class CppRawMessageGenerator
+{
+public:
+    /// @brief Create a generator and immediately write the RawMessage.hpp file to disk.
+    /// @param schema Parsed DSL schema containing namespace information.
+    /// @param output_directory Destination directory for the RawMessage.hpp file.
+    /// @param include_prefix Include prefix for the generated file (e.g., "network/").
+    CppRawMessageGenerator(const Schema& schema, const std::string& output_directory, const std::string& include_prefix = "");
+
+private:
+    /// @brief Reference to the schema being generated.
+    const Schema& _schema;
+
+    /// @brief Output directory path.
+    std::string _outputDirectory;
+
+    /// @brief Include prefix for the generated file.
+    std::string _includePrefix;
+
+    /// @brief Resolve the output directory path.
+    /// @param path The user-provided path.
+    /// @return The resolved output directory path.
+    static std::string _resolve_output_directory(const std::string& path);
+
+    /// @brief Generate the complete RawMessage.hpp file content.
+    /// @return The complete header file content.
+    std::string _generate_raw_message_content();
+};
+
+} // namespace curious::dsl::capnpgen
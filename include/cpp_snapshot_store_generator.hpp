@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include "schema.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+/// @brief Generates read-only, memory-mapped snapshot stores for messages with a `@key` field.
+/// @details Writes SnapshotStore.hpp (file layout, SnapshotStoreWriter and the mmap'd SnapshotStore
+///          with binary-search lookups) and one <Message>SnapshotStore.hpp per keyed message that
+///          binds the templates to the key field.
+class CppSnapshotStoreGenerator
+{
+public:
+    /// @brief Create a generator and immediately write the snapshot store headers to disk.
+    /// @param schema Parsed DSL schema.
+    /// @param output_directory Destination directory for the header files.
+    /// @param include_prefix Include prefix for the generated files (e.g., "network/").
+    CppSnapshotStoreGenerator(const Schema& schema, const std::string& output_directory, const std::string& include_prefix = "");
+
+private:
+    /// @brief Reference to the schema being generated.
+    const Schema& _schema;
+
+    /// @brief Output directory path.
+    std::string _outputDirectory;
+
+    /// @brief Include prefix for the generated files.
+    std::string _includePrefix;
+
+    /// @brief Wrapper namespace for generated code.
+    std::string _namespace;
+
+    /// @brief Resolve the output directory path.
+    /// @param path The user-provided path.
+    /// @return The resolved output directory path.
+    static std::string _resolve_output_directory(const std::string& path);
+
+    /// @brief Write a generated file.
+    /// @param file_name File name relative to the output directory.
+    /// @param content File content.
+    void _write_file(const std::string& file_name, const std::string& content) const;
+
+    /// @brief Generate the file layout, writer and store templates.
+    /// @return The class definitions.
+    static std::string _generate_store_classes();
+
+    /// @brief Generate the shared SnapshotStore.hpp file content.
+    /// @return The complete header file content.
+    std::string _generate_snapshot_store_content() const;
+
+    /// @brief Generate the <Message>SnapshotStore.hpp file content.
+    /// @param message The message with a `@key` field.
+    /// @return The complete header file content.
+    std::string _generate_message_snapshot_store_content(const Message& message) const;
+};
+
+} // namespace curious::dsl::capnpgen
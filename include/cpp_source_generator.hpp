@@ -18,10 +18,12 @@ public:
     /// @param output_directory Destination directory for source files.
     /// @param capnp_header_name Name of the generated Cap'n Proto header file.
     /// @param include_prefix Prefix for header includes (e.g., "network/" for #include "network/Message.hpp").
+    /// @param validate_utf8 Validate Text fields as UTF-8 while decoding them.
     CppSourceGenerator(const Schema& schema,
                        const std::string& output_directory,
                        const std::string& capnp_header_name = "network_msg.capnp.h",
-                       const std::string& include_prefix = "");
+                       const std::string& include_prefix = "",
+                       bool validate_utf8 = false);
 
 private:
     /// @brief Reference to the schema being generated.
@@ -36,6 +38,9 @@ private:
     /// @brief Include prefix for header files (e.g., "network/").
     std::string _includePrefix;
 
+    /// @brief Whether decoding checks Text fields with MessageBase::requireUtf8().
+    bool _validateUtf8;
+
     /// @brief Set of known enum names for proper handling in TypeConverter.
     std::set<std::string> _enumNames;
 
@@ -122,6 +127,11 @@ private:
     /// @return True if it's a schema enum.
     bool _is_schema_enum(const std::string& type_name) const;
 
+    /// @brief Check if a list field is decoded through parallelDecodeList().
+    /// @param field The field to check.
+    /// @return True for lists of nested messages or strings.
+    bool _is_parallel_list(const Type& field) const;
+
     /// @brief Generate to_capnp code for a single field.
     /// @param field The field to generate code for.
     /// @param builder_expr The builder expression (e.g., "root").
@@ -138,6 +148,11 @@ private:
     /// @param message The message.
     /// @return Vector of all fields (parent fields first, then own fields).
     std::vector<Type> _get_all_fields(const Message& message) const;
+
+    /// @brief Get all unions including inherited ones from parent classes.
+    /// @param message The message.
+    /// @return Vector of all unions (parent unions first, then own unions).
+    std::vector<UnionDecl> _get_all_unions(const Message& message) const;
 };
 
 } // namespace curious::dsl::capnpgen
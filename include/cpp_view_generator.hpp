@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "schema.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+/// @brief Generates header-only projection classes for DSL views.
+/// @details For `view Name of Message { ... }` writes Name.hpp: a compact, non-polymorphic class
+///          holding only the selected fields that decodes them directly from full Message data.
+class CppViewGenerator
+{
+public:
+    /// @brief Create a generator and immediately write one header per view to disk.
+    /// @param schema Parsed DSL schema.
+    /// @param output_directory Destination directory for the header files.
+    /// @param include_prefix Include prefix for the generated files (e.g., "network/").
+    /// @param validate_utf8 Validate Text fields as UTF-8 while decoding them.
+    CppViewGenerator(const Schema& schema, const std::string& output_directory, const std::string& include_prefix = "",
+                     bool validate_utf8 = false);
+
+private:
+    /// @brief Reference to the schema being generated.
+    const Schema& _schema;
+
+    /// @brief Output directory path.
+    std::string _outputDirectory;
+
+    /// @brief Include prefix for the generated files.
+    std::string _includePrefix;
+
+    /// @brief Whether decoding checks Text fields with MessageBase::requireUtf8().
+    bool _validateUtf8;
+
+    /// @brief Resolve the output directory path.
+    /// @param path The user-provided path.
+    /// @return The resolved output directory path.
+    static std::string _resolve_output_directory(const std::string& path);
+
+    /// @brief Convert field name to Cap'n Proto method name.
+    /// @param field_name The C++ field name.
+    /// @return Cap'n Proto method name (camelCase with capital first letter).
+    static std::string _to_capnp_method_name(const std::string& field_name);
+
+    /// @brief Find a field in a message or its parents.
+    /// @param message_name The message to search.
+    /// @param field_name The field name.
+    /// @return The field type.
+    const Type& _find_field(const std::string& message_name, const std::string& field_name) const;
+
+    /// @brief Check if a type name is a schema-defined enum.
+    /// @param type_name The type name to check.
+    /// @return True if it's a schema enum.
+    bool _is_schema_enum(const std::string& type_name) const;
+
+    /// @brief Generate the header file content for a view.
+    /// @param view The view.
+    /// @return The complete header file content.
+    std::string _generate_view_content(const View& view);
+
+    /// @brief Generate decoding code for one projected field.
+    /// @param field The source field.
+    /// @param view_name The nested view applied to the field (may be empty).
+    /// @return Generated code (indented for the from_capnp_struct body).
+    std::string _generate_field_decode(const Type& field, const std::string& view_name);
+};
+
+} // namespace curious::dsl::capnpgen
@@ -7,7 +7,7 @@ namespace curious::dsl::capnpgen
 {
 
 /// @brief A simple lexical analyzer for tokenizing DSL input.
-/// @details Breaks source text into tokens, handling identifiers, numbers, symbols, and whitespace.
+/// @details Breaks source text into tokens, handling identifiers, numbers, string literals, symbols, and whitespace.
 class Lexer
 {
 public:
@@ -68,6 +68,10 @@ private:
     /// @brief Read a number token starting at the current position.
     /// @return The number token.
     Token _read_number();
+
+    /// @brief Read a double-quoted string literal starting at the current position.
+    /// @return The string token, including its quotes and escape sequences.
+    Token _read_string();
 };
 
 } // namespace curious::dsl::capnpgen
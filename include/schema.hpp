@@ -14,6 +14,27 @@ namespace curious::dsl::capnpgen
 // Forward declaration
 class Lexer;
 
+/// @brief A `union { ... }` block: fields of which exactly one is set at a time.
+struct UnionDecl
+{
+    /// @brief Union name (a named Cap'n Proto union); empty for the message's unnamed union.
+    std::string name;
+
+    /// @brief Alternatives in declaration order; the first one is active by default.
+    std::vector<Type> arms;
+
+    /// @brief Number of the message's own fields declared before the union (keeps ordinals in order).
+    std::size_t position{0};
+
+    /// @brief Get the C++ member holding the active alternative.
+    /// @return The union name, or "alternative" for the unnamed union.
+    std::string get_member_name() const;
+
+    /// @brief Get the C++ member type.
+    /// @return The variant type (e.g., "std::variant<std::string, YoutubeVideo>").
+    std::string get_cpp_type() const;
+};
+
 /// @brief Simple message container parsed from the DSL.
 struct Message
 {
@@ -29,6 +50,25 @@ struct Message
     /// @brief Parsed field types (in declaration order).
     std::vector<Type> fields;
 
+    /// @brief Parsed `union` blocks (in declaration order).
+    std::vector<UnionDecl> unions;
+
+    /// @brief Message this value type was derived from by `@value` (empty for DSL messages).
+    std::string value_of;
+
+    /// @brief Name of the `@chunked` list field split across frames (empty if none).
+    std::string chunked_field;
+
+    /// @brief Target encoded size of one chunk of chunked_field, in bytes.
+    std::uint64_t chunk_max_bytes{0};
+
+    /// @brief Name of the `@key` field indexing snapshot files (empty if none).
+    std::string key_field;
+
+    /// @brief Check if this is a generated value type (no msgType, no base class).
+    /// @return True if value_of is set.
+    bool is_value_type() const noexcept { return !value_of.empty(); }
+
     /// @brief Return the Cap'n Proto-style hex id string (e.g., "@0x0000000000000001").
     /// @return Formatted ID string.
     std::string get_capnp_id_string() const;
@@ -61,6 +101,29 @@ struct EnumDecl
     std::uint64_t capnp_id{0};
 };
 
+/// @brief One field selected by a view.
+struct ViewField
+{
+    /// @brief Field name in the source message.
+    std::string name;
+
+    /// @brief View applied to a nested message (or list element) field; empty decodes it fully.
+    std::string view_name;
+};
+
+/// @brief Projection of a message declared with `view Name of Message { field; ... }`.
+struct View
+{
+    /// @brief View name.
+    std::string name;
+
+    /// @brief Name of the projected message.
+    std::string source_name;
+
+    /// @brief Selected fields (in declaration order).
+    std::vector<ViewField> fields;
+};
+
 /// @brief Full schema: namespace, messages, and enums; supports parsing from a file.
 class Schema
 {
@@ -84,6 +147,9 @@ public:
     /// @brief Enums by name.
     std::unordered_map<std::string, EnumDecl> enums;
 
+    /// @brief Views (field projections) by name.
+    std::unordered_map<std::string, View> views;
+
     /// @brief Parse and populate this schema from a DSL file path.
     /// @param file_path The path to the DSL file.
     /// @throws std::runtime_error on errors.
@@ -116,6 +182,42 @@ private:
     /// @brief Parse a message declaration.
     void _parse_message();
 
+    /// @brief Parse a view declaration.
+    void _parse_view();
+
+    /// @brief Retarget `@value` fields to generated value types, creating them as needed.
+    void _expand_value_types();
+
+    /// @brief Get or create the value type for a message (e.g., YoutubeVideo -> YoutubeVideoData).
+    /// @param message_name The message to derive from.
+    /// @return The value type name.
+    std::string _ensure_value_type(const std::string& message_name);
+
+    /// @brief Record `@chunked` fields and add the chunkIndex/chunkCount continuation header.
+    void _expand_chunked_fields();
+
+    /// @brief Check that every view projects existing fields of an existing message.
+    void _validate_views() const;
+
+    /// @brief Parse a `union [name] { ... }` block from a message body.
+    /// @param message The message receiving the union.
+    /// @param line The body item starting with 'union'.
+    /// @return The rest of the item after the closing '}' (the next field, if any).
+    std::string _parse_union(Message& message, const std::string& line);
+
+    /// @brief Check union names and alternatives, including unions inherited from parents.
+    void _validate_unions() const;
+
+    /// @brief Check that `@optional` fields are pointer fields whose presence Cap'n Proto records.
+    void _validate_optional_fields() const;
+
+    /// @brief Check declared default values against their field types and store them canonically.
+    void _validate_default_values();
+
+    /// @brief Validate the annotations attached to a message's fields.
+    /// @param message The message whose fields to check.
+    void _validate_field_annotations(const Message& message) const;
+
     /// @brief Ensure the MessageType enum exists and is properly populated.
     void _ensure_message_type_enum();
 
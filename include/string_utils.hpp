@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -22,12 +24,13 @@ std::string trim(const std::string& str);
 std::string read_file(const std::string& file_path);
 
 /// @brief Remove C++ style comments (// and /* */) from source text.
+/// @details String literals are copied verbatim, so '//' or '#' inside quotes is kept.
 /// @param input The source text potentially containing comments.
 /// @return A new string with comments replaced by spaces.
 std::string strip_comments(const std::string& input);
 
 /// @brief Split a string by a delimiter, respecting nested brackets.
-/// @details Ignores delimiters inside <>, (), or {} pairs.
+/// @details Ignores delimiters inside <>, (), or {} pairs and inside string literals.
 /// @param str The string to split.
 /// @param delimiter The character to split on.
 /// @return A vector of trimmed substrings.
@@ -54,6 +57,11 @@ std::string to_cpp_namespace(const std::string& ns);
 /// @return The string in lowerCamelCase (e.g., "youtubeVideo").
 std::string to_lower_camel_case(const std::string& str);
 
+/// @brief Parse a byte size with an optional unit (e.g., "4096", "64KiB", "1MiB", "2 MB").
+/// @param str The size string; whitespace is ignored and units are case-insensitive.
+/// @return The size in bytes, or std::nullopt if the string is not a valid size.
+std::optional<std::uint64_t> parse_byte_size(const std::string& str);
+
 } // namespace string_utils
 
 } // namespace curious::dsl::capnpgen
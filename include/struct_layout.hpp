@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "schema.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+/// @brief Position of a fixed-width field inside a struct's data section.
+struct DataFieldSlot
+{
+    /// @brief Field name.
+    std::string field_name;
+
+    /// @brief log2 of the field size in bits (0 = Bool, 3 = 8-bit ... 6 = 64-bit).
+    unsigned lg_size_bits{0};
+
+    /// @brief Offset from the start of the data section, in bits.
+    std::uint32_t bit_offset{0};
+};
+
+/// @brief Estimated size of a generated C++ class (LP64, libstdc++ container sizes).
+struct ObjectSizeEstimate
+{
+    /// @brief sizeof the class.
+    std::size_t size{0};
+
+    /// @brief Size without tail padding (where a derived class places its first member).
+    std::size_t data_size{0};
+
+    /// @brief alignof the class.
+    std::size_t alignment{1};
+};
+
+/// @brief Mirrors the Cap'n Proto compiler's data section allocation for generated structs.
+/// @details Fields are placed in ordinal order; each goes into the first free aligned hole
+///          of its size, otherwise the data section grows by one word. This matches the
+///          layout capnp computes for the flattened structs written by CapnpFileGenerator.
+class StructLayout
+{
+public:
+    /// @brief Compute the data section layout of a message's Cap'n Proto struct.
+    /// @param schema The schema (for parents, enums, and nested messages).
+    /// @param message The message.
+    /// @return Slots of all fixed-width fields (inherited + own), in ordinal order, up to the first union.
+    static std::vector<DataFieldSlot> compute_data_slots(const Schema& schema, const Message& message);
+
+    /// @brief Get the log2 bit size of a field stored in the data section.
+    /// @param schema The schema (to tell enums from nested messages).
+    /// @param field The field.
+    /// @return The size, or std::nullopt for pointer fields.
+    static std::optional<unsigned> get_data_lg_size(const Schema& schema, const Type& field);
+
+    /// @brief Get the smallest integer type holding every value of an enum, at least 16 bits wide.
+    /// @details Cap'n Proto enums are UInt16 on the wire, so narrower types would wrap unknown values.
+    /// @param enum_decl The enum.
+    /// @return The C++ type name (e.g., "std::uint16_t").
+    static std::string get_enum_underlying_type(const EnumDecl& enum_decl);
+
+    /// @brief Order a message's own fields for the generated C++ class.
+    /// @details @hot fields first, @cold fields last, and each group by decreasing alignment,
+    ///          so members pack without padding. Value types keep declaration order, since
+    ///          aggregate initialization follows it. The wire order is never affected.
+    /// @param schema The schema (for enum and nested message sizes).
+    /// @param message The message.
+    /// @return The own fields in member declaration order.
+    static std::vector<Type> order_members(const Schema& schema, const Message& message);
+
+    /// @brief Estimate sizeof a generated class.
+    /// @param schema The schema.
+    /// @param message The message (its parents are included).
+    /// @param optimized True for the generated layout (order_members(), compact enums), false for
+    ///                  DSL declaration order with std::int64_t enums.
+    /// @return The estimate.
+    static ObjectSizeEstimate estimate_object_size(const Schema& schema, const Message& message, bool optimized);
+
+private:
+    /// @brief Get the byte size of the smallest integer type holding every value of an enum.
+    /// @param enum_decl The enum.
+    /// @return 2, 4, or 8.
+    static std::size_t _get_enum_underlying_size(const EnumDecl& enum_decl);
+
+    /// @brief Estimate the size and alignment of one generated member.
+    /// @param schema The schema.
+    /// @param field The field.
+    /// @param optimized See estimate_object_size().
+    /// @return The estimate (data_size equals size).
+    static ObjectSizeEstimate _estimate_member_size(const Schema& schema, const Type& field, bool optimized);
+
+    /// @brief Free hole offset per size class (in units of that size), 0 if none.
+    std::array<std::uint32_t, 6> _holes{};
+
+    /// @brief Data section size in words.
+    std::uint32_t _dataWordCount{0};
+
+    /// @brief Allocate a data field.
+    /// @param lg_size_bits log2 of the field size in bits.
+    /// @return Offset in units of the field size.
+    std::uint32_t _add_data(unsigned lg_size_bits);
+
+    /// @brief Take a hole of the given size, splitting a larger one if needed.
+    /// @param lg_size_bits log2 of the hole size in bits.
+    /// @return Offset in units of the hole size, or std::nullopt if none is free.
+    std::optional<std::uint32_t> _try_allocate_hole(unsigned lg_size_bits);
+};
+
+} // namespace curious::dsl::capnpgen
@@ -10,6 +10,16 @@
 namespace curious::dsl::capnpgen
 {
 
+/// @brief A DSL field annotation (e.g., "@shared" or "@chunked(max_bytes=1MiB)").
+struct FieldAnnotation
+{
+    /// @brief Annotation name without the leading '@'.
+    std::string name;
+
+    /// @brief Raw text between the parentheses (empty if none were given).
+    std::string arguments;
+};
+
 /// @brief Represents a parsed DSL type (primitive, custom, enum, list, or map).
 /// @details Provides conversion utilities to C++ and Cap'n Proto type names.
 class Type
@@ -87,6 +97,32 @@ public:
     /// @return A vector of enum value names.
     const std::vector<std::string>& get_enum_values() const noexcept;
 
+    /// @brief Get the annotations attached to this field (in declaration order).
+    /// @return A vector of annotations.
+    const std::vector<FieldAnnotation>& get_annotations() const noexcept;
+
+    /// @brief Check if the field carries a given annotation.
+    /// @param name The annotation name without '@' (e.g., "shared").
+    /// @return True if the annotation is present.
+    bool has_annotation(std::string_view name) const noexcept;
+
+    /// @brief Get the raw arguments of an annotation.
+    /// @param name The annotation name without '@'.
+    /// @return The argument text, or an empty string if absent or argument-less.
+    std::string get_annotation_arguments(std::string_view name) const;
+
+    /// @brief Check if the field declares a default value (e.g., "int32 timeout = 30000;").
+    /// @return True if a default value is present.
+    bool has_default_value() const noexcept;
+
+    /// @brief Get the declared default value as written in the DSL.
+    /// @return The literal (string literals keep their quotes), or an empty string if absent.
+    const std::string& get_default_value() const noexcept;
+
+    /// @brief Replace the declared default value (used to store the validated, canonical form).
+    /// @param value The default literal.
+    void set_default_value(std::string value);
+
     /// @brief Get the element type (valid only if kind==List).
     /// @return Pointer to the element type, or nullptr if not a list.
     const Type* get_element_type() const noexcept;
@@ -99,6 +135,14 @@ public:
     /// @return Pointer to the value type, or nullptr if not a map.
     const Type* get_value_type() const noexcept;
 
+    /// @brief Retarget a custom type (or a list of it) to another custom type name.
+    /// @param custom_name The new type name (e.g., "YoutubeVideoData").
+    void set_custom_name(std::string custom_name);
+
+    /// @brief Drop all field annotations except, optionally, one that changes the field's meaning.
+    /// @param keep The annotation name to retain (e.g., "optional"), or empty to drop all.
+    void clear_annotations(std::string_view keep = {}) noexcept;
+
     /// @brief Get the corresponding C++ type string (e.g., std::vector<int>).
     /// @return The C++ type representation.
     std::string get_cpp_type() const;
@@ -137,6 +181,12 @@ private:
     /// @brief Field name in DSL struct.
     std::string _fieldName;
 
+    /// @brief Field annotations (e.g., @shared).
+    std::vector<FieldAnnotation> _annotations;
+
+    /// @brief Declared default value literal (empty if none).
+    std::string _defaultValue;
+
     /// @brief Deep copy helper used by copy constructor and assignment.
     /// @param other The type to copy from.
     void _copy_from(const Type& other);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "schema.hpp"
 #include "type.hpp"
 #include <string>
 #include <sstream>
@@ -18,12 +19,14 @@ public:
     /// @param target_var The C++ variable to assign to (e.g., "field_name").
     /// @param indent The indentation level.
     /// @param known_enums Optional set of known enum type names for proper handling.
+    /// @param validate_utf8 Check Text values with MessageBase::requireUtf8() while decoding.
     /// @return Generated C++ code as a string.
     static std::string generate_from_capnp_code(const Type& field,
                                                   const std::string& reader_expr,
                                                   const std::string& target_var,
                                                   int indent = 1,
-                                                  const std::set<std::string>& known_enums = {});
+                                                  const std::set<std::string>& known_enums = {},
+                                                  bool validate_utf8 = false);
 
     /// @brief Generate C++ code to convert from C++ to Cap'n Proto for a field.
     /// @param field The field type to convert.
@@ -40,11 +43,98 @@ public:
                                                 int indent = 1,
                                                 const std::set<std::string>& known_enums = {});
 
-    /// @brief Get the C++ default value expression for a type.
+    /// @brief Generate C++ code that encodes an @optional field only while it holds a value.
+    /// @details An unset field leaves its pointer null; an engaged empty list or map is still written.
+    /// @param field The @optional field (member name is the field name).
+    /// @param builder_expr The Cap'n Proto builder of the enclosing struct (e.g., "builder").
+    /// @param indent The indentation level.
+    /// @param known_enums Optional set of known enum type names for proper handling.
+    /// @return Generated C++ code as a string.
+    static std::string generate_optional_to_capnp_code(const Type& field,
+                                                       const std::string& builder_expr,
+                                                       int indent = 1,
+                                                       const std::set<std::string>& known_enums = {});
+
+    /// @brief Generate C++ code that decodes an @optional field, resetting it when the pointer is null.
+    /// @param field The @optional field (member name is the field name).
+    /// @param reader_expr The Cap'n Proto reader of the enclosing struct (e.g., "reader").
+    /// @param indent The indentation level.
+    /// @param known_enums Optional set of known enum type names for proper handling.
+    /// @param validate_utf8 Check Text values with MessageBase::requireUtf8() while decoding.
+    /// @return Generated C++ code as a string.
+    static std::string generate_optional_from_capnp_code(const Type& field,
+                                                         const std::string& reader_expr,
+                                                         int indent = 1,
+                                                         const std::set<std::string>& known_enums = {},
+                                                         bool validate_utf8 = false);
+
+    /// @brief Generate C++ code that encodes the active alternative of a union member.
+    /// @details Only the active alternative is written; empty lists and maps still select theirs.
+    /// @param union_decl The union to convert.
+    /// @param builder_expr The Cap'n Proto builder of the enclosing struct (e.g., "builder").
+    /// @param indent The indentation level.
+    /// @param known_enums Optional set of known enum type names for proper handling.
+    /// @return Generated C++ code as a string.
+    static std::string generate_union_to_capnp_code(const UnionDecl& union_decl,
+                                                    const std::string& builder_expr,
+                                                    int indent = 1,
+                                                    const std::set<std::string>& known_enums = {});
+
+    /// @brief Generate C++ code that decodes only the active alternative of a union into its variant.
+    /// @param union_decl The union to convert.
+    /// @param reader_expr The Cap'n Proto reader of the enclosing struct (e.g., "reader").
+    /// @param indent The indentation level.
+    /// @param known_enums Optional set of known enum type names for proper handling.
+    /// @param validate_utf8 Check Text values with MessageBase::requireUtf8() while decoding.
+    /// @return Generated C++ code as a string.
+    static std::string generate_union_from_capnp_code(const UnionDecl& union_decl,
+                                                      const std::string& reader_expr,
+                                                      int indent = 1,
+                                                      const std::set<std::string>& known_enums = {},
+                                                      bool validate_utf8 = false);
+
+    /// @brief Check if a type is a fixed-width primitive whose list layout matches the wire.
+    /// @param type The type to check (typically a list element type).
+    /// @return True for integer and floating-point primitives (not bool, text, or data).
+    static bool is_fixed_width_primitive(const Type& type);
+
+    /// @brief Get the expression that yields an @optional member's value, engaging it if unset.
+    /// @details A value that is already engaged is reused so its strings and vectors keep their buffers.
+    /// @param member_expr The member access expression (e.g., "avatar").
+    /// @return Lvalue expression (e.g., "(avatar ? *avatar : avatar.emplace())").
+    static std::string get_engaged_expr(const std::string& member_expr);
+
+    /// @brief Get the C++ data member type for a field, including storage wrappers.
+    /// @details Fields annotated with @shared are stored as SharedField<T> (copy-on-write) and
+    ///          @optional fields as std::optional<T>.
+    /// @param field The field type.
+    /// @return C++ member type (e.g., "SharedField<std::vector<YoutubeVideo>>").
+    static std::string get_member_type(const Type& field);
+
+    /// @brief Get the expression that reads a field's value as its plain C++ type.
+    /// @param field The field type.
+    /// @param member_expr The member access expression (e.g., "videos" or "other.videos").
+    /// @return Read-only value expression (e.g., "videos.get()" for @shared fields, "(*videos)" for
+    ///         @optional ones, which the caller must have checked are set).
+    static std::string get_value_expr(const Type& field, const std::string& member_expr);
+
+    /// @brief Get the C++ default value expression for a field.
+    /// @details Uses the DSL default (e.g., "int32 timeout = 30000;") when one is declared.
     /// @param field The field type.
-    /// @return C++ default value expression (e.g., "0", "{}", "\"\"").
+    /// @return C++ default value expression (e.g., "0", "30000", "Status::OK", "{}", "\"\"").
     static std::string get_default_value(const Type& field);
 
+    /// @brief Get the Cap'n Proto C++ type for a DSL type (as used in Orphan<T> or List<T>).
+    /// @param type The type.
+    /// @param capnp_namespace C++ namespace of the generated capnp structs (e.g., "curious::message").
+    /// @return Type name (e.g., "::capnp::List<::capnp::Text>", "std::int32_t", "::curious::message::Status").
+    static std::string get_capnp_cpp_type(const Type& type, const std::string& capnp_namespace);
+
+    /// @brief Convert a field name to its Cap'n Proto `Which` enumerant (e.g., "errorMessage" -> "ERROR_MESSAGE").
+    /// @param field_name The union field name.
+    /// @return The enumerant name.
+    static std::string to_capnp_enumerant_name(const std::string& field_name);
+
 private:
     /// @brief Generate indentation string.
     /// @param level The indentation level.
@@ -56,6 +146,30 @@ private:
     /// @return Cap'n Proto method name (camelCase with capital first letter).
     static std::string to_capnp_method_name(const std::string& field_name);
 
+    /// @brief Generate from_capnp code without the has*() check of pointer fields.
+    /// @details Same parameters as generate_from_capnp_code(); the caller checks presence.
+    static std::string generate_from_capnp_body(const Type& field,
+                                                const std::string& reader_expr,
+                                                const std::string& target_var,
+                                                int indent_level,
+                                                const std::set<std::string>& known_enums,
+                                                bool validate_utf8);
+
+    /// @brief Generate to_capnp code without the empty check (lists, maps) or scope (messages).
+    /// @details Same parameters as generate_to_capnp_code(); empty lists and maps are still written.
+    static std::string generate_to_capnp_body(const Type& field,
+                                              const std::string& builder_expr,
+                                              const std::string& source_var,
+                                              const std::string& field_name_capnp,
+                                              int indent_level,
+                                              const std::set<std::string>& known_enums);
+
+    /// @brief Check if generated code guards a field on presence (nested message, list or map).
+    /// @param field The field type.
+    /// @param known_enums Set of known enum type names.
+    /// @return True for a nested message, list or map field.
+    static bool has_presence(const Type& field, const std::set<std::string>& known_enums);
+
     /// @brief Check if a type is an enum (considering known_enums set).
     /// @param type The type to check.
     /// @param known_enums Set of known enum type names.
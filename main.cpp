@@ -1,18 +1,55 @@
 #include "capnp_file_generator.hpp"
+#include "cpp_any_message_generator.hpp"
+#include "cpp_chunked_generator.hpp"
+#include "cpp_codec_executor_generator.hpp"
+#include "cpp_columns_generator.hpp"
 #include "cpp_enum_generator.hpp"
 #include "cpp_factory_generator.hpp"
+#include "cpp_format_generator.hpp"
 #include "cpp_header_generator.hpp"
+#include "cpp_json_generator.hpp"
 #include "cpp_message_base_generator.hpp"
+#include "cpp_message_builder_generator.hpp"
+#include "cpp_message_log_generator.hpp"
+#include "cpp_raw_message_generator.hpp"
+#include "cpp_snapshot_store_generator.hpp"
 #include "cpp_source_generator.hpp"
+#include "cpp_view_generator.hpp"
 #include "schema.hpp"
+#include "struct_layout.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <map>
+#include <vector>
 
 namespace
 {
 
+/// @brief Print the estimated sizeof of each message class before and after layout optimization.
+/// @param schema The parsed schema.
+void print_member_layout_report(const curious::dsl::capnpgen::Schema& schema)
+{
+    using namespace curious::dsl::capnpgen;
+
+    std::vector<std::string> message_names;
+    for (const auto& [name, message] : schema.messages)
+    {
+        message_names.push_back(name);
+    }
+    std::sort(message_names.begin(), message_names.end());
+
+    std::cout << "  Member layout (estimated sizeof, DSL order with 64-bit enums -> generated):\n";
+    for (const auto& name : message_names)
+    {
+        const Message& message = schema.messages.at(name);
+        auto declared = StructLayout::estimate_object_size(schema, message, false);
+        auto optimized = StructLayout::estimate_object_size(schema, message, true);
+        std::cout << "    " << name << ": " << declared.size << " -> " << optimized.size << " bytes\n";
+    }
+}
+
 /// @brief Parse command-line arguments into a map.
 /// @param argc Argument count.
 /// @param argv Argument vector.
@@ -53,6 +90,14 @@ std::map<std::string, std::string> parse_arguments(int argc, char** argv)
                 args["out-cpp"] = argv[++i];
             }
         }
+        else if (arg == "--static-dispatch")
+        {
+            args["static-dispatch"] = "true";
+        }
+        else if (arg == "--validate-utf8")
+        {
+            args["validate-utf8"] = "true";
+        }
         else if (arg == "--help" || arg == "-h")
         {
             args["help"] = "true";
@@ -76,6 +121,10 @@ void print_usage(const char* program_name)
     std::cout << "Optional Options:\n";
     std::cout << "  -ohpp, --out-hpp <dir>   Output directory for C++ header files (.hpp)\n";
     std::cout << "  -ocpp, --out-cpp <dir>   Output directory for C++ source files (.cpp)\n";
+    std::cout << "  --static-dispatch        Mark leaf message classes final and derive them from\n";
+    std::cout << "                           MessageImpl<Leaf> for non-virtual encode/decode\n";
+    std::cout << "  --validate-utf8          Reject Text fields that are not valid UTF-8 while\n";
+    std::cout << "                           decoding them\n";
     std::cout << "  -h, --help               Show this help message\n\n";
     std::cout << "Examples:\n";
     std::cout << "  # Generate only Cap'n Proto schema:\n";
@@ -219,17 +268,64 @@ int main(int argc, char** argv)
             CppEnumGenerator enum_generator(schema, hpp_output, include_prefix);
             std::cout << "✓ Generated enums.hpp with " << schema.enums.size() << " enum(s)\n";
 
+            // Generate the JSON runtime (required by headers)
+            CppJsonGenerator json_generator(schema, hpp_output, include_prefix);
+            std::cout << "✓ Generated Json.hpp\n";
+
+            // Generate the formatting runtime (required by headers, uses Json.hpp enum names)
+            CppFormatGenerator format_generator(schema, hpp_output, include_prefix);
+            std::cout << "✓ Generated Format.hpp\n";
+
             // Generate headers
-            CppHeaderGenerator header_generator(schema, hpp_output);
+            CppHeaderGenerator header_generator(schema, hpp_output, args.count("static-dispatch") > 0,
+                                                args.count("validate-utf8") > 0);
             std::cout << "✓ Generated " << schema.messages.size() << " header file(s)\n";
+            print_member_layout_report(schema);
 
             // Generate sources with include prefix
-            CppSourceGenerator source_generator(schema, cpp_output, "network_msg.capnp.h", include_prefix);
+            CppSourceGenerator source_generator(schema, cpp_output, "network_msg.capnp.h", include_prefix,
+                                                args.count("validate-utf8") > 0);
             std::cout << "✓ Generated " << schema.messages.size() << " source file(s)\n";
 
             // Generate factory builder
             CppFactoryGenerator factory_generator(schema, hpp_output, include_prefix);
-            std::cout << "✓ Generated factory_builder.h\n\n";
+            std::cout << "✓ Generated factory_builder.h\n";
+
+            // Generate raw forwarding handle (uses the factory for on-demand decoding)
+            CppRawMessageGenerator raw_message_generator(schema, hpp_output, include_prefix);
+            std::cout << "✓ Generated RawMessage.hpp\n";
+
+            // Generate the memory-mapped message log (uses RawMessage and the factory)
+            CppMessageLogGenerator message_log_generator(schema, hpp_output, include_prefix);
+            std::cout << "✓ Generated MessageLog.hpp\n";
+
+            // Generate mmap'd snapshot stores for @key messages (use RawMessage for zero-copy views)
+            CppSnapshotStoreGenerator snapshot_store_generator(schema, hpp_output, include_prefix);
+            std::cout << "✓ Generated SnapshotStore.hpp and snapshot stores for @key messages\n";
+
+            // Generate batch codec pool (uses the factory to decode by message type)
+            CppCodecExecutorGenerator codec_executor_generator(schema, hpp_output, include_prefix);
+            std::cout << "✓ Generated CodecExecutor.hpp\n";
+
+            // Generate the closed message variant and static dispatch
+            CppAnyMessageGenerator any_message_generator(schema, hpp_output, include_prefix);
+            std::cout << "✓ Generated AnyMessage.hpp\n";
+
+            // Generate arena-backed builders and streaming writers (use ListAppender from MessageBase)
+            CppMessageBuilderGenerator message_builder_generator(schema, hpp_output, include_prefix);
+            std::cout << "✓ Generated message builder and writer headers\n";
+
+            // Generate frame splitters/reassemblers for @chunked list fields
+            CppChunkedGenerator chunked_generator(schema, hpp_output, include_prefix);
+            std::cout << "✓ Generated chunking headers for @chunked fields\n";
+
+            // Generate columnar batch types for list element messages
+            CppColumnsGenerator columns_generator(schema, hpp_output, include_prefix, args.count("validate-utf8") > 0);
+            std::cout << "✓ Generated Columns.hpp and columnar batch types\n";
+
+            // Generate projection classes for DSL views
+            CppViewGenerator view_generator(schema, hpp_output, include_prefix, args.count("validate-utf8") > 0);
+            std::cout << "✓ Generated " << schema.views.size() << " view header(s)\n\n";
 
             std::cout << "C++ Usage Example:\n";
             std::cout << "  #include <" << include_prefix << "MessageName.hpp>\n";
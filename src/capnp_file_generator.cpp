@@ -128,6 +128,29 @@ void CapnpFileGenerator::_flatten_message_fields(const Schema& schema,
     }
 }
 
+std::size_t CapnpFileGenerator::_flatten_message_unions(const Schema& schema,
+                                                        const Message& message,
+                                                        std::vector<std::pair<std::size_t, const UnionDecl*>>& out_unions)
+{
+    // Positions are shifted past the fields flattened in from parents
+    std::size_t field_offset = 0;
+    if (!message.parent_name.empty())
+    {
+        auto parent_it = schema.messages.find(message.parent_name);
+        if (parent_it != schema.messages.end())
+        {
+            field_offset = _flatten_message_unions(schema, parent_it->second, out_unions);
+        }
+    }
+
+    for (const auto& union_decl : message.unions)
+    {
+        out_unions.emplace_back(field_offset + union_decl.position, &union_decl);
+    }
+
+    return field_offset + message.fields.size();
+}
+
 bool CapnpFileGenerator::_is_message_type_field(const Type& field)
 {
     return (field.get_kind() == Type::Kind::Custom || field.get_kind() == Type::Kind::Enum) &&
@@ -221,15 +244,30 @@ void CapnpFileGenerator::_write_struct(std::ostringstream& output, const Message
 
     std::size_t field_ordinal = 0;
 
-    // Ensure msgType is first field
-    if (!has_message_type_first)
+    // Ensure msgType is first field (value types are nested-only and carry no header)
+    if (!has_message_type_first && !message.is_value_type())
     {
         output << "  msgType @" << field_ordinal++ << " : MessageType;\n";
     }
 
+    // Unions are written where they were declared, so ordinals follow declaration order
+    std::vector<std::pair<std::size_t, const UnionDecl*>> all_unions;
+    _flatten_message_unions(_schema, message, all_unions);
+    std::size_t next_union = 0;
+    auto write_unions_before = [&](std::size_t field_index)
+    {
+        while (next_union < all_unions.size() && all_unions[next_union].first <= field_index)
+        {
+            _write_union(output, *all_unions[next_union++].second, field_ordinal);
+        }
+    };
+
     // Write all fields
-    for (const Type* field : all_fields)
+    for (std::size_t field_index = 0; field_index < all_fields.size(); ++field_index)
     {
+        write_unions_before(field_index);
+        const Type* field = all_fields[field_index];
+
         if (field_ordinal == 0 && _is_message_type_field(*field))
         {
             // This is the msgType field at position 0
@@ -241,12 +279,46 @@ void CapnpFileGenerator::_write_struct(std::ostringstream& output, const Message
 
         output << "  " << _to_capnp_identifier(field->get_field_name())
                << " @" << field_ordinal++
-               << " : " << _get_capnp_type_for_field(*field) << ";\n";
+               << " : " << _get_capnp_type_for_field(*field);
+
+        // Enum defaults name an enumerant; scalar and text literals are already valid capnp
+        if (field->has_default_value())
+        {
+            output << " = "
+                   << (field->is_custom() ? _to_capnp_identifier(field->get_default_value())
+                                          : field->get_default_value());
+        }
+
+        output << ";\n";
     }
+    write_unions_before(all_fields.size());
 
     output << "}\n\n";
 }
 
+void CapnpFileGenerator::_write_union(std::ostringstream& output, const UnionDecl& union_decl,
+                                      std::size_t& field_ordinal)
+{
+    // Named unions are groups and take no ordinal of their own
+    if (union_decl.name.empty())
+    {
+        output << "  union {\n";
+    }
+    else
+    {
+        output << "  " << _to_capnp_identifier(union_decl.name) << " :union {\n";
+    }
+
+    for (const auto& arm : union_decl.arms)
+    {
+        output << "    " << _to_capnp_identifier(arm.get_field_name())
+               << " @" << field_ordinal++
+               << " : " << _get_capnp_type_for_field(arm) << ";\n";
+    }
+
+    output << "  }\n";
+}
+
 void CapnpFileGenerator::_write_all_structs(std::ostringstream& output) const
 {
     // Collect and sort message names for deterministic output
@@ -0,0 +1,298 @@
+#include "cpp_any_message_generator.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "string_utils.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+// ---- Constructor ----
+
+CppAnyMessageGenerator::CppAnyMessageGenerator(const Schema& schema, const std::string& output_directory, const std::string& include_prefix)
+    : _schema(schema)
+    , _outputDirectory(_resolve_output_directory(output_directory))
+    , _includePrefix(include_prefix)
+{
+    namespace fs = std::filesystem;
+
+    // Construct output file path
+    fs::path output_file_path = fs::path(_outputDirectory) / "AnyMessage.hpp";
+
+    // Generate content
+    std::string content = _generate_any_message_content();
+
+    // Write to file
+    std::ofstream output_file(output_file_path, std::ios::binary);
+    if (!output_file)
+    {
+        throw std::runtime_error("Failed to create AnyMessage header file: " + output_file_path.string());
+    }
+
+    output_file << content;
+}
+
+// ---- Private static methods ----
+
+std::string CppAnyMessageGenerator::_resolve_output_directory(const std::string& path)
+{
+    namespace fs = std::filesystem;
+    fs::create_directories(path);
+    return path;
+}
+
+std::string CppAnyMessageGenerator::_to_enum_value_name(const std::string& message_name)
+{
+    if (message_name.empty())
+    {
+        return message_name;
+    }
+
+    // Convert PascalCase to camelCase (first letter lowercase)
+    std::string result = message_name;
+    result[0] = static_cast<char>(std::tolower(static_cast<unsigned char>(result[0])));
+    return result;
+}
+
+// ---- Private instance methods ----
+
+std::vector<std::string> CppAnyMessageGenerator::_get_message_names() const
+{
+    std::vector<std::string> message_names;
+    for (const auto& [name, message] : _schema.messages)
+    {
+        if (!message.is_value_type())
+        {
+            message_names.push_back(name);
+        }
+    }
+    std::sort(message_names.begin(), message_names.end());
+    return message_names;
+}
+
+std::string CppAnyMessageGenerator::_generate_any_message_content()
+{
+    std::ostringstream content;
+
+    // Use wrapper_namespace_name if specified, otherwise fall back to namespace_name
+    const std::string& raw_ns = _schema.wrapper_namespace_name.empty() ?
+                                  _schema.namespace_name : _schema.wrapper_namespace_name;
+    const std::string ns = raw_ns.empty() ?
+                             "curious::net" :
+                             string_utils::to_cpp_namespace(raw_ns);
+
+    const std::vector<std::string> message_names = _get_message_names();
+
+    // Header guard
+    content << "#pragma once\n\n";
+    content << "#ifndef ANYMESSAGE_HPP\n";
+    content << "#define ANYMESSAGE_HPP\n\n";
+
+    // Includes
+    content << "#include <cstddef>\n";
+    content << "#include <cstdint>\n";
+    content << "#include <optional>\n";
+    content << "#include <type_traits>\n";
+    content << "#include <utility>\n";
+    content << "#include <variant>\n";
+    content << "#include <vector>\n\n";
+    content << "#include <capnp/any.h>\n";
+    content << "#include <capnp/serialize.h>\n";
+    content << "#include <kj/array.h>\n\n";
+    content << "#include <" << _includePrefix << "MessageBase.hpp>\n";
+    content << "#include <" << _includePrefix << "enums.hpp>\n";
+    for (const auto& name : message_names)
+    {
+        content << "#include <" << _includePrefix << name << ".hpp>\n";
+    }
+    content << "\n";
+
+    // Open namespace
+    content << "namespace " << ns << "\n";
+    content << "{\n\n";
+
+    content << "/// @brief Build a visitor from lambdas: dispatch(data, size, overloaded{[](const A&) {}, ...}).\n";
+    content << "template<typename... Handlers>\n";
+    content << "struct overloaded : Handlers...\n";
+    content << "{\n";
+    content << "    using Handlers::operator()...;\n";
+    content << "};\n\n";
+
+    content << "template<typename... Handlers>\n";
+    content << "overloaded(Handlers...) -> overloaded<Handlers...>;\n\n";
+
+    content << "namespace any_message_detail\n";
+    content << "{\n\n";
+
+    content << "/// @brief Open a flat-array message and read its msgType header.\n";
+    content << "/// @param data Pointer to word-aligned serialized data.\n";
+    content << "/// @param size Size of the data buffer in bytes.\n";
+    content << "/// @param reader Receives the message reader.\n";
+    content << "/// @param type Receives the message type.\n";
+    content << "/// @return False if the buffer is not a valid message or its type is unknown.\n";
+    content << "inline bool open(const std::uint8_t* data, std::size_t size,\n";
+    content << "                 std::optional<::capnp::FlatArrayMessageReader>& reader, MessageType& type)\n";
+    content << "{\n";
+    content << "    try\n";
+    content << "    {\n";
+    content << "        kj::ArrayPtr<const capnp::word> words(reinterpret_cast<const capnp::word*>(data),\n";
+    content << "                                              size / sizeof(capnp::word));\n";
+    content << "        reader.emplace(words);\n\n";
+
+    content << "        // msgType is always field @0: the first little-endian UInt16 of the data section\n";
+    content << "        auto data_section = reader->getRoot<::capnp::AnyStruct>().getDataSection();\n";
+    content << "        std::uint16_t raw_type = 0;\n";
+    content << "        if (data_section.size() >= sizeof(std::uint16_t))\n";
+    content << "        {\n";
+    content << "            raw_type = static_cast<std::uint16_t>(data_section[0]) |\n";
+    content << "                       static_cast<std::uint16_t>(data_section[1] << 8);\n";
+    content << "        }\n";
+    content << "        if (!isValidMessageType(raw_type))\n";
+    content << "        {\n";
+    content << "            return false;\n";
+    content << "        }\n";
+    content << "        type = static_cast<MessageType>(raw_type);\n";
+    content << "        return true;\n";
+    content << "    }\n";
+    content << "    catch (...)\n";
+    content << "    {\n";
+    content << "        return false;\n";
+    content << "    }\n";
+    content << "}\n\n";
+
+    content << "/// @brief Decode a message, reporting malformed input as false.\n";
+    content << "template<typename Message>\n";
+    content << "bool decode(::capnp::FlatArrayMessageReader& reader, Message& message)\n";
+    content << "{\n";
+    content << "    try\n";
+    content << "    {\n";
+    content << "        message.from_capnp(reader);\n";
+    content << "        return true;\n";
+    content << "    }\n";
+    content << "    catch (...)\n";
+    content << "    {\n";
+    content << "        return false;\n";
+    content << "    }\n";
+    content << "}\n\n";
+
+    content << "} // namespace any_message_detail\n\n";
+
+    // The closed set of messages
+    content << "/// @brief Any generated message, stored inline.\n";
+    content << "using AnyMessage = std::variant<";
+    for (std::size_t i = 0; i < message_names.size(); ++i)
+    {
+        content << (i == 0 ? "\n    " : ",\n    ") << message_names[i];
+    }
+    content << ">;\n\n";
+
+    // decode_any
+    content << "/// @brief Decode a message of any type into an AnyMessage, without heap-allocating the object.\n";
+    content << "/// @param data Pointer to word-aligned serialized data.\n";
+    content << "/// @param size Size of the data buffer in bytes.\n";
+    content << "/// @return The decoded message, or std::nullopt if the buffer is malformed or of unknown type.\n";
+    content << "inline std::optional<AnyMessage> decode_any(const std::uint8_t* data, std::size_t size)\n";
+    content << "{\n";
+    content << "    std::optional<::capnp::FlatArrayMessageReader> reader;\n";
+    content << "    MessageType type{};\n";
+    content << "    if (!any_message_detail::open(data, size, reader, type))\n";
+    content << "    {\n";
+    content << "        return std::nullopt;\n";
+    content << "    }\n\n";
+
+    content << "    std::optional<AnyMessage> result;\n";
+    content << "    bool decoded = false;\n";
+    content << "    switch (type)\n";
+    content << "    {\n";
+    for (const auto& name : message_names)
+    {
+        content << "        case MessageType::" << _to_enum_value_name(name) << ":\n";
+        content << "            decoded = any_message_detail::decode(*reader, std::get<" << name
+                << ">(result.emplace(std::in_place_type<" << name << ">)));\n";
+        content << "            break;\n";
+    }
+    content << "        default:\n";
+    content << "            break;\n";
+    content << "    }\n\n";
+
+    content << "    if (!decoded)\n";
+    content << "    {\n";
+    content << "        result.reset();\n";
+    content << "    }\n";
+    content << "    return result;\n";
+    content << "}\n\n";
+
+    content << "/// @brief Decode a message of any type from a byte vector.\n";
+    content << "/// @param data The serialized data.\n";
+    content << "/// @return The decoded message, or std::nullopt if the buffer is malformed or of unknown type.\n";
+    content << "inline std::optional<AnyMessage> decode_any(const std::vector<std::uint8_t>& data)\n";
+    content << "{\n";
+    content << "    return decode_any(data.data(), data.size());\n";
+    content << "}\n\n";
+
+    // dispatch
+    content << "/// @brief Decode a message on the stack and call the visitor's handler for its type.\n";
+    content << "/// @details Every message type needs a handler; a missing one is a compile error. A handler taking\n";
+    content << "///          a base class counts for every derived message, so a catch-all such as\n";
+    content << "///          [](const NetworkMessage&) {} silences the check for types added later. The switch\n";
+    content << "///          on msgType compiles to a jump table.\n";
+    content << "/// @tparam Visitor Callable with every message type, e.g. overloaded{[](const A&) {}, ...}.\n";
+    content << "/// @param data Pointer to word-aligned serialized data.\n";
+    content << "/// @param size Size of the data buffer in bytes.\n";
+    content << "/// @param visitor The handlers.\n";
+    content << "/// @return False if the buffer is malformed or of unknown type. Handler exceptions propagate.\n";
+    content << "template<typename Visitor>\n";
+    content << "bool dispatch(const std::uint8_t* data, std::size_t size, Visitor&& visitor)\n";
+    content << "{\n";
+    for (const auto& name : message_names)
+    {
+        content << "    static_assert(std::is_invocable_v<Visitor&, " << name << "&>, \"dispatch: missing handler for "
+                << name << "\");\n";
+    }
+    if (!message_names.empty())
+    {
+        content << "\n";
+    }
+
+    content << "    std::optional<::capnp::FlatArrayMessageReader> reader;\n";
+    content << "    MessageType type{};\n";
+    content << "    if (!any_message_detail::open(data, size, reader, type))\n";
+    content << "    {\n";
+    content << "        return false;\n";
+    content << "    }\n\n";
+
+    content << "    switch (type)\n";
+    content << "    {\n";
+    for (const auto& name : message_names)
+    {
+        content << "        case MessageType::" << _to_enum_value_name(name) << ":\n";
+        content << "        {\n";
+        content << "            " << name << " message;\n";
+        content << "            if (!any_message_detail::decode(*reader, message))\n";
+        content << "            {\n";
+        content << "                return false;\n";
+        content << "            }\n";
+        content << "            visitor(message);\n";
+        content << "            return true;\n";
+        content << "        }\n";
+    }
+    content << "        default:\n";
+    content << "            return false;\n";
+    content << "    }\n";
+    content << "}\n\n";
+
+    // Close namespace
+    content << "} // namespace " << ns << "\n\n";
+
+    // Close header guard
+    content << "#endif // ANYMESSAGE_HPP\n";
+
+    return content.str();
+}
+
+} // namespace curious::dsl::capnpgen
@@ -0,0 +1,511 @@
+#include "cpp_chunked_generator.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "string_utils.hpp"
+#include "type_converter.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+// ---- Constructor ----
+
+CppChunkedGenerator::CppChunkedGenerator(const Schema& schema, const std::string& output_directory, const std::string& include_prefix)
+    : _schema(schema)
+    , _outputDirectory(_resolve_output_directory(output_directory))
+    , _includePrefix(include_prefix)
+{
+    namespace fs = std::filesystem;
+
+    for (const auto& [name, message] : _schema.messages)
+    {
+        if (message.chunked_field.empty())
+        {
+            continue;
+        }
+
+        fs::path output_file_path = fs::path(_outputDirectory) / (name + "Chunks.hpp");
+
+        std::ofstream output_file(output_file_path, std::ios::binary);
+        if (!output_file)
+        {
+            throw std::runtime_error("Failed to create chunks header file: " + output_file_path.string());
+        }
+
+        output_file << _generate_chunks_content(message);
+    }
+}
+
+// ---- Private static methods ----
+
+std::string CppChunkedGenerator::_resolve_output_directory(const std::string& path)
+{
+    namespace fs = std::filesystem;
+    fs::create_directories(path);
+    return path;
+}
+
+std::string CppChunkedGenerator::_to_capnp_method_name(const std::string& field_name)
+{
+    if (field_name.empty())
+    {
+        return field_name;
+    }
+
+    // Capitalize first letter for Cap'n Proto accessors (e.g., viewCount -> ViewCount)
+    std::string result = field_name;
+    result[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(result[0])));
+    return result;
+}
+
+// ---- Private instance methods ----
+
+std::vector<Type> CppChunkedGenerator::_get_all_fields(const Message& message) const
+{
+    std::vector<Type> all_fields;
+
+    // Recursively get parent fields first
+    if (!message.parent_name.empty())
+    {
+        auto parent_it = _schema.messages.find(message.parent_name);
+        if (parent_it != _schema.messages.end())
+        {
+            auto parent_fields = _get_all_fields(parent_it->second);
+            all_fields.insert(all_fields.end(), parent_fields.begin(), parent_fields.end());
+        }
+    }
+
+    // Add this message's own fields
+    all_fields.insert(all_fields.end(), message.fields.begin(), message.fields.end());
+
+    return all_fields;
+}
+
+std::vector<UnionDecl> CppChunkedGenerator::_get_all_unions(const Message& message) const
+{
+    std::vector<UnionDecl> all_unions;
+
+    // Recursively get parent unions first
+    if (!message.parent_name.empty())
+    {
+        auto parent_it = _schema.messages.find(message.parent_name);
+        if (parent_it != _schema.messages.end())
+        {
+            all_unions = _get_all_unions(parent_it->second);
+        }
+    }
+
+    all_unions.insert(all_unions.end(), message.unions.begin(), message.unions.end());
+
+    return all_unions;
+}
+
+bool CppChunkedGenerator::_is_message_type(const Type& type) const
+{
+    return type.is_custom() && _schema.enums.count(type.get_custom_name()) == 0 &&
+           _schema.messages.count(type.get_custom_name()) > 0;
+}
+
+void CppChunkedGenerator::_generate_field_copy(std::ostringstream& content, const Type& field) const
+{
+    const std::string method_name = _to_capnp_method_name(field.get_field_name());
+    const std::string capnp_type = field.get_capnp_type();
+
+    if (capnp_type == "Void")
+    {
+        return;
+    }
+    if (capnp_type == "AnyPointer")
+    {
+        content << "                chunk.get" << method_name << "().set(source.get" << method_name << "());\n";
+        return;
+    }
+
+    const bool is_pointer = field.is_list() || field.is_map() || _is_message_type(field) ||
+                            capnp_type == "Text" || capnp_type == "Data";
+    if (is_pointer)
+    {
+        content << "                if (source.has" << method_name << "())\n";
+        content << "                {\n";
+        content << "                    chunk.set" << method_name << "(source.get" << method_name << "());\n";
+        content << "                }\n";
+    }
+    else
+    {
+        content << "                chunk.set" << method_name << "(source.get" << method_name << "());\n";
+    }
+}
+
+void CppChunkedGenerator::_generate_union_copy(std::ostringstream& content, const UnionDecl& union_decl) const
+{
+    const std::string member = union_decl.get_member_name();
+
+    content << "                {\n";
+    std::string source_union = "source";
+    std::string chunk_union = "chunk";
+    if (!union_decl.name.empty())
+    {
+        // Members of a named union live in its group
+        source_union = "source_" + member;
+        chunk_union = "chunk_" + member;
+        content << "                    auto " << source_union << " = source.get" << _to_capnp_method_name(member) << "();\n";
+        content << "                    auto " << chunk_union << " = chunk.get" << _to_capnp_method_name(member) << "();\n";
+    }
+
+    // Setting the active arm also sets the discriminant, so pointer arms are copied even when empty
+    content << "                    switch (" << source_union << ".which())\n";
+    content << "                    {\n";
+    for (const auto& arm : union_decl.arms)
+    {
+        const std::string method_name = _to_capnp_method_name(arm.get_field_name());
+        content << "                        case decltype(" << source_union << ".which())::"
+                << TypeConverter::to_capnp_enumerant_name(arm.get_field_name()) << ":\n";
+        if (arm.get_capnp_type() == "Void")
+        {
+            content << "                            " << chunk_union << ".set" << method_name << "();\n";
+        }
+        else if (arm.get_capnp_type() == "AnyPointer")
+        {
+            content << "                            " << chunk_union << ".init" << method_name << "().set("
+                    << source_union << ".get" << method_name << "());\n";
+        }
+        else
+        {
+            content << "                            " << chunk_union << ".set" << method_name << "("
+                    << source_union << ".get" << method_name << "());\n";
+        }
+        content << "                            break;\n";
+    }
+    content << "                        default:\n";
+    content << "                            break;\n";
+    content << "                    }\n";
+    content << "                }\n";
+}
+
+std::string CppChunkedGenerator::_generate_chunks_content(const Message& message) const
+{
+    std::ostringstream content;
+
+    // Use wrapper_namespace_name if specified, otherwise fall back to namespace_name
+    const std::string& raw_ns = _schema.wrapper_namespace_name.empty() ?
+                                  _schema.namespace_name : _schema.wrapper_namespace_name;
+    const std::string ns = raw_ns.empty() ?
+                             "curious::net" :
+                             string_utils::to_cpp_namespace(raw_ns);
+
+    const std::vector<Type> all_fields = _get_all_fields(message);
+    const Type* chunked_field = nullptr;
+    for (const auto& field : message.fields)
+    {
+        if (field.get_field_name() == message.chunked_field)
+        {
+            chunked_field = &field;
+        }
+    }
+    if (chunked_field == nullptr || chunked_field->get_element_type() == nullptr)
+    {
+        throw std::runtime_error("Chunked field not found: " + message.name + "." + message.chunked_field);
+    }
+
+    const Type& element_type = *chunked_field->get_element_type();
+    const std::string& field_name = chunked_field->get_field_name();
+    const std::string method_name = _to_capnp_method_name(field_name);
+    const std::string element_capnp_type = element_type.get_capnp_type();
+    const bool element_is_message = _is_message_type(element_type);
+    const std::string container_expr = chunked_field->has_annotation("shared") ?
+                                         field_name + ".mutate()" : field_name;
+
+    // Encoded size of one element, used to cut slices
+    std::string element_size_expr;
+    if (element_is_message)
+    {
+        element_size_expr = "elements[i].totalSize().wordCount * sizeof(::capnp::word)";
+    }
+    else if (element_capnp_type == "Text" || element_capnp_type == "Data")
+    {
+        element_size_expr = "elements[i].size() + 2 * sizeof(::capnp::word)";
+    }
+    else if (element_type.is_custom())
+    {
+        element_size_expr = "sizeof(std::uint16_t)";
+    }
+    else
+    {
+        element_size_expr = "sizeof(" + element_type.get_cpp_type() + ")";
+    }
+
+    const std::string splitter_name = message.name + "Splitter";
+    const std::string reassembler_name = message.name + "Reassembler";
+
+    // Header guard
+    std::string guard_name;
+    for (char c : message.name + "Chunks")
+    {
+        guard_name += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    guard_name += "_HPP";
+
+    content << "#pragma once\n\n";
+    content << "#ifndef " << guard_name << "\n";
+    content << "#define " << guard_name << "\n\n";
+
+    // Includes
+    content << "#include <algorithm>\n";
+    content << "#include <cstddef>\n";
+    content << "#include <cstdint>\n";
+    content << "#include <functional>\n";
+    content << "#include <iterator>\n";
+    content << "#include <utility>\n";
+    content << "#include <vector>\n\n";
+    content << "#include <capnp/message.h>\n";
+    content << "#include <capnp/serialize.h>\n";
+    content << "#include <kj/array.h>\n\n";
+    content << "#include <" << _includePrefix << "MessageBase.hpp>\n";
+    content << "#include <" << _includePrefix << message.name << ".hpp>\n\n";
+
+    // Open namespace
+    content << "namespace " << ns << "\n";
+    content << "{\n\n";
+
+    // ---- Splitter ----
+    content << "/// @brief Splits " << message.name << " into frames whose " << field_name << " slices stay under a size budget.\n";
+    content << "/// @details The message is encoded once and " << field_name << " is cut between elements by their\n";
+    content << "///          encoded size. The first frame carries every other field and union, and every frame carries\n";
+    content << "///          chunkIndex and chunkCount. An element larger than the budget gets a frame of its own.\n";
+    content << "class " << splitter_name << "\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    /// @brief Target encoded size of one " << field_name << " slice (from @chunked).\n";
+    content << "    static constexpr std::size_t _k_max_bytes = " << message.chunk_max_bytes << ";\n\n";
+
+    content << "    /// @brief Encode a message as a sequence of frames.\n";
+    content << "    /// @param message The message to split.\n";
+    content << "    /// @param max_bytes Target encoded size of one slice.\n";
+    content << "    /// @return The frames in send order (at least one).\n";
+    content << "    static std::vector<SerializedData> split(const " << message.name
+            << "& message, std::size_t max_bytes = _k_max_bytes)\n";
+    content << "    {\n";
+    content << "        ::capnp::MallocMessageBuilder source_message;\n";
+    content << "        auto source_builder = source_message.initRoot<" << message.name << "::CapnpType>();\n";
+    content << "        message.to_capnp_struct(source_builder);\n";
+    content << "        auto source = source_builder.asReader();\n";
+    content << "        auto elements = source.get" << method_name << "();\n\n";
+
+    content << "        // Cut the list between elements by encoded size\n";
+    content << "        std::vector<unsigned> boundaries{0};\n";
+    content << "        std::size_t slice_bytes = 0;\n";
+    content << "        for (unsigned i = 0; i < elements.size(); ++i)\n";
+    content << "        {\n";
+    content << "            const std::size_t element_bytes = " << element_size_expr << ";\n";
+    content << "            if (i > boundaries.back() && slice_bytes + element_bytes > max_bytes)\n";
+    content << "            {\n";
+    content << "                boundaries.push_back(i);\n";
+    content << "                slice_bytes = 0;\n";
+    content << "            }\n";
+    content << "            slice_bytes += element_bytes;\n";
+    content << "        }\n";
+    content << "        boundaries.push_back(elements.size());\n\n";
+
+    content << "        const auto chunk_count = static_cast<std::uint32_t>(boundaries.size() - 1);\n";
+    content << "        std::vector<SerializedData> frames;\n";
+    content << "        frames.reserve(chunk_count);\n";
+    content << "        for (std::uint32_t chunk_index = 0; chunk_index < chunk_count; ++chunk_index)\n";
+    content << "        {\n";
+    content << "            const unsigned begin = boundaries[chunk_index];\n";
+    content << "            const unsigned end = boundaries[chunk_index + 1];\n\n";
+
+    content << "            ::capnp::MallocMessageBuilder chunk_message;\n";
+    content << "            auto chunk = chunk_message.initRoot<" << message.name << "::CapnpType>();\n";
+    content << "            chunk.setMsgType(source.getMsgType());\n";
+    content << "            chunk.setChunkIndex(chunk_index);\n";
+    content << "            chunk.setChunkCount(chunk_count);\n";
+    content << "            if (chunk_index == 0)\n";
+    content << "            {\n";
+    content << "                // The first frame carries every other field and union\n";
+    for (const auto& field : all_fields)
+    {
+        const std::string& name = field.get_field_name();
+        if (name == "msgType" || name == "chunkIndex" || name == "chunkCount" || name == field_name)
+        {
+            continue;
+        }
+        _generate_field_copy(content, field);
+    }
+    for (const auto& union_decl : _get_all_unions(message))
+    {
+        _generate_union_copy(content, union_decl);
+    }
+    content << "            }\n\n";
+
+    content << "            auto slice = chunk.init" << method_name << "(end - begin);\n";
+    content << "            for (unsigned i = begin; i < end; ++i)\n";
+    content << "            {\n";
+    if (element_is_message)
+    {
+        content << "                slice.setWithCaveats(i - begin, elements[i]);\n";
+    }
+    else
+    {
+        content << "                slice.set(i - begin, elements[i]);\n";
+    }
+    content << "            }\n";
+    content << "            frames.emplace_back(::capnp::messageToFlatArray(chunk_message));\n";
+    content << "        }\n";
+    content << "        return frames;\n";
+    content << "    }\n";
+    content << "};\n\n";
+
+    // ---- Reassembler ----
+    content << "/// @brief Rebuilds " << message.name << " from the frames produced by " << splitter_name << ".\n";
+    content << "/// @details Frames must arrive in order. By default the " << field_name << " elements are collected\n";
+    content << "///          into message(). With an element callback, each slice is handed over as its frame\n";
+    content << "///          is decoded and message() keeps only the other fields, so memory stays bounded by\n";
+    content << "///          one frame. A message sent whole (chunkCount 0) completes in one frame.\n";
+    content << "class " << reassembler_name << "\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    /// @brief Element type of " << field_name << ".\n";
+    content << "    using Element = " << element_type.get_cpp_type() << ";\n\n";
+
+    content << "    /// @brief Collect all elements into message().\n";
+    content << "    " << reassembler_name << "() = default;\n\n";
+
+    content << "    /// @brief Stream elements to a callback instead of collecting them.\n";
+    content << "    /// @param on_element Called with each element, in order.\n";
+    content << "    explicit " << reassembler_name << "(std::function<void(Element&&)> on_element)\n";
+    content << "        : _onElement(std::move(on_element))\n";
+    content << "    {\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Feed the next frame; after complete(), a frame starts the next message.\n";
+    content << "    /// @param data Pointer to word-aligned serialized data.\n";
+    content << "    /// @param size Size of the data buffer in bytes.\n";
+    content << "    /// @return False if the frame is malformed or out of sequence (the reassembler is reset).\n";
+    content << "    bool add(const std::uint8_t* data, std::size_t size)\n";
+    content << "    {\n";
+    content << "        if (complete())\n";
+    content << "        {\n";
+    content << "            reset();\n";
+    content << "        }\n\n";
+
+    content << "        try\n";
+    content << "        {\n";
+    content << "            kj::ArrayPtr<const ::capnp::word> words(reinterpret_cast<const ::capnp::word*>(data),\n";
+    content << "                                                   size / sizeof(::capnp::word));\n";
+    content << "            ::capnp::FlatArrayMessageReader reader(words);\n";
+    content << "            auto chunk = reader.getRoot<" << message.name << "::CapnpType>();\n\n";
+
+    content << "            const std::uint32_t chunk_count = std::max<std::uint32_t>(chunk.getChunkCount(), 1);\n";
+    content << "            if (chunk.getChunkIndex() != _received || (_received != 0 && chunk_count != _expected))\n";
+    content << "            {\n";
+    content << "                reset();\n";
+    content << "                return false;\n";
+    content << "            }\n\n";
+
+    content << "            if (_received == 0)\n";
+    content << "            {\n";
+    content << "                // The first frame carries every other field and union\n";
+    content << "                _message.from_capnp_struct(chunk);\n";
+    content << "                _expected = chunk_count;\n";
+    content << "                if (_onElement)\n";
+    content << "                {\n";
+    content << "                    _drain(_message." << container_expr << ");\n";
+    content << "                }\n";
+    content << "            }\n";
+    content << "            else\n";
+    content << "            {\n";
+    content << "                // Continuation frames carry only the slice\n";
+    content << "                " << message.name << " slice;\n";
+    content << "                slice.from_capnp_struct(chunk);\n";
+    content << "                auto& elements = slice." << container_expr << ";\n";
+    content << "                if (_onElement)\n";
+    content << "                {\n";
+    content << "                    _drain(elements);\n";
+    content << "                }\n";
+    content << "                else\n";
+    content << "                {\n";
+    content << "                    auto& collected = _message." << container_expr << ";\n";
+    content << "                    collected.insert(collected.end(), std::make_move_iterator(elements.begin()),\n";
+    content << "                                     std::make_move_iterator(elements.end()));\n";
+    content << "                }\n";
+    content << "            }\n\n";
+
+    content << "            if (++_received == _expected)\n";
+    content << "            {\n";
+    content << "                // The rebuilt message is whole again\n";
+    content << "                _message.chunkIndex = 0;\n";
+    content << "                _message.chunkCount = 0;\n";
+    content << "            }\n";
+    content << "            return true;\n";
+    content << "        }\n";
+    content << "        catch (...)\n";
+    content << "        {\n";
+    content << "            reset();\n";
+    content << "            return false;\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Feed the next frame.\n";
+    content << "    bool add(const SerializedData& frame) { return add(frame.bytes(), frame.size()); }\n\n";
+
+    content << "    /// @brief Feed the next frame.\n";
+    content << "    bool add(const std::vector<std::uint8_t>& frame) { return add(frame.data(), frame.size()); }\n\n";
+
+    content << "    /// @brief Check if every frame of the current message has arrived.\n";
+    content << "    bool complete() const { return _expected != 0 && _received == _expected; }\n\n";
+
+    content << "    /// @brief Get the number of frames received so far.\n";
+    content << "    std::uint32_t received() const { return _received; }\n\n";
+
+    content << "    /// @brief Get the total number of frames (0 until the first frame arrives).\n";
+    content << "    std::uint32_t expected() const { return _expected; }\n\n";
+
+    content << "    /// @brief Get the reassembled message (whole once complete() is true).\n";
+    content << "    " << message.name << "& message() { return _message; }\n\n";
+
+    content << "    /// @brief Discard the current message and wait for a first frame.\n";
+    content << "    void reset()\n";
+    content << "    {\n";
+    content << "        _message = " << message.name << "();\n";
+    content << "        _received = 0;\n";
+    content << "        _expected = 0;\n";
+    content << "    }\n\n";
+
+    content << "private:\n";
+    content << "    template<typename Elements>\n";
+    content << "    void _drain(Elements& elements)\n";
+    content << "    {\n";
+    content << "        for (auto&& element : elements)\n";
+    content << "        {\n";
+    content << "            _onElement(std::move(element));\n";
+    content << "        }\n";
+    content << "        elements.clear();\n";
+    content << "    }\n\n";
+
+    // Align member names
+    const std::string callback_type = "std::function<void(Element&&)>";
+    const std::size_t type_width = std::max(message.name.size(), callback_type.size()) + 1;
+    auto padded = [type_width](const std::string& type_name)
+    {
+        return type_name + std::string(type_width - type_name.size(), ' ');
+    };
+    content << "    " << padded(message.name) << "_message;\n";
+    content << "    " << padded(callback_type) << "_onElement;\n";
+    content << "    " << padded("std::uint32_t") << "_received = 0;\n";
+    content << "    " << padded("std::uint32_t") << "_expected = 0;\n";
+    content << "};\n\n";
+
+    // Close namespace
+    content << "} // namespace " << ns << "\n\n";
+
+    // Close header guard
+    content << "#endif // " << guard_name << "\n";
+
+    return content.str();
+}
+
+} // namespace curious::dsl::capnpgen
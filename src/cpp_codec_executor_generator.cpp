@@ -0,0 +1,401 @@
+#include "cpp_codec_executor_generator.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "string_utils.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+// ---- Constructor ----
+
+CppCodecExecutorGenerator::CppCodecExecutorGenerator(const Schema& schema, const std::string& output_directory, const std::string& include_prefix)
+    : _schema(schema)
+    , _outputDirectory(_resolve_output_directory(output_directory))
+    , _includePrefix(include_prefix)
+{
+    namespace fs = std::filesystem;
+
+    // Construct output file path
+    fs::path output_file_path = fs::path(_outputDirectory) / "CodecExecutor.hpp";
+
+    // Generate content
+    std::string content = _generate_codec_executor_content();
+
+    // Write to file
+    std::ofstream output_file(output_file_path, std::ios::binary);
+    if (!output_file)
+    {
+        throw std::runtime_error("Failed to create CodecExecutor header file: " + output_file_path.string());
+    }
+
+    output_file << content;
+}
+
+// ---- Private static methods ----
+
+std::string CppCodecExecutorGenerator::_resolve_output_directory(const std::string& path)
+{
+    namespace fs = std::filesystem;
+    fs::create_directories(path);
+    return path;
+}
+
+// ---- Private instance methods ----
+
+std::string CppCodecExecutorGenerator::_generate_codec_executor_content()
+{
+    std::ostringstream content;
+
+    // Use wrapper_namespace_name if specified, otherwise fall back to namespace_name
+    const std::string& raw_ns = _schema.wrapper_namespace_name.empty() ?
+                                  _schema.namespace_name : _schema.wrapper_namespace_name;
+    const std::string ns = raw_ns.empty() ?
+                             "curious::net" :
+                             string_utils::to_cpp_namespace(raw_ns);
+
+    // Header guard
+    content << "#pragma once\n\n";
+    content << "#ifndef CODECEXECUTOR_HPP\n";
+    content << "#define CODECEXECUTOR_HPP\n\n";
+
+    // Includes
+    content << "#include <atomic>\n";
+    content << "#include <condition_variable>\n";
+    content << "#include <cstdint>\n";
+    content << "#include <cstring>\n";
+    content << "#include <exception>\n";
+    content << "#include <functional>\n";
+    content << "#include <memory>\n";
+    content << "#include <mutex>\n";
+    content << "#include <span>\n";
+    content << "#include <thread>\n";
+    content << "#include <vector>\n\n";
+    content << "#include <capnp/any.h>\n";
+    content << "#include <capnp/serialize.h>\n";
+    content << "#include <kj/array.h>\n\n";
+    content << "#include <" << _includePrefix << "MessageBase.hpp>\n";
+    content << "#include <" << _includePrefix << "enums.hpp>\n";
+    content << "#include <" << _includePrefix << "factory_builder.h>\n\n";
+
+    // Open namespace
+    content << "namespace " << ns << "\n";
+    content << "{\n\n";
+
+    content << "/// @brief Work-stealing worker pool for batch encode/decode of independent messages.\n";
+    content << "/// @details Each batch is split into one contiguous block per participant (the workers plus the\n";
+    content << "///          calling thread). A participant drains its own block, then steals remaining indices\n";
+    content << "///          from the other blocks, so uneven message sizes still keep every core busy. Results\n";
+    content << "///          are written by index, so output order always matches input order. Each participant\n";
+    content << "///          keeps its own builder scratch segment and realignment buffer across batches.\n";
+    content << "///          Also usable as the ParallelExecutor for from_capnp_parallel(); calls made from\n";
+    content << "///          inside a running task run inline instead of deadlocking on the pool.\n";
+    content << "class CodecExecutor final : public ParallelExecutor\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    /// @brief A received frame (flat array encoding); need not be word-aligned.\n";
+    content << "    using Frame = std::span<const std::uint8_t>;\n\n";
+
+    content << "    /// @brief Words in each participant's reusable first builder segment.\n";
+    content << "    static constexpr std::size_t _k_scratch_words = 8192;\n\n";
+
+    content << "    /// @brief Start the worker threads.\n";
+    content << "    /// @param worker_count Background threads; 0 uses hardware_concurrency() - 1.\n";
+    content << "    ///        The calling thread always takes part in its own batches.\n";
+    content << "    explicit CodecExecutor(std::size_t worker_count = 0)\n";
+    content << "    {\n";
+    content << "        if (worker_count == 0)\n";
+    content << "        {\n";
+    content << "            const unsigned hardware_threads = std::thread::hardware_concurrency();\n";
+    content << "            worker_count = hardware_threads > 1 ? hardware_threads - 1 : 1;\n";
+    content << "        }\n\n";
+
+    content << "        _slotsUptr = std::make_unique<Slot[]>(worker_count + 1);\n";
+    content << "        _states.resize(worker_count + 1);\n";
+    content << "        for (auto& state : _states)\n";
+    content << "        {\n";
+    content << "            // MallocMessageBuilder requires a zeroed first segment and re-zeroes it on destruction\n";
+    content << "            state.scratch = kj::heapArray<capnp::word>(_k_scratch_words);\n";
+    content << "            std::memset(state.scratch.begin(), 0, state.scratch.size() * sizeof(capnp::word));\n";
+    content << "        }\n\n";
+
+    content << "        _workers.reserve(worker_count);\n";
+    content << "        for (std::size_t i = 0; i < worker_count; ++i)\n";
+    content << "        {\n";
+    content << "            _workers.emplace_back([this, i] { _worker_loop(i); });\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Stop and join the worker threads.\n";
+    content << "    ~CodecExecutor() override\n";
+    content << "    {\n";
+    content << "        {\n";
+    content << "            std::lock_guard<std::mutex> lock(_stateMutex);\n";
+    content << "            _stopping = true;\n";
+    content << "        }\n";
+    content << "        _wake.notify_all();\n\n";
+
+    content << "        for (auto& worker : _workers)\n";
+    content << "        {\n";
+    content << "            worker.join();\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    // Non-copyable, non-movable (workers hold a pointer to this)\n";
+    content << "    CodecExecutor(const CodecExecutor&) = delete;\n";
+    content << "    CodecExecutor& operator=(const CodecExecutor&) = delete;\n\n";
+
+    content << "    /// @brief Decode many frames concurrently.\n";
+    content << "    /// @param frames The received frames.\n";
+    content << "    /// @return One message per frame, in input order; nullptr for frames that fail to decode.\n";
+    content << "    std::vector<std::shared_ptr<MessageBase>> decode_batch(std::span<const Frame> frames)\n";
+    content << "    {\n";
+    content << "        std::vector<std::shared_ptr<MessageBase>> messages(frames.size());\n";
+    content << "        _run(frames.size(), [&](std::size_t index, std::size_t participant)\n";
+    content << "        {\n";
+    content << "            messages[index] = _decode_frame(frames[index], _states[participant]);\n";
+    content << "        });\n";
+    content << "        return messages;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Encode many messages concurrently.\n";
+    content << "    /// @param messages The messages to encode (null entries produce empty results).\n";
+    content << "    /// @return One SerializedData per message, in input order.\n";
+    content << "    /// @throws Rethrows the first exception thrown while encoding.\n";
+    content << "    std::vector<SerializedData> encode_batch(std::span<const MessageBase* const> messages)\n";
+    content << "    {\n";
+    content << "        std::vector<SerializedData> results(messages.size());\n";
+    content << "        _run(messages.size(), [&](std::size_t index, std::size_t participant)\n";
+    content << "        {\n";
+    content << "            if (messages[index] != nullptr)\n";
+    content << "            {\n";
+    content << "                ::capnp::MallocMessageBuilder builder(_states[participant].scratch.asPtr());\n";
+    content << "                messages[index]->to_capnp(builder);\n";
+    content << "                results[index] = SerializedData(capnp::messageToFlatArray(builder));\n";
+    content << "            }\n";
+    content << "        });\n";
+    content << "        return results;\n";
+    content << "    }\n\n";
+
+    content << "    void parallel_for(std::size_t count, const std::function<void(std::size_t)>& body) override\n";
+    content << "    {\n";
+    content << "        _run(count, [&](std::size_t index, std::size_t) { body(index); });\n";
+    content << "    }\n\n";
+
+    content << "    std::size_t concurrency() const override { return _workers.size() + 1; }\n\n";
+
+    content << "private:\n";
+    content << "    /// @brief One participant's block of indices; padded to avoid false sharing.\n";
+    content << "    struct alignas(64) Slot\n";
+    content << "    {\n";
+    content << "        std::atomic<std::size_t> next{0};\n";
+    content << "        std::atomic<std::size_t> end{0};\n";
+    content << "    };\n\n";
+
+    content << "    /// @brief Per-participant buffers reused across batches.\n";
+    content << "    struct WorkerState\n";
+    content << "    {\n";
+    content << "        kj::Array<capnp::word> scratch;\n";
+    content << "        kj::Array<capnp::word> alignBuffer;\n";
+    content << "    };\n\n";
+
+    content << "    using Task = std::function<void(std::size_t index, std::size_t participant)>;\n\n";
+
+    content << "    static std::shared_ptr<MessageBase> _decode_frame(Frame frame, WorkerState& state)\n";
+    content << "    {\n";
+    content << "        try\n";
+    content << "        {\n";
+    content << "            const std::size_t word_count = frame.size() / sizeof(capnp::word);\n";
+    content << "            const capnp::word* words = reinterpret_cast<const capnp::word*>(frame.data());\n\n";
+
+    content << "            // Cap'n Proto reads words in place; realign unaligned frames into the reusable buffer\n";
+    content << "            if (reinterpret_cast<std::uintptr_t>(frame.data()) % alignof(capnp::word) != 0)\n";
+    content << "            {\n";
+    content << "                if (state.alignBuffer.size() < word_count)\n";
+    content << "                {\n";
+    content << "                    state.alignBuffer = kj::heapArray<capnp::word>(word_count);\n";
+    content << "                }\n";
+    content << "                std::memcpy(state.alignBuffer.begin(), frame.data(), word_count * sizeof(capnp::word));\n";
+    content << "                words = state.alignBuffer.begin();\n";
+    content << "            }\n\n";
+
+    content << "            ::capnp::FlatArrayMessageReader reader(kj::arrayPtr(words, word_count));\n\n";
+
+    content << "            // msgType is always field @0: the first little-endian UInt16 of the data section\n";
+    content << "            auto data_section = reader.getRoot<::capnp::AnyStruct>().getDataSection();\n";
+    content << "            if (data_section.size() < sizeof(std::uint16_t))\n";
+    content << "            {\n";
+    content << "                return nullptr;\n";
+    content << "            }\n";
+    content << "            std::uint16_t raw_type = static_cast<std::uint16_t>(data_section[0]) |\n";
+    content << "                                     static_cast<std::uint16_t>(data_section[1] << 8);\n\n";
+    content << "            if (!isValidMessageType(raw_type))\n";
+    content << "            {\n";
+    content << "                return nullptr;\n";
+    content << "            }\n";
+
+    content << "            std::shared_ptr<MessageBase> message = FactoryBuilder::createMessage(static_cast<MessageType>(raw_type));\n";
+    content << "            message->from_capnp(reader);\n";
+    content << "            return message;\n";
+    content << "        }\n";
+    content << "        catch (...)\n";
+    content << "        {\n";
+    content << "            return nullptr;\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    void _run(std::size_t count, const Task& task)\n";
+    content << "    {\n";
+    content << "        if (count == 0)\n";
+    content << "        {\n";
+    content << "            return;\n";
+    content << "        }\n\n";
+
+    content << "        // Nested call from one of our own tasks: the pool is busy with the outer batch\n";
+    content << "        if (_currentExecutorPtr == this)\n";
+    content << "        {\n";
+    content << "            for (std::size_t i = 0; i < count; ++i)\n";
+    content << "            {\n";
+    content << "                task(i, _currentParticipant);\n";
+    content << "            }\n";
+    content << "            return;\n";
+    content << "        }\n\n";
+
+    content << "        // One batch at a time; concurrent callers queue here\n";
+    content << "        std::lock_guard<std::mutex> job_lock(_jobMutex);\n";
+    content << "        const std::size_t participants = _workers.size() + 1;\n";
+    content << "        const std::size_t block = (count + participants - 1) / participants;\n\n";
+
+    content << "        {\n";
+    content << "            // Wait for stragglers from the previous batch before reusing the slots\n";
+    content << "            std::unique_lock<std::mutex> lock(_stateMutex);\n";
+    content << "            _done.wait(lock, [this] { return _activeWorkers == 0; });\n\n";
+
+    content << "            for (std::size_t p = 0; p < participants; ++p)\n";
+    content << "            {\n";
+    content << "                _slotsUptr[p].next.store(std::min(p * block, count), std::memory_order_relaxed);\n";
+    content << "                _slotsUptr[p].end.store(std::min((p + 1) * block, count), std::memory_order_relaxed);\n";
+    content << "            }\n";
+    content << "            _taskPtr = &task;\n";
+    content << "            _error = nullptr;\n";
+    content << "            _remaining.store(count, std::memory_order_relaxed);\n";
+    content << "            ++_generation;\n";
+    content << "        }\n";
+    content << "        _wake.notify_all();\n\n";
+
+    content << "        // The calling thread works as the last participant\n";
+    content << "        const CodecExecutor* previous_executor = _currentExecutorPtr;\n";
+    content << "        const std::size_t previous_participant = _currentParticipant;\n";
+    content << "        _currentExecutorPtr = this;\n";
+    content << "        _currentParticipant = participants - 1;\n";
+    content << "        _work(participants - 1);\n";
+    content << "        _currentExecutorPtr = previous_executor;\n";
+    content << "        _currentParticipant = previous_participant;\n\n";
+
+    content << "        std::unique_lock<std::mutex> lock(_stateMutex);\n";
+    content << "        _done.wait(lock, [this] { return _remaining.load(std::memory_order_acquire) == 0; });\n";
+    content << "        if (_error)\n";
+    content << "        {\n";
+    content << "            std::rethrow_exception(_error);\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    void _worker_loop(std::size_t participant)\n";
+    content << "    {\n";
+    content << "        _currentExecutorPtr = this;\n";
+    content << "        _currentParticipant = participant;\n\n";
+
+    content << "        std::uint64_t seen_generation = 0;\n";
+    content << "        for (;;)\n";
+    content << "        {\n";
+    content << "            {\n";
+    content << "                std::unique_lock<std::mutex> lock(_stateMutex);\n";
+    content << "                _wake.wait(lock, [&] { return _stopping || _generation != seen_generation; });\n";
+    content << "                if (_stopping)\n";
+    content << "                {\n";
+    content << "                    return;\n";
+    content << "                }\n";
+    content << "                seen_generation = _generation;\n";
+    content << "                ++_activeWorkers;\n";
+    content << "            }\n\n";
+
+    content << "            _work(participant);\n\n";
+
+    content << "            {\n";
+    content << "                std::lock_guard<std::mutex> lock(_stateMutex);\n";
+    content << "                --_activeWorkers;\n";
+    content << "            }\n";
+    content << "            _done.notify_all();\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    void _work(std::size_t participant)\n";
+    content << "    {\n";
+    content << "        const std::size_t participants = _workers.size() + 1;\n\n";
+
+    content << "        // Own block first, then steal from the others in turn\n";
+    content << "        for (std::size_t offset = 0; offset < participants; ++offset)\n";
+    content << "        {\n";
+    content << "            Slot& slot = _slotsUptr[(participant + offset) % participants];\n";
+    content << "            for (;;)\n";
+    content << "            {\n";
+    content << "                const std::size_t index = slot.next.fetch_add(1, std::memory_order_relaxed);\n";
+    content << "                if (index >= slot.end.load(std::memory_order_relaxed))\n";
+    content << "                {\n";
+    content << "                    break;\n";
+    content << "                }\n\n";
+
+    content << "                try\n";
+    content << "                {\n";
+    content << "                    (*_taskPtr)(index, participant);\n";
+    content << "                }\n";
+    content << "                catch (...)\n";
+    content << "                {\n";
+    content << "                    std::lock_guard<std::mutex> lock(_stateMutex);\n";
+    content << "                    if (!_error)\n";
+    content << "                    {\n";
+    content << "                        _error = std::current_exception();\n";
+    content << "                    }\n";
+    content << "                }\n\n";
+
+    content << "                if (_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)\n";
+    content << "                {\n";
+    content << "                    std::lock_guard<std::mutex> lock(_stateMutex);\n";
+    content << "                    _done.notify_all();\n";
+    content << "                }\n";
+    content << "            }\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    static inline thread_local const CodecExecutor* _currentExecutorPtr = nullptr;\n";
+    content << "    static inline thread_local std::size_t          _currentParticipant = 0;\n\n";
+
+    content << "    std::vector<std::thread>  _workers;\n";
+    content << "    std::unique_ptr<Slot[]>   _slotsUptr;\n";
+    content << "    std::vector<WorkerState>  _states;\n";
+    content << "    const Task*               _taskPtr = nullptr;\n";
+    content << "    std::atomic<std::size_t>  _remaining{0};\n";
+    content << "    std::exception_ptr        _error;\n\n";
+
+    content << "    std::mutex                _jobMutex;\n";
+    content << "    std::mutex                _stateMutex;\n";
+    content << "    std::condition_variable   _wake;\n";
+    content << "    std::condition_variable   _done;\n";
+    content << "    std::uint64_t             _generation = 0;\n";
+    content << "    std::size_t               _activeWorkers = 0;\n";
+    content << "    bool                      _stopping = false;\n";
+    content << "};\n";
+
+    // Close namespace
+    content << "} // namespace " << ns << "\n\n";
+
+    // Close header guard
+    content << "#endif // CODECEXECUTOR_HPP\n";
+
+    return content.str();
+}
+
+} // namespace curious::dsl::capnpgen
@@ -0,0 +1,748 @@
+#include "cpp_columns_generator.hpp"
+
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "string_utils.hpp"
+#include "type_converter.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+namespace
+{
+
+/// @brief How a field is stored in a columns type.
+enum class ColumnKind
+{
+    Fixed,      ///< Fixed-width number stored as std::vector<T>
+    Bool,       ///< bool stored as std::vector<std::uint8_t> (std::vector<bool> is bit-packed)
+    Enum,       ///< Schema enum stored as std::vector<Enum>
+    String,     ///< string stored as StringColumn
+    Bytes,      ///< bytes stored as StringColumn
+    Unsupported ///< Nested, list and map fields are not stored
+};
+
+} // anonymous namespace
+
+// ---- Constructor ----
+
+CppColumnsGenerator::CppColumnsGenerator(const Schema& schema, const std::string& output_directory,
+                                         const std::string& include_prefix, bool validate_utf8)
+    : _schema(schema)
+    , _outputDirectory(_resolve_output_directory(output_directory))
+    , _includePrefix(include_prefix)
+    , _validateUtf8(validate_utf8)
+{
+    // Use wrapper_namespace_name if specified, otherwise fall back to namespace_name
+    const std::string& raw_ns = _schema.wrapper_namespace_name.empty() ?
+                                  _schema.namespace_name : _schema.wrapper_namespace_name;
+    _namespace = raw_ns.empty() ? "curious::net" : string_utils::to_cpp_namespace(raw_ns);
+
+    _write_file("Columns.hpp", _generate_columns_runtime_content());
+
+    for (const auto& message_name : _get_list_element_messages())
+    {
+        const Message& message = _schema.messages.at(message_name);
+        _write_file(message_name + "Columns.hpp", _generate_message_columns_content(message));
+    }
+}
+
+// ---- Private static methods ----
+
+std::string CppColumnsGenerator::_resolve_output_directory(const std::string& path)
+{
+    namespace fs = std::filesystem;
+    fs::create_directories(path);
+    return path;
+}
+
+std::string CppColumnsGenerator::_to_capnp_method_name(const std::string& field_name)
+{
+    if (field_name.empty())
+    {
+        return field_name;
+    }
+
+    std::string result = field_name;
+    result[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(result[0])));
+    return result;
+}
+
+// ---- Private instance methods ----
+
+void CppColumnsGenerator::_write_file(const std::string& file_name, const std::string& content) const
+{
+    namespace fs = std::filesystem;
+
+    fs::path output_file_path = fs::path(_outputDirectory) / file_name;
+    std::ofstream output_file(output_file_path, std::ios::binary);
+    if (!output_file)
+    {
+        throw std::runtime_error("Failed to create columns header file: " + output_file_path.string());
+    }
+
+    output_file << content;
+}
+
+std::set<std::string> CppColumnsGenerator::_get_list_element_messages() const
+{
+    std::set<std::string> element_messages;
+    for (const auto& [message_name, message] : _schema.messages)
+    {
+        for (const auto& field : message.fields)
+        {
+            const Type* element_type = field.is_list() ? field.get_element_type() : nullptr;
+            if (element_type != nullptr && element_type->is_custom() &&
+                _schema.messages.count(element_type->get_custom_name()) > 0)
+            {
+                element_messages.insert(element_type->get_custom_name());
+            }
+        }
+    }
+    return element_messages;
+}
+
+std::vector<Type> CppColumnsGenerator::_get_all_fields(const Message& message) const
+{
+    std::vector<Type> all_fields;
+
+    // Recursively get parent fields first
+    if (!message.parent_name.empty())
+    {
+        auto parent_it = _schema.messages.find(message.parent_name);
+        if (parent_it != _schema.messages.end())
+        {
+            auto parent_fields = _get_all_fields(parent_it->second);
+            all_fields.insert(all_fields.end(), parent_fields.begin(), parent_fields.end());
+        }
+    }
+
+    // Add this message's own fields
+    all_fields.insert(all_fields.end(), message.fields.begin(), message.fields.end());
+
+    return all_fields;
+}
+
+std::string CppColumnsGenerator::_generate_columns_runtime_content()
+{
+    std::ostringstream content;
+
+    // Header guard
+    content << "#pragma once\n\n";
+    content << "#ifndef COLUMNS_HPP\n";
+    content << "#define COLUMNS_HPP\n\n";
+
+    // Includes
+    content << "#include <algorithm>\n";
+    content << "#include <cstdint>\n";
+    content << "#include <cstring>\n";
+    content << "#include <ios>\n";
+    content << "#include <istream>\n";
+    content << "#include <limits>\n";
+    content << "#include <ostream>\n";
+    content << "#include <stdexcept>\n";
+    content << "#include <string>\n";
+    content << "#include <string_view>\n";
+    content << "#include <type_traits>\n";
+    content << "#include <unordered_map>\n";
+    content << "#include <vector>\n\n";
+
+    // Open namespace
+    content << "namespace " << _namespace << "\n";
+    content << "{\n\n";
+
+    content << "/// @brief Variable-length values stored as one contiguous byte buffer plus row offsets.\n";
+    content << "/// @details Row i spans bytes[offsets[i], offsets[i + 1]); offsets always starts with 0.\n";
+    content << "struct StringColumn\n";
+    content << "{\n";
+    content << "    std::vector<std::uint64_t> offsets{0};\n";
+    content << "    std::vector<char>          bytes;\n\n";
+
+    content << "    /// @brief Get the number of rows.\n";
+    content << "    std::size_t size() const { return offsets.size() - 1; }\n\n";
+
+    content << "    /// @brief Get the value of a row (valid until the column is modified).\n";
+    content << "    std::string_view operator[](std::size_t row) const\n";
+    content << "    {\n";
+    content << "        return std::string_view(bytes.data() + offsets[row], offsets[row + 1] - offsets[row]);\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Append a row.\n";
+    content << "    void push_back(std::string_view value)\n";
+    content << "    {\n";
+    content << "        bytes.insert(bytes.end(), value.begin(), value.end());\n";
+    content << "        offsets.push_back(bytes.size());\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Reserve capacity for rows.\n";
+    content << "    void reserve(std::size_t rows) { offsets.reserve(rows + 1); }\n\n";
+
+    content << "    /// @brief Remove all rows.\n";
+    content << "    void clear()\n";
+    content << "    {\n";
+    content << "        offsets.assign(1, 0);\n";
+    content << "        bytes.clear();\n";
+    content << "    }\n";
+    content << "};\n\n";
+
+    content << "/// @brief Writes named fixed-width arrays to a simple binary columnar file.\n";
+    content << "/// @details Layout (host byte order, checked on read): magic \"CPNCOLS1\", uint32 byte-order mark,\n";
+    content << "///          uint32 array count, uint64 row count, then per array: uint32 name length, name,\n";
+    content << "///          uint32 element size, uint64 element count, raw elements.\n";
+    content << "///          A StringColumn is stored as two arrays: \"<name>.offsets\" and \"<name>.bytes\".\n";
+    content << "///          Added columns are referenced, not copied, until write() returns.\n";
+    content << "class ColumnFileWriter\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    /// @brief File magic.\n";
+    content << "    static constexpr char _k_magic[8] = {'C', 'P', 'N', 'C', 'O', 'L', 'S', '1'};\n\n";
+
+    content << "    /// @brief Written in host order; a reader on a host with other endianness sees it swapped.\n";
+    content << "    static constexpr std::uint32_t _k_byte_order_mark = 0x01020304;\n\n";
+
+    content << "    /// @brief Start a file with the given number of rows.\n";
+    content << "    explicit ColumnFileWriter(std::uint64_t row_count) : _rowCount(row_count) {}\n\n";
+
+    content << "    /// @brief Add a fixed-width column.\n";
+    content << "    template<typename T>\n";
+    content << "    void add(std::string name, const std::vector<T>& column)\n";
+    content << "    {\n";
+    content << "        static_assert(std::is_trivially_copyable_v<T>, \"Columns must be trivially copyable\");\n";
+    content << "        _arrays.push_back({std::move(name), sizeof(T), column.size(), column.data()});\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Add a string column (as offsets and bytes arrays).\n";
+    content << "    void add(const std::string& name, const StringColumn& column)\n";
+    content << "    {\n";
+    content << "        add(name + \".offsets\", column.offsets);\n";
+    content << "        add(name + \".bytes\", column.bytes);\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Write the file.\n";
+    content << "    /// @throws std::runtime_error if the stream fails.\n";
+    content << "    void write(std::ostream& out) const\n";
+    content << "    {\n";
+    content << "        out.write(_k_magic, sizeof(_k_magic));\n";
+    content << "        _write_value(out, _k_byte_order_mark);\n";
+    content << "        _write_value(out, static_cast<std::uint32_t>(_arrays.size()));\n";
+    content << "        _write_value(out, _rowCount);\n\n";
+
+    content << "        for (const auto& array : _arrays)\n";
+    content << "        {\n";
+    content << "            _write_value(out, static_cast<std::uint32_t>(array.name.size()));\n";
+    content << "            out.write(array.name.data(), static_cast<std::streamsize>(array.name.size()));\n";
+    content << "            _write_value(out, array.elementSize);\n";
+    content << "            _write_value(out, array.count);\n";
+    content << "            out.write(static_cast<const char*>(array.dataPtr),\n";
+    content << "                      static_cast<std::streamsize>(array.elementSize * array.count));\n";
+    content << "        }\n\n";
+
+    content << "        if (!out)\n";
+    content << "        {\n";
+    content << "            throw std::runtime_error(\"Failed to write column file\");\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "private:\n";
+    content << "    struct Array\n";
+    content << "    {\n";
+    content << "        std::string   name;\n";
+    content << "        std::uint32_t elementSize;\n";
+    content << "        std::uint64_t count;\n";
+    content << "        const void*   dataPtr;\n";
+    content << "    };\n\n";
+
+    content << "    template<typename T>\n";
+    content << "    static void _write_value(std::ostream& out, T value)\n";
+    content << "    {\n";
+    content << "        out.write(reinterpret_cast<const char*>(&value), sizeof(T));\n";
+    content << "    }\n\n";
+
+    content << "    std::uint64_t      _rowCount;\n";
+    content << "    std::vector<Array> _arrays;\n";
+    content << "};\n\n";
+
+    content << "/// @brief Reads a file written by ColumnFileWriter.\n";
+    content << "class ColumnFileReader\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    /// @brief Load every array in the file.\n";
+    content << "    /// @throws std::runtime_error if the stream is not a column file from a same-endian host,\n";
+    content << "    ///         or an array's name or size is out of bounds for the stream.\n";
+    content << "    explicit ColumnFileReader(std::istream& in)\n";
+    content << "    {\n";
+    content << "        char magic[sizeof(ColumnFileWriter::_k_magic)] = {};\n";
+    content << "        in.read(magic, sizeof(magic));\n";
+    content << "        if (!in || std::memcmp(magic, ColumnFileWriter::_k_magic, sizeof(magic)) != 0)\n";
+    content << "        {\n";
+    content << "            throw std::runtime_error(\"Not a column file\");\n";
+    content << "        }\n";
+    content << "        if (_read_value<std::uint32_t>(in) != ColumnFileWriter::_k_byte_order_mark)\n";
+    content << "        {\n";
+    content << "            throw std::runtime_error(\"Column file byte order does not match this host\");\n";
+    content << "        }\n\n";
+
+    content << "        const auto array_count = _read_value<std::uint32_t>(in);\n";
+    content << "        _rowCount = _read_value<std::uint64_t>(in);\n\n";
+
+    content << "        for (std::uint32_t i = 0; i < array_count && in; ++i)\n";
+    content << "        {\n";
+    content << "            // Sizes come from the file, so bound them before allocating\n";
+    content << "            const auto name_length = _read_value<std::uint32_t>(in);\n";
+    content << "            if (name_length > _k_max_name_length)\n";
+    content << "            {\n";
+    content << "                throw std::runtime_error(\"Invalid array name length in column file\");\n";
+    content << "            }\n";
+    content << "            std::string name(name_length, '\\0');\n";
+    content << "            in.read(name.data(), static_cast<std::streamsize>(name.size()));\n\n";
+
+    content << "            Array array;\n";
+    content << "            array.elementSize = _read_value<std::uint32_t>(in);\n";
+    content << "            array.count = _read_value<std::uint64_t>(in);\n";
+    content << "            if (array.elementSize != 0 &&\n";
+    content << "                array.count > std::numeric_limits<std::size_t>::max() / array.elementSize)\n";
+    content << "            {\n";
+    content << "                throw std::runtime_error(\"Array size overflows in column file: \" + name);\n";
+    content << "            }\n";
+    content << "            const std::uint64_t size = std::uint64_t{array.elementSize} * array.count;\n";
+    content << "            if (size > _remaining(in))\n";
+    content << "            {\n";
+    content << "                throw std::runtime_error(\"Truncated column file\");\n";
+    content << "            }\n";
+    content << "            _read_bytes(in, array.bytes, size);\n\n";
+
+    content << "            _arrays.emplace(std::move(name), std::move(array));\n";
+    content << "        }\n\n";
+
+    content << "        if (!in)\n";
+    content << "        {\n";
+    content << "            throw std::runtime_error(\"Truncated column file\");\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Get the number of rows.\n";
+    content << "    std::uint64_t row_count() const { return _rowCount; }\n\n";
+
+    content << "    /// @brief Read a fixed-width column; a column missing from the file is filled with defaults.\n";
+    content << "    /// @throws std::runtime_error if the element size or length does not match.\n";
+    content << "    template<typename T>\n";
+    content << "    void read(const std::string& name, std::vector<T>& column) const\n";
+    content << "    {\n";
+    content << "        auto it = _arrays.find(name);\n";
+    content << "        if (it == _arrays.end())\n";
+    content << "        {\n";
+    content << "            column.assign(_rowCount, T{});\n";
+    content << "            return;\n";
+    content << "        }\n";
+    content << "        _copy_array(name, it->second, _rowCount, column);\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Read a string column; a column missing from the file is filled with empty values.\n";
+    content << "    /// @throws std::runtime_error if the offsets are inconsistent.\n";
+    content << "    void read(const std::string& name, StringColumn& column) const\n";
+    content << "    {\n";
+    content << "        auto offsets_it = _arrays.find(name + \".offsets\");\n";
+    content << "        auto bytes_it = _arrays.find(name + \".bytes\");\n";
+    content << "        if (offsets_it == _arrays.end() || bytes_it == _arrays.end())\n";
+    content << "        {\n";
+    content << "            column.offsets.assign(_rowCount + 1, 0);\n";
+    content << "            column.bytes.clear();\n";
+    content << "            return;\n";
+    content << "        }\n\n";
+
+    content << "        _copy_array(name, offsets_it->second, _rowCount + 1, column.offsets);\n";
+    content << "        _copy_array(name, bytes_it->second, bytes_it->second.count, column.bytes);\n\n";
+
+    content << "        // Offsets must be non-decreasing and cover the byte buffer exactly\n";
+    content << "        bool valid = column.offsets.front() == 0 && column.offsets.back() == column.bytes.size();\n";
+    content << "        for (std::size_t i = 1; valid && i < column.offsets.size(); ++i)\n";
+    content << "        {\n";
+    content << "            valid = column.offsets[i - 1] <= column.offsets[i];\n";
+    content << "        }\n";
+    content << "        if (!valid)\n";
+    content << "        {\n";
+    content << "            throw std::runtime_error(\"Invalid offsets in column file column: \" + name);\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "private:\n";
+    content << "    /// @brief Longest array name accepted from a file.\n";
+    content << "    static constexpr std::uint32_t _k_max_name_length = 4096;\n\n";
+
+    content << "    /// @brief Largest block read at once from a stream that cannot report its size.\n";
+    content << "    static constexpr std::uint64_t _k_read_step = std::uint64_t{1} << 20;\n\n";
+
+    content << "    struct Array\n";
+    content << "    {\n";
+    content << "        std::uint32_t             elementSize = 0;\n";
+    content << "        std::uint64_t             count = 0;\n";
+    content << "        std::vector<std::uint8_t> bytes;\n";
+    content << "    };\n\n";
+
+    content << "    template<typename T>\n";
+    content << "    static T _read_value(std::istream& in)\n";
+    content << "    {\n";
+    content << "        T value{};\n";
+    content << "        in.read(reinterpret_cast<char*>(&value), sizeof(T));\n";
+    content << "        return value;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Get the bytes left in the stream, or the maximum if it cannot seek.\n";
+    content << "    static std::uint64_t _remaining(std::istream& in)\n";
+    content << "    {\n";
+    content << "        auto* buffer = in.rdbuf();\n";
+    content << "        const std::streampos position = buffer->pubseekoff(0, std::ios::cur, std::ios::in);\n";
+    content << "        if (position == std::streampos(-1))\n";
+    content << "        {\n";
+    content << "            return std::numeric_limits<std::uint64_t>::max();\n";
+    content << "        }\n";
+    content << "        const std::streampos end = buffer->pubseekoff(0, std::ios::end, std::ios::in);\n";
+    content << "        buffer->pubseekpos(position, std::ios::in);\n";
+    content << "        if (end == std::streampos(-1) || end < position)\n";
+    content << "        {\n";
+    content << "            return std::numeric_limits<std::uint64_t>::max();\n";
+    content << "        }\n";
+    content << "        return static_cast<std::uint64_t>(end - position);\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Read an array's bytes in bounded blocks, so a stream that cannot seek fails at its end\n";
+    content << "    ///        instead of allocating whatever size the file claims.\n";
+    content << "    static void _read_bytes(std::istream& in, std::vector<std::uint8_t>& bytes, std::uint64_t size)\n";
+    content << "    {\n";
+    content << "        while (bytes.size() < size && in)\n";
+    content << "        {\n";
+    content << "            const std::size_t offset = bytes.size();\n";
+    content << "            const auto block = static_cast<std::size_t>(std::min(_k_read_step, size - offset));\n";
+    content << "            bytes.resize(offset + block);\n";
+    content << "            in.read(reinterpret_cast<char*>(bytes.data() + offset), static_cast<std::streamsize>(block));\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    template<typename T>\n";
+    content << "    static void _copy_array(const std::string& name, const Array& array, std::uint64_t expected_count,\n";
+    content << "                            std::vector<T>& column)\n";
+    content << "    {\n";
+    content << "        if (array.elementSize != sizeof(T) || array.count != expected_count)\n";
+    content << "        {\n";
+    content << "            throw std::runtime_error(\"Column shape mismatch in column file: \" + name);\n";
+    content << "        }\n";
+    content << "        column.resize(array.count);\n";
+    content << "        if (!array.bytes.empty())\n";
+    content << "        {\n";
+    content << "            std::memcpy(column.data(), array.bytes.data(), array.bytes.size());\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    std::uint64_t                          _rowCount = 0;\n";
+    content << "    std::unordered_map<std::string, Array> _arrays;\n";
+    content << "};\n";
+
+    content << "\n";
+
+    // Close namespace
+    content << "} // namespace " << _namespace << "\n\n";
+
+    // Close header guard
+    content << "#endif // COLUMNS_HPP\n";
+
+    return content.str();
+}
+
+std::string CppColumnsGenerator::_generate_message_columns_content(const Message& message)
+{
+    std::ostringstream content;
+    const std::string class_name = message.name + "Columns";
+
+    // Header guard
+    std::string guard = class_name;
+    for (char& c : guard)
+    {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    guard += "_HPP";
+
+    // Classify fields; msgType is constant for list elements and not stored
+    std::vector<std::pair<Type, ColumnKind>> columns;
+    std::vector<std::string> skipped_fields;
+    for (const auto& field : _get_all_fields(message))
+    {
+        ColumnKind kind = ColumnKind::Unsupported;
+        if (field.is_custom() && field.get_custom_name() == "MessageType")
+        {
+            continue;
+        }
+        if (field.has_annotation("optional"))
+        {
+            // A column has no slot for "absent"; keep presence on the message side
+            kind = ColumnKind::Unsupported;
+        }
+        else if (TypeConverter::is_fixed_width_primitive(field))
+        {
+            kind = ColumnKind::Fixed;
+        }
+        else if (field.is_primitive() && field.get_cpp_type() == "bool")
+        {
+            kind = ColumnKind::Bool;
+        }
+        else if (field.is_primitive() && field.get_cpp_type() == "std::string")
+        {
+            kind = ColumnKind::String;
+        }
+        else if (field.is_primitive() && field.get_cpp_type() == "std::vector<uint8_t>")
+        {
+            kind = ColumnKind::Bytes;
+        }
+        else if (field.is_custom() && _schema.enums.count(field.get_custom_name()) > 0)
+        {
+            kind = ColumnKind::Enum;
+        }
+
+        if (kind == ColumnKind::Unsupported)
+        {
+            skipped_fields.push_back(field.get_field_name());
+            continue;
+        }
+        columns.emplace_back(field, kind);
+    }
+    for (auto it = _schema.messages.find(message.name); it != _schema.messages.end();
+         it = _schema.messages.find(it->second.parent_name))
+    {
+        for (const auto& union_decl : it->second.unions)
+        {
+            skipped_fields.push_back(union_decl.get_member_name());
+        }
+    }
+
+    content << "#pragma once\n\n";
+    content << "#ifndef " << guard << "\n";
+    content << "#define " << guard << "\n\n";
+
+    // Includes
+    content << "#include <cstdint>\n";
+    content << "#include <istream>\n";
+    content << "#include <ostream>\n";
+    content << "#include <string_view>\n";
+    content << "#include <vector>\n\n";
+    content << "#include <" << _includePrefix << "Columns.hpp>\n";
+    content << "#include <" << _includePrefix << message.name << ".hpp>\n\n";
+
+    // Open namespace
+    content << "namespace " << _namespace << "\n";
+    content << "{\n\n";
+
+    content << "/// @brief Columnar (struct-of-arrays) batch of " << message.name << " rows.\n";
+    content << "/// @details One contiguous column per primitive field and an offsets+bytes column per\n";
+    content << "///          string/bytes field, so scans over large lists run as tight loops.\n";
+    if (!skipped_fields.empty())
+    {
+        content << "/// @note Not stored (nested, list, map, optional and union fields):";
+        for (const auto& field_name : skipped_fields)
+        {
+            content << " " << field_name;
+        }
+        content << ".\n";
+    }
+    content << "class " << class_name << "\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    // ---- Columns ----\n\n";
+
+    for (const auto& [field, kind] : columns)
+    {
+        std::string column_type;
+        switch (kind)
+        {
+            case ColumnKind::Fixed:
+                column_type = "std::vector<" + field.get_cpp_type() + ">";
+                break;
+            case ColumnKind::Bool:
+                column_type = "std::vector<std::uint8_t>";
+                break;
+            case ColumnKind::Enum:
+                column_type = "std::vector<" + field.get_custom_name() + ">";
+                break;
+            default:
+                column_type = "StringColumn";
+                break;
+        }
+        content << "    " << column_type << " " << field.get_field_name() << ";\n";
+    }
+    if (!columns.empty())
+    {
+        content << "\n";
+    }
+
+    content << "    // ---- Rows ----\n\n";
+
+    content << "    /// @brief Get the number of rows.\n";
+    content << "    std::size_t row_count() const { return _rowCount; }\n\n";
+
+    content << "    /// @brief Remove all rows.\n";
+    content << "    void clear()\n";
+    content << "    {\n";
+    for (const auto& [field, kind] : columns)
+    {
+        content << "        " << field.get_field_name() << ".clear();\n";
+    }
+    content << "        _rowCount = 0;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Reserve capacity for rows.\n";
+    content << "    void reserve(std::size_t rows)\n";
+    content << "    {\n";
+    if (columns.empty())
+    {
+        content << "        (void) rows;\n";
+    }
+    for (const auto& [field, kind] : columns)
+    {
+        content << "        " << field.get_field_name() << ".reserve(rows);\n";
+    }
+    content << "    }\n\n";
+
+    content << "    /// @brief Append one row from a message object.\n";
+    content << "    void push_back(const " << message.name << "& row)\n";
+    content << "    {\n";
+    for (const auto& [field, kind] : columns)
+    {
+        const std::string& name = field.get_field_name();
+        switch (kind)
+        {
+            case ColumnKind::Bool:
+                content << "        " << name << ".push_back(row." << name << " ? 1 : 0);\n";
+                break;
+            case ColumnKind::Bytes:
+                content << "        " << name << ".push_back(std::string_view(reinterpret_cast<const char*>(row."
+                        << name << ".data()), row." << name << ".size()));\n";
+                break;
+            default:
+                content << "        " << name << ".push_back(row." << name << ");\n";
+                break;
+        }
+    }
+    content << "        ++_rowCount;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Append one row straight from a Cap'n Proto struct reader.\n";
+    content << "    /// @tparam StructReader The " << message.name << " (or derived) struct reader type.\n";
+    if (_validateUtf8)
+    {
+        content << "    /// @throws std::runtime_error if a Text field is not valid UTF-8; no column is modified.\n";
+    }
+    content << "    template<typename StructReader>\n";
+    content << "    void push_back_capnp(const StructReader& reader)\n";
+    content << "    {\n";
+    if (columns.empty())
+    {
+        content << "        (void) reader;\n";
+    }
+    if (_validateUtf8)
+    {
+        // Check every Text field before appending, so a rejected row leaves the columns aligned
+        for (const auto& [field, kind] : columns)
+        {
+            if (kind != ColumnKind::String)
+            {
+                continue;
+            }
+            const std::string& name = field.get_field_name();
+            content << "        {\n";
+            content << "            auto value = reader.get" << _to_capnp_method_name(name) << "();\n";
+            content << "            MessageBase::requireUtf8(value.begin(), value.size(), \"" << name << "\");\n";
+            content << "        }\n";
+        }
+    }
+    for (const auto& [field, kind] : columns)
+    {
+        const std::string& name = field.get_field_name();
+        const std::string getter = "reader.get" + _to_capnp_method_name(name) + "()";
+        switch (kind)
+        {
+            case ColumnKind::Bool:
+                content << "        " << name << ".push_back(" << getter << " ? 1 : 0);\n";
+                break;
+            case ColumnKind::Enum:
+                content << "        " << name << ".push_back(static_cast<" << field.get_custom_name() << ">("
+                        << getter << "));\n";
+                break;
+            case ColumnKind::String:
+                content << "        {\n";
+                content << "            auto value = " << getter << ";\n";
+                content << "            " << name << ".push_back(std::string_view(value.begin(), value.size()));\n";
+                content << "        }\n";
+                break;
+            case ColumnKind::Bytes:
+                content << "        {\n";
+                content << "            auto value = " << getter << ";\n";
+                content << "            " << name << ".push_back(std::string_view(reinterpret_cast<const char*>(value.begin()), value.size()));\n";
+                content << "        }\n";
+                break;
+            default:
+                content << "        " << name << ".push_back(" << getter << ");\n";
+                break;
+        }
+    }
+    content << "        ++_rowCount;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Decode a Cap'n Proto list of " << message.name << " directly into columns.\n";
+    content << "    /// @tparam ListReader The Cap'n Proto list reader type.\n";
+    content << "    /// @param list_reader The list to decode (replaces existing rows).\n";
+    content << "    template<typename ListReader>\n";
+    content << "    void from_capnp_list(const ListReader& list_reader)\n";
+    content << "    {\n";
+    content << "        clear();\n";
+    content << "        reserve(list_reader.size());\n";
+    content << "        for (auto item : list_reader)\n";
+    content << "        {\n";
+    content << "            push_back_capnp(item);\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    // ---- Columnar File I/O ----\n\n";
+
+    content << "    /// @brief Write all columns to a columnar file.\n";
+    content << "    /// @throws std::runtime_error if the stream fails.\n";
+    content << "    void write(std::ostream& out) const\n";
+    content << "    {\n";
+    content << "        ColumnFileWriter writer(_rowCount);\n";
+    for (const auto& [field, kind] : columns)
+    {
+        content << "        writer.add(\"" << field.get_field_name() << "\", " << field.get_field_name() << ");\n";
+    }
+    content << "        writer.write(out);\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Read columns from a columnar file.\n";
+    content << "    /// @details Columns missing from the file are filled with default values.\n";
+    content << "    /// @throws std::runtime_error if the file is malformed or a column shape does not match.\n";
+    content << "    static " << class_name << " read(std::istream& in)\n";
+    content << "    {\n";
+    content << "        ColumnFileReader reader(in);\n";
+    content << "        " << class_name << " columns;\n";
+    for (const auto& [field, kind] : columns)
+    {
+        content << "        reader.read(\"" << field.get_field_name() << "\", columns." << field.get_field_name() << ");\n";
+    }
+    content << "        columns._rowCount = reader.row_count();\n";
+    content << "        return columns;\n";
+    content << "    }\n\n";
+
+    content << "private:\n";
+    content << "    std::size_t _rowCount = 0;\n";
+    content << "};\n\n";
+
+    // Close namespace
+    content << "} // namespace " << _namespace << "\n\n";
+
+    // Close header guard
+    content << "#endif // " << guard << "\n";
+
+    return content.str();
+}
+
+} // namespace curious::dsl::capnpgen
@@ -4,11 +4,13 @@
 #include <cctype>
 #include <cstring>
 #include <filesystem>
+#include <set>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
 
 #include "string_utils.hpp"
+#include "struct_layout.hpp"
 
 namespace curious::dsl::capnpgen
 {
@@ -112,7 +114,8 @@ std::string CppEnumGenerator::_generate_enum_class(const EnumDecl& enum_decl)
         code << "/// @details Cap'n Proto ID: 0x" << std::hex << enum_decl.capnp_id << std::dec << "\n";
     }
 
-    code << "enum class " << enum_decl.name << " : std::int64_t\n";
+    // Smallest type holding every value, never narrower than the UInt16 Cap'n Proto puts on the wire
+    code << "enum class " << enum_decl.name << " : " << StructLayout::get_enum_underlying_type(enum_decl) << "\n";
     code << "{\n";
 
     for (const auto& value : enum_decl.values)
@@ -139,6 +142,31 @@ std::string CppEnumGenerator::_generate_enum_class(const EnumDecl& enum_decl)
     code << "    }\n";
     code << "}\n\n";
 
+    // Wire values are range-checked with this before any cast to the enum
+    code << "/// @brief Check whether a raw (wire) value names a " << enum_decl.name << " enumerant.\n";
+    code << "/// @param value The raw value.\n";
+    code << "/// @return True if the value is declared in the enum.\n";
+    code << "inline constexpr bool isValid" << enum_decl.name << "(std::int64_t value)\n";
+    code << "{\n";
+    code << "    switch (value)\n";
+    code << "    {\n";
+    std::set<std::int64_t> seen_values;
+    for (const auto& enum_value : enum_decl.values)
+    {
+        if (seen_values.insert(enum_value.value).second)
+        {
+            code << "        case " << enum_value.value << ":\n";
+        }
+    }
+    if (!seen_values.empty())
+    {
+        code << "            return true;\n";
+    }
+    code << "        default:\n";
+    code << "            return false;\n";
+    code << "    }\n";
+    code << "}\n\n";
+
     // Add FromString function
     code << "/// @brief Convert a string to " << enum_decl.name << " enum value.\n";
     code << "/// @param str The string to convert.\n";
@@ -91,7 +91,10 @@ std::string CppFactoryGenerator::_generate_factory_content()
     std::vector<std::string> message_names;
     for (const auto& [name, msg] : _schema.messages)
     {
-        message_names.push_back(name);
+        if (!msg.is_value_type())
+        {
+            message_names.push_back(name);
+        }
     }
     std::sort(message_names.begin(), message_names.end());
 
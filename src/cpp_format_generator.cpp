@@ -0,0 +1,347 @@
+#include "cpp_format_generator.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "string_utils.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+// ---- Constructor ----
+
+CppFormatGenerator::CppFormatGenerator(const Schema& schema, const std::string& output_directory, const std::string& include_prefix)
+    : _schema(schema)
+    , _outputDirectory(_resolve_output_directory(output_directory))
+    , _includePrefix(include_prefix)
+{
+    namespace fs = std::filesystem;
+
+    fs::path output_file_path = fs::path(_outputDirectory) / "Format.hpp";
+
+    std::ofstream output_file(output_file_path, std::ios::binary);
+    if (!output_file)
+    {
+        throw std::runtime_error("Failed to create format header file: " + output_file_path.string());
+    }
+
+    output_file << _generate_format_content();
+}
+
+// ---- Private static methods ----
+
+std::string CppFormatGenerator::_resolve_output_directory(const std::string& path)
+{
+    namespace fs = std::filesystem;
+    fs::create_directories(path);
+    return path;
+}
+
+std::string CppFormatGenerator::_generate_formatters()
+{
+    std::ostringstream content;
+
+    content << "/// @brief Truncation limits for formatted messages.\n";
+    content << "struct FormatLimits\n";
+    content << "{\n";
+    content << "    /// @brief Longest string printed in full; longer ones are cut and show their length.\n";
+    content << "    std::size_t max_string = 64;\n\n";
+
+    content << "    /// @brief Most list or map entries printed; the rest are summarized as a count.\n";
+    content << "    std::size_t max_items = 8;\n";
+    content << "};\n\n";
+
+    content << "/// @brief Output iterator that writes into a fixed buffer and drops what does not fit.\n";
+    content << "class FixedBufferIterator\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    using iterator_category = std::output_iterator_tag;\n";
+    content << "    using value_type = void;\n";
+    content << "    using difference_type = std::ptrdiff_t;\n";
+    content << "    using pointer = void;\n";
+    content << "    using reference = void;\n\n";
+
+    content << "    FixedBufferIterator() = default;\n";
+    content << "    FixedBufferIterator(char* begin, char* end) : _pos(begin), _end(end) {}\n\n";
+
+    content << "    FixedBufferIterator& operator=(char c)\n";
+    content << "    {\n";
+    content << "        if (_pos != _end)\n";
+    content << "        {\n";
+    content << "            *_pos++ = c;\n";
+    content << "        }\n";
+    content << "        else\n";
+    content << "        {\n";
+    content << "            _truncated = true;\n";
+    content << "        }\n";
+    content << "        return *this;\n";
+    content << "    }\n\n";
+
+    content << "    FixedBufferIterator& operator*() { return *this; }\n";
+    content << "    FixedBufferIterator& operator++() { return *this; }\n";
+    content << "    FixedBufferIterator& operator++(int) { return *this; }\n\n";
+
+    content << "    /// @brief Get the position after the last character written.\n";
+    content << "    char* position() const { return _pos; }\n\n";
+
+    content << "    /// @brief Check if output was dropped because the buffer was full.\n";
+    content << "    bool truncated() const { return _truncated; }\n\n";
+
+    content << "private:\n";
+    content << "    char* _pos = nullptr;\n";
+    content << "    char* _end = nullptr;\n";
+    content << "    bool  _truncated = false;\n";
+    content << "};\n\n";
+
+    content << "template<typename T>\n";
+    content << "struct IsFormatVector : std::false_type {};\n\n";
+
+    content << "template<typename T>\n";
+    content << "struct IsFormatVector<std::vector<T>> : std::true_type {};\n\n";
+
+    content << "template<typename T>\n";
+    content << "struct IsFormatMap : std::false_type {};\n\n";
+
+    content << "template<typename K, typename V>\n";
+    content << "struct IsFormatMap<std::unordered_map<K, V>> : std::true_type {};\n\n";
+
+    content << "template<typename T>\n";
+    content << "struct IsFormatShared : std::false_type {};\n\n";
+
+    content << "template<typename T>\n";
+    content << "struct IsFormatShared<SharedField<T>> : std::true_type {};\n\n";
+
+    content << "template<typename T>\n";
+    content << "struct IsFormatOptional : std::false_type {};\n\n";
+
+    content << "template<typename T>\n";
+    content << "struct IsFormatOptional<std::optional<T>> : std::true_type {};\n\n";
+
+    content << "/// @brief Copy characters to an output iterator.\n";
+    content << "template<typename OutputIt>\n";
+    content << "OutputIt formatText(OutputIt out, std::string_view text)\n";
+    content << "{\n";
+    content << "    return std::copy(text.begin(), text.end(), out);\n";
+    content << "}\n\n";
+
+    content << "/// @brief Format one field value as compact text.\n";
+    content << "/// @details Strings are quoted and cut at limits.max_string, bytes print their size, and lists\n";
+    content << "///          and maps print at most limits.max_items entries. Nothing is allocated.\n";
+    content << "template<typename OutputIt, typename T>\n";
+    content << "OutputIt formatValue(OutputIt out, const T& value, const FormatLimits& limits)\n";
+    content << "{\n";
+    content << "    if constexpr (std::is_same_v<T, bool>)\n";
+    content << "    {\n";
+    content << "        return formatText(out, value ? \"true\" : \"false\");\n";
+    content << "    }\n";
+    content << "    else if constexpr (std::is_enum_v<T>)\n";
+    content << "    {\n";
+    content << "        const std::string_view name = JsonEnumTraits<T>::name(value);\n";
+    content << "        if (!name.empty())\n";
+    content << "        {\n";
+    content << "            return formatText(out, name);\n";
+    content << "        }\n";
+    content << "        return formatValue(out, static_cast<std::int64_t>(value), limits);\n";
+    content << "    }\n";
+    content << "    else if constexpr (std::is_arithmetic_v<T>)\n";
+    content << "    {\n";
+    content << "        char digits[32];\n";
+    content << "        const auto result = std::to_chars(digits, digits + sizeof(digits), value);\n";
+    content << "        return formatText(out, std::string_view(digits, static_cast<std::size_t>(result.ptr - digits)));\n";
+    content << "    }\n";
+    content << "    else if constexpr (std::is_same_v<T, std::string>)\n";
+    content << "    {\n";
+    content << "        *out++ = '\"';\n";
+    content << "        if (value.size() <= limits.max_string)\n";
+    content << "        {\n";
+    content << "            out = formatText(out, value);\n";
+    content << "            *out++ = '\"';\n";
+    content << "            return out;\n";
+    content << "        }\n";
+    content << "        out = formatText(out, std::string_view(value).substr(0, limits.max_string));\n";
+    content << "        out = formatText(out, \"\\\"...(\");\n";
+    content << "        out = formatValue(out, value.size(), limits);\n";
+    content << "        return formatText(out, \" bytes)\");\n";
+    content << "    }\n";
+    content << "    else if constexpr (std::is_same_v<T, std::vector<std::uint8_t>>)\n";
+    content << "    {\n";
+    content << "        *out++ = '<';\n";
+    content << "        out = formatValue(out, value.size(), limits);\n";
+    content << "        return formatText(out, \" bytes>\");\n";
+    content << "    }\n";
+    content << "    else if constexpr (IsFormatVector<T>::value || IsFormatMap<T>::value)\n";
+    content << "    {\n";
+    content << "        constexpr bool is_map = IsFormatMap<T>::value;\n";
+    content << "        *out++ = is_map ? '{' : '[';\n";
+    content << "        std::size_t count = 0;\n";
+    content << "        for (const auto& element : value)\n";
+    content << "        {\n";
+    content << "            if (count == limits.max_items)\n";
+    content << "            {\n";
+    content << "                break;\n";
+    content << "            }\n";
+    content << "            if (count++ != 0)\n";
+    content << "            {\n";
+    content << "                out = formatText(out, \", \");\n";
+    content << "            }\n";
+    content << "            if constexpr (is_map)\n";
+    content << "            {\n";
+    content << "                out = formatValue(out, element.first, limits);\n";
+    content << "                out = formatText(out, \": \");\n";
+    content << "                out = formatValue(out, element.second, limits);\n";
+    content << "            }\n";
+    content << "            else\n";
+    content << "            {\n";
+    content << "                out = formatValue(out, element, limits);\n";
+    content << "            }\n";
+    content << "        }\n";
+    content << "        if (count < value.size())\n";
+    content << "        {\n";
+    content << "            out = formatText(out, count == 0 ? \"...\" : \", ...\");\n";
+    content << "            out = formatValue(out, value.size(), limits);\n";
+    content << "            out = formatText(out, \" total\");\n";
+    content << "        }\n";
+    content << "        *out++ = is_map ? '}' : ']';\n";
+    content << "        return out;\n";
+    content << "    }\n";
+    content << "    else if constexpr (IsFormatShared<T>::value)\n";
+    content << "    {\n";
+    content << "        return formatValue(out, value.get(), limits);\n";
+    content << "    }\n";
+    content << "    else if constexpr (IsFormatOptional<T>::value)\n";
+    content << "    {\n";
+    content << "        return value ? formatValue(out, *value, limits) : formatText(out, \"null\");\n";
+    content << "    }\n";
+    content << "    else\n";
+    content << "    {\n";
+    content << "        return value.format_to(out, limits);\n";
+    content << "    }\n";
+    content << "}\n\n";
+
+    content << "/// @brief Format a message or value type as compact text.\n";
+    content << "/// @param out The output iterator.\n";
+    content << "/// @param message The message to format.\n";
+    content << "/// @param limits Truncation limits.\n";
+    content << "/// @return The iterator past the last character written.\n";
+    content << "template<typename OutputIt, typename M>\n";
+    content << "    requires requires(const M& m, OutputIt it, const FormatLimits& l) { { m.format_to(it, l) } -> std::same_as<OutputIt>; }\n";
+    content << "OutputIt format_to(OutputIt out, const M& message, const FormatLimits& limits = {})\n";
+    content << "{\n";
+    content << "    return message.format_to(out, limits);\n";
+    content << "}\n\n";
+
+    content << "/// @brief Format a message into a fixed buffer, cutting the text if the buffer fills up.\n";
+    content << "/// @param buffer The destination buffer.\n";
+    content << "/// @param size Size of the buffer in bytes.\n";
+    content << "/// @param message The message to format.\n";
+    content << "/// @param limits Truncation limits.\n";
+    content << "/// @return The formatted text (a view into buffer); ends with \"...\" if it was cut.\n";
+    content << "template<typename M>\n";
+    content << "std::string_view format_to_buffer(char* buffer, std::size_t size, const M& message, const FormatLimits& limits = {})\n";
+    content << "{\n";
+    content << "    const FixedBufferIterator out = message.format_to(FixedBufferIterator(buffer, buffer + size), limits);\n";
+    content << "    std::size_t length = static_cast<std::size_t>(out.position() - buffer);\n";
+    content << "    if (out.truncated() && size >= 3)\n";
+    content << "    {\n";
+    content << "        std::memcpy(buffer + size - 3, \"...\", 3);\n";
+    content << "        length = size;\n";
+    content << "    }\n";
+    content << "    return std::string_view(buffer, length);\n";
+    content << "}\n";
+
+    return content.str();
+}
+
+std::string CppFormatGenerator::_generate_std_formatter(const std::string& ns)
+{
+    std::ostringstream content;
+
+    content << "#if defined(__cpp_lib_format)\n";
+    content << "namespace std\n";
+    content << "{\n\n";
+
+    content << "/// @brief std::format support for messages and value types: std::format(\"{}\", message).\n";
+    content << "template<typename M>\n";
+    content << "    requires requires(const M& m, format_context::iterator it, const " << ns
+            << "::FormatLimits& l) { m.format_to(it, l); }\n";
+    content << "struct formatter<M, char>\n";
+    content << "{\n";
+    content << "    constexpr auto parse(format_parse_context& context)\n";
+    content << "    {\n";
+    content << "        if (context.begin() != context.end() && *context.begin() != '}')\n";
+    content << "        {\n";
+    content << "            throw format_error(\"messages take no format spec\");\n";
+    content << "        }\n";
+    content << "        return context.begin();\n";
+    content << "    }\n\n";
+
+    content << "    auto format(const M& message, format_context& context) const\n";
+    content << "    {\n";
+    content << "        return message.format_to(context.out(), " << ns << "::FormatLimits{});\n";
+    content << "    }\n";
+    content << "};\n\n";
+
+    content << "} // namespace std\n";
+    content << "#endif\n\n";
+
+    return content.str();
+}
+
+// ---- Private instance methods ----
+
+std::string CppFormatGenerator::_generate_format_content() const
+{
+    std::ostringstream content;
+
+    // Use wrapper_namespace_name if specified, otherwise fall back to namespace_name
+    const std::string& raw_ns = _schema.wrapper_namespace_name.empty() ?
+                                  _schema.namespace_name : _schema.wrapper_namespace_name;
+    const std::string ns = raw_ns.empty() ?
+                             "curious::net" :
+                             string_utils::to_cpp_namespace(raw_ns);
+
+    content << "#pragma once\n\n";
+    content << "#ifndef FORMAT_HPP\n";
+    content << "#define FORMAT_HPP\n\n";
+
+    // Includes
+    content << "#include <algorithm>\n";
+    content << "#include <charconv>\n";
+    content << "#include <concepts>\n";
+    content << "#include <cstddef>\n";
+    content << "#include <cstdint>\n";
+    content << "#include <cstring>\n";
+    content << "#include <iterator>\n";
+    content << "#include <optional>\n";
+    content << "#include <string>\n";
+    content << "#include <string_view>\n";
+    content << "#include <type_traits>\n";
+    content << "#include <unordered_map>\n";
+    content << "#include <vector>\n";
+    content << "#include <version>\n";
+    content << "#if defined(__cpp_lib_format)\n";
+    content << "#include <format>\n";
+    content << "#endif\n\n";
+    content << "#include <" << _includePrefix << "MessageBase.hpp>\n";
+    content << "#include <" << _includePrefix << "Json.hpp>\n\n";
+
+    // Open namespace
+    content << "namespace " << ns << "\n";
+    content << "{\n\n";
+
+    content << _generate_formatters();
+
+    // Close namespace
+    content << "\n} // namespace " << ns << "\n\n";
+
+    content << _generate_std_formatter(ns);
+
+    // Close header guard
+    content << "#endif // FORMAT_HPP\n";
+
+    return content.str();
+}
+
+} // namespace curious::dsl::capnpgen
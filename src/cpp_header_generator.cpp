@@ -10,6 +10,8 @@
 #include <stdexcept>
 
 #include "string_utils.hpp"
+#include "struct_layout.hpp"
+#include "type_converter.hpp"
 
 namespace curious::dsl::capnpgen
 {
@@ -58,14 +60,24 @@ std::string extract_between_markers(const std::string& content,
 
 // ---- Constructor ----
 
-CppHeaderGenerator::CppHeaderGenerator(const Schema& schema, const std::string& output_directory)
+CppHeaderGenerator::CppHeaderGenerator(const Schema& schema, const std::string& output_directory, bool static_dispatch,
+                                       bool validate_utf8)
     : _schema(schema)
     , _outputDirectory(_resolve_output_directory(output_directory))
+    , _staticDispatch(static_dispatch)
+    , _validateUtf8(validate_utf8)
 {
-    // Generate header for each message
+    // Generate header for each message (value types get a plain struct)
     for (const auto& [message_name, message] : _schema.messages)
     {
-        _generate_header_for_message(message);
+        if (message.is_value_type())
+        {
+            _generate_value_struct_for_message(message);
+        }
+        else
+        {
+            _generate_header_for_message(message);
+        }
     }
 }
 
@@ -107,6 +119,28 @@ std::string CppHeaderGenerator::_to_capnp_method_name(const std::string& field_n
 
 // ---- Private instance methods ----
 
+std::set<std::string> CppHeaderGenerator::_get_known_enum_names() const
+{
+    std::set<std::string> enum_names;
+    for (const auto& [enum_name, enum_decl] : _schema.enums)
+    {
+        enum_names.insert(enum_name);
+    }
+    return enum_names;
+}
+
+bool CppHeaderGenerator::_is_leaf_message(const Message& message) const
+{
+    for (const auto& [other_name, other] : _schema.messages)
+    {
+        if (other.parent_name == message.name)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 std::string CppHeaderGenerator::_get_parent_class_name(const Message& message)
 {
     if (message.parent_name.empty())
@@ -154,20 +188,264 @@ void CppHeaderGenerator::_generate_header_for_message(const Message& message)
     output_file << content;
 }
 
+void CppHeaderGenerator::_generate_value_struct_for_message(const Message& message)
+{
+    namespace fs = std::filesystem;
+
+    fs::path output_file_path = fs::path(_outputDirectory) / (message.name + ".hpp");
+
+    // Value types are fully generated: no user sections to preserve
+    std::string content = _generate_value_struct_content(message);
+
+    std::ofstream output_file(output_file_path, std::ios::binary);
+    if (!output_file)
+    {
+        throw std::runtime_error("Failed to create header file: " + output_file_path.string());
+    }
+
+    output_file << content;
+}
+
+std::string CppHeaderGenerator::_generate_value_struct_content(const Message& message)
+{
+    std::ostringstream content;
+
+    // Header guard
+    std::string guard_name = message.name;
+    for (char& c : guard_name)
+    {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    guard_name += "_HPP";
+
+    content << "#pragma once\n\n";
+    content << "#ifndef " << guard_name << "\n";
+    content << "#define " << guard_name << "\n\n";
+
+    // Includes
+    content << "#include <array>\n";
+    content << "#include <cstdint>\n";
+    content << "#include <optional>\n";
+    content << "#include <string>\n";
+    content << "#include <string_view>\n";
+    content << "#include <vector>\n";
+    content << "#include <unordered_map>\n";
+    content << "#include <variant>\n";
+    content << "#include <kj/array.h>\n\n";
+    content << "#include \"MessageBase.hpp\"\n";
+    content << "#include \"enums.hpp\"\n";
+    content << "#include \"Json.hpp\"\n";
+    content << "#include \"Format.hpp\"\n";
+    content << "#include <messages/network_msg.capnp.h>\n";
+
+    // Nested value types
+    std::set<std::string> included_types;
+    std::vector<Type> member_types = message.fields;
+    for (const auto& union_decl : message.unions)
+    {
+        member_types.insert(member_types.end(), union_decl.arms.begin(), union_decl.arms.end());
+    }
+    for (const auto& field : member_types)
+    {
+        const Type* nested_type = field.is_list() ? field.get_element_type() : &field;
+        if (nested_type != nullptr && nested_type->is_custom() &&
+            nested_type->get_custom_name() != message.name &&
+            _schema.messages.count(nested_type->get_custom_name()) > 0 &&
+            included_types.insert(nested_type->get_custom_name()).second)
+        {
+            content << "#include \"" << nested_type->get_custom_name() << ".hpp\"\n";
+        }
+    }
+    content << "\n";
+
+    const std::string& raw_ns = _schema.wrapper_namespace_name.empty() ?
+                                  _schema.namespace_name : _schema.wrapper_namespace_name;
+    const std::string ns = raw_ns.empty() ?
+                             "curious::net" :
+                             string_utils::to_cpp_namespace(raw_ns);
+    content << "namespace " << ns << "\n{\n\n";
+
+    content << "/// @brief Plain value type for " << message.value_of << ", used by @value fields.\n";
+    content << "/// @details An aggregate with no vtable and no msgType header, encoded as the lean\n";
+    content << "///          " << message.name << " Cap'n Proto struct. Inherited fields are flattened.\n";
+    content << "struct " << message.name << "\n";
+    content << "{\n";
+
+    for (const auto& field : message.fields)
+    {
+        content << "    " << TypeConverter::get_member_type(field) << " " << field.get_field_name() << "{"
+                << (field.has_default_value() ? TypeConverter::get_default_value(field) : "") << "};\n";
+    }
+    for (const auto& union_decl : message.unions)
+    {
+        content << "    " << union_decl.get_cpp_type() << " " << union_decl.get_member_name() << ";\n";
+    }
+    if (!message.fields.empty() || !message.unions.empty())
+    {
+        content << "\n";
+    }
+
+    content << "    /// @brief Compare all fields.\n";
+    content << "    bool operator==(const " << message.name << "&) const = default;\n\n";
+
+    content << "    /// @brief Convert this value to a Cap'n Proto struct builder.\n";
+    content << "    /// @tparam StructBuilder The specific capnp struct builder type.\n";
+    content << "    /// @param builder The builder to populate.\n";
+    content << "    template<typename StructBuilder>\n";
+    content << "    void to_capnp_struct(StructBuilder&& builder) const;\n\n";
+
+    content << "    /// @brief Populate this value from a Cap'n Proto struct reader.\n";
+    content << "    /// @tparam StructReader The specific capnp struct reader type.\n";
+    content << "    /// @param reader The reader to read from.\n";
+    content << "    template<typename StructReader>\n";
+    content << "    void from_capnp_struct(const StructReader& reader);\n\n";
+
+    content << "    /// @brief Populate only the fields selected by a mask.\n";
+    content << "    /// @tparam StructReader The specific capnp struct reader type.\n";
+    content << "    /// @param reader The reader to read from.\n";
+    content << "    /// @param mask The fields to decode; other fields are left unchanged.\n";
+    content << "    template<typename StructReader>\n";
+    content << "    void from_capnp_struct(const StructReader& reader, const FieldMask& mask);\n\n";
+
+    content << "    /// @brief Prefetch heap-allocated field storage (used by list encoders).\n";
+    content << "    void prefetch() const;\n\n";
+
+    _generate_json_declarations(content, message.fields, message.unions);
+    content << "\n";
+    _generate_format_declaration(content);
+    content << "};\n\n";
+
+    // Template implementations share the message field codecs, qualified for a non-member
+    content << "// ---- Template Implementation ----\n\n";
+
+    content << "template<typename StructBuilder>\n";
+    content << "void " << message.name << "::to_capnp_struct(StructBuilder&& builder) const\n";
+    content << "{\n";
+    for (const auto& field : message.fields)
+    {
+        _generate_to_capnp_struct_field(content, field, "MessageBase::");
+    }
+    for (const auto& union_decl : message.unions)
+    {
+        content << TypeConverter::generate_union_to_capnp_code(union_decl, "builder", 1, _get_known_enum_names());
+    }
+    content << "}\n\n";
+
+    content << "template<typename StructReader>\n";
+    content << "void " << message.name << "::from_capnp_struct(const StructReader& reader)\n";
+    content << "{\n";
+    for (const auto& field : message.fields)
+    {
+        _generate_from_capnp_struct_field(content, field, "MessageBase::");
+    }
+    for (const auto& union_decl : message.unions)
+    {
+        content << TypeConverter::generate_union_from_capnp_code(union_decl, "reader", 1, _get_known_enum_names(),
+                                                                 _validateUtf8);
+    }
+    content << "}\n\n";
+
+    content << "template<typename StructReader>\n";
+    content << "void " << message.name << "::from_capnp_struct(const StructReader& reader, const FieldMask& mask)\n";
+    content << "{\n";
+    for (const auto& field : message.fields)
+    {
+        _generate_masked_from_capnp_struct_field(content, field, "MessageBase::");
+    }
+    for (const auto& union_decl : message.unions)
+    {
+        _generate_masked_from_capnp_struct_union(content, union_decl);
+    }
+    content << "}\n\n";
+
+    content << "inline void " << message.name << "::prefetch() const\n";
+    content << "{\n";
+    for (const auto& field : message.fields)
+    {
+        std::string cpp_type = field.get_cpp_type();
+        if (field.is_list() || cpp_type == "std::string" || cpp_type == "std::vector<uint8_t>")
+        {
+            if (field.has_annotation("optional"))
+            {
+                content << "    if (" << field.get_field_name() << ")\n";
+                content << "    {\n";
+                content << "        MessageBase::prefetchRead(" << field.get_field_name() << "->data());\n";
+                content << "    }\n";
+                continue;
+            }
+            content << "    MessageBase::prefetchRead(" << field.get_field_name() << ".data());\n";
+        }
+    }
+    content << "}\n\n";
+
+    _generate_json_definitions(content, message.name, message.fields, message.unions);
+    _generate_format_definition(content, message.name, message.fields, message.unions);
+
+    // Close namespace
+    content << "} // namespace " << ns << "\n\n";
+
+    // Close header guard
+    content << "#endif // " << guard_name << "\n";
+
+    return content.str();
+}
+
 std::string CppHeaderGenerator::_generate_field_declarations(const Message& message)
 {
     std::ostringstream fields;
 
-    for (const auto& field : message.fields)
+    // Members are laid out by alignment and @hot/@cold hints; the wire order is unchanged
+    for (const auto& field : StructLayout::order_members(_schema, message))
     {
         fields << "    /// @brief Field: " << field.get_field_name() << "\n";
         fields << "    /// @details Type: " << field.get_cpp_type() << "\n";
-        fields << "    " << field.get_cpp_type() << " " << field.get_field_name() << ";\n\n";
+        if (field.has_annotation("shared"))
+        {
+            fields << "    /// @note Shared copy-on-write: copies share the value, mutate() clones it.\n";
+        }
+        if (field.has_annotation("optional"))
+        {
+            fields << "    /// @note Optional: left off the wire while unset; decodes to std::nullopt when absent.\n";
+        }
+        fields << "    " << TypeConverter::get_member_type(field) << " " << field.get_field_name();
+        if (field.has_default_value())
+        {
+            fields << " = " << TypeConverter::get_default_value(field);
+        }
+        else if (StructLayout::get_data_lg_size(_schema, field) ||
+                 (field.is_custom() && _schema.messages.count(field.get_custom_name()) == 0))
+        {
+            // Scalars and enums (including ones declared outside the DSL) would otherwise be
+            // indeterminate after default construction
+            fields << "{}";
+        }
+        fields << ";\n\n";
+    }
+
+    for (const auto& union_decl : message.unions)
+    {
+        fields << _generate_union_declaration(union_decl);
     }
 
     return fields.str();
 }
 
+std::string CppHeaderGenerator::_generate_union_declaration(const UnionDecl& union_decl)
+{
+    std::ostringstream declaration;
+
+    declaration << "    /// @brief Union: " << union_decl.get_member_name() << "\n";
+    declaration << "    /// @details Alternatives by index:";
+    for (std::size_t i = 0; i < union_decl.arms.size(); ++i)
+    {
+        declaration << (i == 0 ? " " : ", ") << i << " " << union_decl.arms[i].get_field_name();
+    }
+    declaration << "\n";
+    declaration << "    " << union_decl.get_cpp_type() << " " << union_decl.get_member_name() << ";\n\n";
+
+    return declaration.str();
+}
+
 std::string CppHeaderGenerator::_generate_header_content(const Message& message,
                                                            const std::string& user_includes,
                                                            const std::string& user_methods,
@@ -189,14 +467,20 @@ std::string CppHeaderGenerator::_generate_header_content(const Message& message,
     content << "#define " << guard_name << "\n\n";
 
     // Includes
+    content << "#include <array>\n";
     content << "#include <cstdint>\n";
+    content << "#include <optional>\n";
     content << "#include <string>\n";
+    content << "#include <string_view>\n";
     content << "#include <vector>\n";
     content << "#include <unordered_map>\n";
+    content << "#include <variant>\n";
     content << "#include <memory>\n";
     content << "#include <kj/array.h>\n\n";
     content << "#include \"MessageBase.hpp\"\n";
     content << "#include \"enums.hpp\"\n";
+    content << "#include \"Json.hpp\"\n";
+    content << "#include \"Format.hpp\"\n";
     content << "#include <messages/network_msg.capnp.h>\n";
 
     // Include parent class header
@@ -205,9 +489,14 @@ std::string CppHeaderGenerator::_generate_header_content(const Message& message,
         content << "#include \"" << message.parent_name << ".hpp\"\n";
     }
 
-    // Include headers for custom types used in fields
+    // Include headers for custom types used in fields and union alternatives
     std::set<std::string> included_types;
-    for (const auto& field : message.fields)
+    std::vector<Type> member_types = message.fields;
+    for (const auto& union_decl : message.unions)
+    {
+        member_types.insert(member_types.end(), union_decl.arms.begin(), union_decl.arms.end());
+    }
+    for (const auto& field : member_types)
     {
         std::string type_name;
         if (field.get_kind() == Type::Kind::Custom)
@@ -266,10 +555,28 @@ std::string CppHeaderGenerator::_generate_header_content(const Message& message,
     {
         content << "///          Inherits from: " << message.parent_name << "\n";
     }
-    content << "class " << message.name << " : public " << _get_parent_class_name(message) << "\n";
+    // Leaf classes are final so calls on the concrete type devirtualize
+    const bool static_dispatch = _staticDispatch && _is_leaf_message(message);
+    content << "class " << message.name << (static_dispatch ? " final" : "")
+            << " : public " << _get_parent_class_name(message);
+    if (static_dispatch)
+    {
+        content << ", public MessageImpl<" << message.name << ">";
+    }
+    content << "\n";
     content << "{\n";
     content << "public:\n";
 
+    const std::string capnp_ns = _schema.namespace_name.empty() ?
+                                   "curious::message" :
+                                   string_utils::to_cpp_namespace(_schema.namespace_name);
+    content << "    /// @brief Message type identifier, usable without an instance.\n";
+    content << "    static constexpr std::uint64_t _k_message_id = " << message.id << ";\n\n";
+    content << "    /// @brief Message type name, usable without an instance or allocation.\n";
+    content << "    static constexpr std::string_view _k_message_name = \"" << message.name << "\";\n\n";
+    content << "    /// @brief The Cap'n Proto struct this class encodes to.\n";
+    content << "    using CapnpType = ::" << capnp_ns << "::" << message.name << ";\n\n";
+
     // Constructors
     content << "    // ---- Constructors and Destructor ----\n\n";
     content << "    /// @brief Default constructor.\n";
@@ -309,6 +616,10 @@ std::string CppHeaderGenerator::_generate_header_content(const Message& message,
     content << "    /// @return SerializedData containing word-aligned serialized data.\n";
     content << "    SerializedData serialize_fast() const override;\n\n";
 
+    content << "    /// @brief Serialize this message without flattening its segments.\n";
+    content << "    /// @return SerializedSegments holding the builder and iovecs for writev()/sendmsg().\n";
+    content << "    SerializedSegments serialize_segments() const override;\n\n";
+
     content << "    /// @brief Deserialize from a byte vector.\n";
     content << "    /// @param data The serialized data.\n";
     content << "    /// @return True if deserialization succeeded, false otherwise.\n";
@@ -319,16 +630,27 @@ std::string CppHeaderGenerator::_generate_header_content(const Message& message,
     content << "    /// @param size Size of the data buffer in bytes.\n";
     content << "    /// @return True if deserialization succeeded, false otherwise.\n";
     content << "    bool deserialize(const std::uint8_t* data, std::size_t size) override;\n\n";
+    content << "    // Keep the inherited SharedSerializedData overload visible\n";
+    content << "    using " << _get_parent_class_name(message) << "::deserialize;\n\n";
 
     // Cap'n Proto conversion methods
     content << "    // ---- Cap'n Proto Conversion Methods ----\n\n";
     content << "    /// @brief Convert this object to a Cap'n Proto message builder.\n";
     content << "    /// @param message_builder The Cap'n Proto message builder to populate.\n";
-    content << "    void to_capnp(::capnp::MessageBuilder& message_builder) const;\n\n";
+    content << "    void to_capnp(::capnp::MessageBuilder& message_builder) const override;\n\n";
 
     content << "    /// @brief Populate this object from a Cap'n Proto message reader.\n";
     content << "    /// @param message_reader The Cap'n Proto message reader to read from.\n";
-    content << "    void from_capnp(::capnp::MessageReader& message_reader);\n\n";
+    content << "    void from_capnp(::capnp::MessageReader& message_reader) override;\n\n";
+
+    content << "    /// @brief Populate only the fields selected by a mask.\n";
+    content << "    /// @param message_reader The Cap'n Proto message reader to read from.\n";
+    content << "    /// @param mask The fields to decode; other fields are left unchanged.\n";
+    content << "    void from_capnp(::capnp::MessageReader& message_reader, const FieldMask& mask) override;\n\n";
+    content << "    /// @brief Populate this object, decoding large list fields concurrently.\n";
+    content << "    /// @param message_reader The Cap'n Proto message reader to read from.\n";
+    content << "    /// @param executor Runs the list ranges; must outlive the call.\n";
+    content << "    void from_capnp_parallel(::capnp::MessageReader& message_reader, ParallelExecutor& executor);\n\n";
 
     content << "    /// @brief Convert this object to a Cap'n Proto struct builder (for nested types).\n";
     content << "    /// @tparam StructBuilder The specific capnp struct builder type.\n";
@@ -342,6 +664,45 @@ std::string CppHeaderGenerator::_generate_header_content(const Message& message,
     content << "    template<typename StructReader>\n";
     content << "    void from_capnp_struct(const StructReader& reader);\n\n";
 
+    content << "    /// @brief Populate only the fields selected by a mask (for nested types).\n";
+    content << "    /// @tparam StructReader The specific capnp struct reader type.\n";
+    content << "    /// @param reader The reader to read from.\n";
+    content << "    /// @param mask The fields to decode; other fields are left unchanged.\n";
+    content << "    template<typename StructReader>\n";
+    content << "    void from_capnp_struct(const StructReader& reader, const FieldMask& mask);\n\n";
+
+    content << "    /// @brief Prefetch heap-allocated field storage (used by list encoders).\n";
+    content << "    void prefetch() const;\n\n";
+
+    // JSON covers inherited fields too, as one flat object
+    const std::vector<Type> all_fields = _get_all_fields(message);
+    const std::vector<UnionDecl> all_unions = _get_all_unions(message);
+    content << "    // ---- JSON Transcoding ----\n\n";
+    _generate_json_declarations(content, all_fields, all_unions);
+    content << "\n";
+
+    content << "    // ---- Formatting ----\n\n";
+    _generate_format_declaration(content);
+    content << "\n";
+
+    // In-place patching of fixed-width own fields (inherited ones come from the parent class)
+    auto patch_slots = _get_own_patch_slots(message);
+    if (!patch_slots.empty())
+    {
+        content << "    // ---- In-Place Patching ----\n\n";
+        for (const auto& [field, slot] : patch_slots)
+        {
+            content << "    /// @brief Overwrite " << field.get_field_name()
+                    << " in a serialized message (this type or a subclass) without decoding it.\n";
+            content << "    /// @param data Flat-array message bytes, modified in place.\n";
+            content << "    /// @param size Size of the buffer in bytes.\n";
+            content << "    /// @param value The new value.\n";
+            content << "    /// @return False if the buffer does not hold the field (malformed or older, shorter layout).\n";
+            content << "    static bool patch_" << field.get_field_name() << "(std::uint8_t* data, std::size_t size, "
+                    << field.get_cpp_type() << " value);\n\n";
+        }
+    }
+
     // Fields
     content << "    // ---- Generated Fields ----\n\n";
     content << _generate_field_declarations(message);
@@ -394,18 +755,98 @@ std::string CppHeaderGenerator::_generate_header_content(const Message& message,
     {
         _generate_to_capnp_struct_field(content, field);
     }
+    for (const auto& union_decl : message.unions)
+    {
+        content << TypeConverter::generate_union_to_capnp_code(union_decl, "builder", 1, _get_known_enum_names());
+    }
     content << "}\n\n";
 
     // from_capnp_struct template
     content << "template<typename StructReader>\n";
     content << "void " << message.name << "::from_capnp_struct(const StructReader& reader)\n";
     content << "{\n";
+    if (!message.parent_name.empty())
+    {
+        content << "    // Populate parent fields first\n";
+        content << "    " << message.parent_name << "::from_capnp_struct(reader);\n\n";
+    }
     for (const auto& field : message.fields)
     {
         _generate_from_capnp_struct_field(content, field);
     }
+    for (const auto& union_decl : message.unions)
+    {
+        content << TypeConverter::generate_union_from_capnp_code(union_decl, "reader", 1, _get_known_enum_names(),
+                                                                 _validateUtf8);
+    }
     content << "}\n\n";
 
+    // Masked from_capnp_struct template (covers inherited fields too)
+    content << "template<typename StructReader>\n";
+    content << "void " << message.name << "::from_capnp_struct(const StructReader& reader, const FieldMask& mask)\n";
+    content << "{\n";
+    for (const auto& field : all_fields)
+    {
+        _generate_masked_from_capnp_struct_field(content, field);
+    }
+    for (const auto& union_decl : all_unions)
+    {
+        _generate_masked_from_capnp_struct_union(content, union_decl);
+    }
+    content << "}\n\n";
+
+    // patch_<field>: generator-computed data section offsets
+    for (const auto& [field, slot] : _get_own_patch_slots(message))
+    {
+        const std::string cpp_type = field.get_cpp_type();
+        content << "inline bool " << message.name << "::patch_" << field.get_field_name()
+                << "(std::uint8_t* data, std::size_t size, " << cpp_type << " value)\n";
+        content << "{\n";
+        if (slot.lg_size_bits == 0)
+        {
+            content << "    return patchBoolField(data, size, " << slot.bit_offset << ", value, "
+                    << (field.has_default_value() ? field.get_default_value() : "false") << ");\n";
+        }
+        else
+        {
+            const std::string wire_type = "std::uint" + std::to_string(1u << slot.lg_size_bits) + "_t";
+            content << "    return patchDataField<" << wire_type << ", " << cpp_type << ">(data, size, "
+                    << slot.bit_offset / 8 << ", value, "
+                    << (field.has_default_value() ? TypeConverter::get_default_value(field) : cpp_type + "{}")
+                    << ");\n";
+        }
+        content << "}\n\n";
+    }
+
+    // prefetch: touch the out-of-line storage of strings, bytes and lists
+    content << "inline void " << message.name << "::prefetch() const\n";
+    content << "{\n";
+    if (!message.parent_name.empty())
+    {
+        content << "    " << message.parent_name << "::prefetch();\n";
+    }
+    for (const auto& field : message.fields)
+    {
+        std::string cpp_type = field.get_cpp_type();
+        if (field.is_list() || cpp_type == "std::string" || cpp_type == "std::vector<uint8_t>")
+        {
+            if (field.has_annotation("optional"))
+            {
+                content << "    if (" << field.get_field_name() << ")\n";
+                content << "    {\n";
+                content << "        prefetchRead(" << field.get_field_name() << "->data());\n";
+                content << "    }\n";
+                continue;
+            }
+            content << "    prefetchRead(" << TypeConverter::get_value_expr(field, field.get_field_name())
+                    << ".data());\n";
+        }
+    }
+    content << "}\n\n";
+
+    _generate_json_definitions(content, message.name, all_fields, all_unions);
+    _generate_format_definition(content, message.name, all_fields, all_unions);
+
     // Close namespace
     content << "} // namespace " << ns << "\n\n";
 
@@ -415,11 +856,174 @@ std::string CppHeaderGenerator::_generate_header_content(const Message& message,
     return content.str();
 }
 
-void CppHeaderGenerator::_generate_to_capnp_struct_field(std::ostringstream& content, const Type& field) const
+void CppHeaderGenerator::_generate_masked_from_capnp_struct_field(std::ostringstream& content, const Type& field,
+                                                                  const std::string& helper_scope) const
 {
     const std::string& field_name = field.get_field_name();
     std::string capnp_method = _to_capnp_method_name(field_name);
 
+    // Reuse the unmasked decoder for the field, indented into the mask checks
+    auto indent_block = [](const std::string& block, const std::string& indent)
+    {
+        std::istringstream lines(block);
+        std::ostringstream indented;
+        for (std::string line; std::getline(lines, line);)
+        {
+            indented << (line.empty() ? "" : indent) << line << "\n";
+        }
+        return indented.str();
+    };
+    std::ostringstream full_decode;
+    _generate_from_capnp_struct_field(full_decode, field, helper_scope);
+
+    const Type* nested_type = field.is_list() ? field.get_element_type() : &field;
+    bool is_nested_message = nested_type != nullptr && nested_type->is_custom() &&
+                               _schema.messages.find(nested_type->get_custom_name()) != _schema.messages.end();
+
+    content << "    if (mask.contains(\"" << field_name << "\"))\n";
+    content << "    {\n";
+
+    if (!is_nested_message)
+    {
+        content << indent_block(full_decode.str(), "    ");
+        content << "    }\n";
+        return;
+    }
+
+    // Nested messages narrow the decode with their own mask when one is given
+    std::string target = field.has_annotation("shared")   ? field_name + ".reset()" :
+                         field.has_annotation("optional") ? TypeConverter::get_engaged_expr(field_name) :
+                                                            field_name;
+    content << "        if (const FieldMask* nested_mask = mask.nested(\"" << field_name << "\"))\n";
+    content << "        {\n";
+    content << "            if (reader.has" << capnp_method << "())\n";
+    content << "            {\n";
+    if (field.is_list())
+    {
+        content << "                auto list_reader = reader.get" << capnp_method << "();\n";
+        content << "                auto& values = " << target << ";\n";
+        content << "                values.clear();\n";
+        content << "                values.resize(list_reader.size());\n";
+        content << "                for (unsigned int i = 0; i < list_reader.size(); ++i)\n";
+        content << "                {\n";
+        content << "                    values[i].from_capnp_struct(list_reader[i], *nested_mask);\n";
+        content << "                }\n";
+    }
+    else
+    {
+        content << "                " << target << ".from_capnp_struct(reader.get" << capnp_method
+                << "(), *nested_mask);\n";
+    }
+    content << "            }\n";
+    if (field.has_annotation("optional"))
+    {
+        content << "            else\n";
+        content << "            {\n";
+        content << "                " << field_name << ".reset();\n";
+        content << "            }\n";
+    }
+    content << "        }\n";
+    content << "        else\n";
+    content << "        {\n";
+    content << indent_block(full_decode.str(), "        ");
+    content << "        }\n";
+    content << "    }\n";
+}
+
+void CppHeaderGenerator::_generate_masked_from_capnp_struct_union(std::ostringstream& content,
+                                                                  const UnionDecl& union_decl) const
+{
+    // A union is selected as a whole by its member name
+    std::istringstream lines(TypeConverter::generate_union_from_capnp_code(union_decl, "reader", 1,
+                                                                           _get_known_enum_names(), _validateUtf8));
+    content << "    if (mask.contains(\"" << union_decl.get_member_name() << "\"))\n";
+    content << "    {\n";
+    for (std::string line; std::getline(lines, line);)
+    {
+        content << (line.empty() ? "" : "    ") << line << "\n";
+    }
+    content << "    }\n";
+}
+
+std::vector<std::pair<Type, DataFieldSlot>> CppHeaderGenerator::_get_own_patch_slots(const Message& message) const
+{
+    std::vector<std::pair<Type, DataFieldSlot>> own_slots;
+    auto slots = StructLayout::compute_data_slots(_schema, message);
+    for (const auto& field : message.fields)
+    {
+        for (const auto& slot : slots)
+        {
+            if (slot.field_name == field.get_field_name())
+            {
+                own_slots.emplace_back(field, slot);
+                break;
+            }
+        }
+    }
+    return own_slots;
+}
+
+std::vector<Type> CppHeaderGenerator::_get_all_fields(const Message& message) const
+{
+    std::vector<Type> all_fields;
+
+    // Recursively get parent fields first
+    if (!message.parent_name.empty())
+    {
+        auto parent_it = _schema.messages.find(message.parent_name);
+        if (parent_it != _schema.messages.end())
+        {
+            auto parent_fields = _get_all_fields(parent_it->second);
+            all_fields.insert(all_fields.end(), parent_fields.begin(), parent_fields.end());
+        }
+    }
+
+    // Add this message's own fields
+    all_fields.insert(all_fields.end(), message.fields.begin(), message.fields.end());
+
+    return all_fields;
+}
+
+std::vector<UnionDecl> CppHeaderGenerator::_get_all_unions(const Message& message) const
+{
+    std::vector<UnionDecl> all_unions;
+
+    // Recursively get parent unions first
+    if (!message.parent_name.empty())
+    {
+        auto parent_it = _schema.messages.find(message.parent_name);
+        if (parent_it != _schema.messages.end())
+        {
+            all_unions = _get_all_unions(parent_it->second);
+        }
+    }
+
+    all_unions.insert(all_unions.end(), message.unions.begin(), message.unions.end());
+
+    return all_unions;
+}
+
+void CppHeaderGenerator::_generate_to_capnp_struct_field(std::ostringstream& content, const Type& field,
+                                                         const std::string& helper_scope) const
+{
+    const std::string& field_name = field.get_field_name();
+    std::string capnp_method = _to_capnp_method_name(field_name);
+
+    if (field.has_annotation("optional"))
+    {
+        content << TypeConverter::generate_optional_to_capnp_code(field, "builder", 1, _get_known_enum_names());
+        return;
+    }
+
+    if (field.has_annotation("shared"))
+    {
+        // Copy-on-write fields are read through the shared handle
+        content << TypeConverter::generate_to_capnp_code(field, "builder",
+                                                         TypeConverter::get_value_expr(field, field_name),
+                                                         field_name, 1, _get_known_enum_names());
+        return;
+    }
+
     if (field.get_kind() == Type::Kind::List)
     {
         const Type* element_type = field.get_element_type();
@@ -432,11 +1036,26 @@ void CppHeaderGenerator::_generate_to_capnp_struct_field(std::ostringstream& con
         content << "    if (!" << field_name << ".empty())\n";
         content << "    {\n";
         content << "        auto list_builder = builder.init" << capnp_method << "(" << field_name << ".size());\n";
+
+        if (element_type && TypeConverter::is_fixed_width_primitive(*element_type))
+        {
+            // Wire layout matches the host on little-endian: bulk copy
+            content << "        " << helper_scope << "bulkCopyToList(" << field_name << ", list_builder);\n";
+            content << "    }\n";
+            return;
+        }
+
         content << "        for (size_t i = 0; i < " << field_name << ".size(); ++i)\n";
         content << "        {\n";
 
         if (is_custom_element)
         {
+            // Warm the heap storage of upcoming elements while encoding this one
+            content << "            if (i + " << helper_scope << "_k_list_prefetch_distance < " << field_name << ".size())\n";
+            content << "            {\n";
+            content << "                " << field_name << "[i + " << helper_scope
+                    << "_k_list_prefetch_distance].prefetch();\n";
+            content << "            }\n";
             content << "            " << field_name << "[i].to_capnp_struct(list_builder[i]);\n";
         }
         else if (is_enum_element)
@@ -493,11 +1112,30 @@ void CppHeaderGenerator::_generate_to_capnp_struct_field(std::ostringstream& con
     }
 }
 
-void CppHeaderGenerator::_generate_from_capnp_struct_field(std::ostringstream& content, const Type& field) const
+void CppHeaderGenerator::_generate_from_capnp_struct_field(std::ostringstream& content, const Type& field,
+                                                           const std::string& helper_scope) const
 {
     const std::string& field_name = field.get_field_name();
     std::string capnp_method = _to_capnp_method_name(field_name);
 
+    if (field.has_annotation("optional"))
+    {
+        content << TypeConverter::generate_optional_from_capnp_code(field, "reader", 1, _get_known_enum_names(),
+                                                                    _validateUtf8);
+        return;
+    }
+
+    if (field.has_annotation("shared"))
+    {
+        // Decode into a fresh, unshared value so existing snapshot holders are unaffected
+        content << "    {\n";
+        content << "        auto& " << field_name << "_value = " << field_name << ".reset();\n";
+        content << TypeConverter::generate_from_capnp_code(field, "reader", field_name + "_value",
+                                                           2, _get_known_enum_names(), _validateUtf8);
+        content << "    }\n";
+        return;
+    }
+
     if (field.get_kind() == Type::Kind::List)
     {
         const Type* element_type = field.get_element_type();
@@ -511,24 +1149,46 @@ void CppHeaderGenerator::_generate_from_capnp_struct_field(std::ostringstream& c
         content << "    if (reader.has" << capnp_method << "())\n";
         content << "    {\n";
         content << "        auto list_reader = reader.get" << capnp_method << "();\n";
+
+        if (element_type && TypeConverter::is_fixed_width_primitive(*element_type))
+        {
+            // Wire layout matches the host on little-endian: bulk copy
+            content << "        " << helper_scope << "bulkCopyFromList(list_reader, " << field_name << ");\n";
+            content << "    }\n";
+            return;
+        }
+
+        if (is_custom_element)
+        {
+            // Decode nested messages in place instead of constructing and moving temporaries
+            content << "        " << field_name << ".clear();\n";
+            content << "        " << field_name << ".resize(list_reader.size());\n";
+            content << "        for (unsigned int i = 0; i < list_reader.size(); ++i)\n";
+            content << "        {\n";
+            content << "            " << field_name << "[i].from_capnp_struct(list_reader[i]);\n";
+            content << "        }\n";
+            content << "    }\n";
+            return;
+        }
+
         content << "        " << field_name << ".clear();\n";
         content << "        " << field_name << ".reserve(list_reader.size());\n";
         content << "        for (const auto& item : list_reader)\n";
         content << "        {\n";
 
-        if (is_custom_element)
-        {
-            content << "            " << element_type_name << " elem;\n";
-            content << "            elem.from_capnp_struct(item);\n";
-            content << "            " << field_name << ".push_back(std::move(elem));\n";
-        }
-        else if (is_enum_element)
+        if (is_enum_element)
         {
             content << "            " << field_name << ".push_back(static_cast<"
                       << element_type_name << ">(item));\n";
         }
         else
         {
+            if (_validateUtf8 && element_type && element_type->is_primitive() &&
+                element_type->get_cpp_type() == "std::string")
+            {
+                content << "            " << helper_scope << "requireUtf8(item.begin(), item.size(), \""
+                        << field_name << "\");\n";
+            }
             content << "            " << field_name << ".push_back(item);\n";
         }
 
@@ -547,6 +1207,21 @@ void CppHeaderGenerator::_generate_from_capnp_struct_field(std::ostringstream& c
         content << "            auto entries = map_reader.getEntries();\n";
         content << "            for (const auto& entry : entries)\n";
         content << "            {\n";
+        if (_validateUtf8)
+        {
+            const Type* key_type = field.get_key_type();
+            const Type* value_type = field.get_value_type();
+            if (key_type && key_type->is_primitive() && key_type->get_cpp_type() == "std::string")
+            {
+                content << "                " << helper_scope << "requireUtf8(entry.getKey().begin(), entry.getKey().size(), \""
+                        << field_name << "\");\n";
+            }
+            if (value_type && value_type->is_primitive() && value_type->get_cpp_type() == "std::string")
+            {
+                content << "                " << helper_scope << "requireUtf8(entry.getValue().begin(), entry.getValue().size(), \""
+                        << field_name << "\");\n";
+            }
+        }
         content << "                " << field_name << "[entry.getKey()] = entry.getValue();\n";
         content << "            }\n";
         content << "        }\n";
@@ -575,6 +1250,15 @@ void CppHeaderGenerator::_generate_from_capnp_struct_field(std::ostringstream& c
         content << "        " << field_name << ".assign(data.begin(), data.end());\n";
         content << "    }\n";
     }
+    else if (_validateUtf8 && field.get_kind() == Type::Kind::Primitive && field.get_cpp_type() == "std::string")
+    {
+        // Validate while the text is cache-hot, right before the copy
+        content << "    {\n";
+        content << "        auto text = reader.get" << capnp_method << "();\n";
+        content << "        " << helper_scope << "requireUtf8(text.begin(), text.size(), \"" << field_name << "\");\n";
+        content << "        " << field_name << ".assign(text.begin(), text.size());\n";
+        content << "    }\n";
+    }
     else
     {
         // Other primitive types (including string)
@@ -582,4 +1266,204 @@ void CppHeaderGenerator::_generate_from_capnp_struct_field(std::ostringstream& c
     }
 }
 
+void CppHeaderGenerator::_generate_json_declarations(std::ostringstream& content, const std::vector<Type>& fields,
+                                                     const std::vector<UnionDecl>& unions)
+{
+    content << "    /// @brief JSON keys of all fields, in the order to_json() writes them.\n";
+    content << "    static constexpr std::array<std::string_view, " << fields.size() + unions.size()
+            << "> _k_json_field_names{";
+    for (std::size_t i = 0; i < fields.size(); ++i)
+    {
+        content << (i == 0 ? "\"" : ", \"") << fields[i].get_field_name() << "\"";
+    }
+    for (std::size_t i = 0; i < unions.size(); ++i)
+    {
+        content << (fields.empty() && i == 0 ? "\"" : ", \"") << unions[i].get_member_name() << "\"";
+    }
+    content << "};\n\n";
+
+    content << "    /// @brief Write all fields as one JSON object.\n";
+    content << "    /// @param writer The writer to append to.\n";
+    content << "    void to_json(JsonWriter& writer) const;\n\n";
+
+    content << "    /// @brief Encode all fields as a JSON object.\n";
+    content << "    /// @return The JSON text.\n";
+    content << "    std::string to_json() const;\n\n";
+
+    content << "    /// @brief Populate fields from the next JSON object; unknown keys are skipped.\n";
+    content << "    /// @param reader The reader positioned at the object.\n";
+    content << "    void from_json(JsonReader& reader);\n\n";
+
+    content << "    /// @brief Populate fields from a JSON document.\n";
+    content << "    /// @param json The JSON text.\n";
+    content << "    /// @return True if parsing succeeded, false otherwise.\n";
+    content << "    bool from_json(std::string_view json);\n";
+}
+
+void CppHeaderGenerator::_generate_json_definitions(std::ostringstream& content, const std::string& class_name,
+                                                    const std::vector<Type>& fields,
+                                                    const std::vector<UnionDecl>& unions)
+{
+    content << "inline void " << class_name << "::to_json(JsonWriter& writer) const\n";
+    content << "{\n";
+    content << "    writer.begin_object();\n";
+    for (std::size_t i = 0; i < fields.size(); ++i)
+    {
+        content << "    writer.key(_k_json_field_names[" << i << "]);\n";
+        content << "    jsonWrite(writer, " << fields[i].get_field_name() << ");\n";
+    }
+    for (std::size_t i = 0; i < unions.size(); ++i)
+    {
+        // A union is an object holding only its active alternative
+        const std::string member = unions[i].get_member_name();
+        content << "    writer.key(_k_json_field_names[" << fields.size() + i << "]);\n";
+        content << "    writer.begin_object();\n";
+        content << "    switch (" << member << ".index())\n";
+        content << "    {\n";
+        for (std::size_t arm = 0; arm < unions[i].arms.size(); ++arm)
+        {
+            content << "        case " << arm << ": writer.key(\"" << unions[i].arms[arm].get_field_name()
+                    << "\"); jsonWrite(writer, std::get<" << arm << ">(" << member << ")); break;\n";
+        }
+        content << "    }\n";
+        content << "    writer.end_object();\n";
+    }
+    content << "    writer.end_object();\n";
+    content << "}\n\n";
+
+    content << "inline std::string " << class_name << "::to_json() const\n";
+    content << "{\n";
+    content << "    std::string json;\n";
+    content << "    JsonWriter writer(json);\n";
+    content << "    to_json(writer);\n";
+    content << "    return json;\n";
+    content << "}\n\n";
+
+    // Keys are matched against the table, trying the next declared field first
+    content << "inline void " << class_name << "::from_json(JsonReader& reader)\n";
+    content << "{\n";
+    content << "    reader.begin_object();\n";
+    content << "    std::size_t hint = 0;\n";
+    content << "    std::string_view key;\n";
+    content << "    while (reader.next_key(key))\n";
+    content << "    {\n";
+    content << "        switch (JsonReader::find_field(_k_json_field_names, key, hint))\n";
+    content << "        {\n";
+    for (std::size_t i = 0; i < fields.size(); ++i)
+    {
+        const std::string& name = fields[i].get_field_name();
+        if (fields[i].has_default_value())
+        {
+            // A null restores the declared default rather than T{}
+            content << "            case " << i << ": if (reader.read_null()) { " << name << " = "
+                    << TypeConverter::get_default_value(fields[i]) << "; } else { jsonRead(reader, " << name
+                    << "); } break;\n";
+            continue;
+        }
+        content << "            case " << i << ": jsonRead(reader, " << name << "); break;\n";
+    }
+    for (std::size_t i = 0; i < unions.size(); ++i)
+    {
+        // Unknown alternatives are skipped; null selects the first alternative
+        const std::string member = unions[i].get_member_name();
+        content << "            case " << fields.size() + i << ":\n";
+        content << "            {\n";
+        content << "                if (reader.read_null())\n";
+        content << "                {\n";
+        content << "                    " << member << ".emplace<0>();\n";
+        content << "                    break;\n";
+        content << "                }\n";
+        content << "                reader.begin_object();\n";
+        content << "                std::string_view arm_key;\n";
+        content << "                while (reader.next_key(arm_key))\n";
+        content << "                {\n";
+        for (std::size_t arm = 0; arm < unions[i].arms.size(); ++arm)
+        {
+            content << "                    " << (arm == 0 ? "if" : "else if") << " (arm_key == \""
+                    << unions[i].arms[arm].get_field_name() << "\") { jsonRead(reader, " << member
+                    << ".emplace<" << arm << ">()); }\n";
+        }
+        content << "                    else { reader.skip_value(); }\n";
+        content << "                }\n";
+        content << "                break;\n";
+        content << "            }\n";
+    }
+    content << "            default: reader.skip_value(); break;\n";
+    content << "        }\n";
+    content << "    }\n";
+    content << "}\n\n";
+
+    content << "inline bool " << class_name << "::from_json(std::string_view json)\n";
+    content << "{\n";
+    content << "    try\n";
+    content << "    {\n";
+    content << "        JsonReader reader(json);\n";
+    content << "        from_json(reader);\n";
+    content << "        reader.finish();\n";
+    content << "        return true;\n";
+    content << "    }\n";
+    content << "    catch (...)\n";
+    content << "    {\n";
+    content << "        return false;\n";
+    content << "    }\n";
+    content << "}\n\n";
+}
+
+void CppHeaderGenerator::_generate_format_declaration(std::ostringstream& content)
+{
+    content << "    /// @brief Format all fields as compact text, e.g. Name{id=1, tags=[\"a\", \"b\"]}.\n";
+    content << "    /// @details Allocation-free; see format_to_buffer() for logging into a fixed buffer.\n";
+    content << "    /// @param out The output iterator.\n";
+    content << "    /// @param limits Truncation limits for long strings and lists.\n";
+    content << "    /// @return The iterator past the last character written.\n";
+    content << "    template<typename OutputIt>\n";
+    content << "    OutputIt format_to(OutputIt out, const FormatLimits& limits = {}) const;\n";
+}
+
+void CppHeaderGenerator::_generate_format_definition(std::ostringstream& content, const std::string& class_name,
+                                                     const std::vector<Type>& fields,
+                                                     const std::vector<UnionDecl>& unions)
+{
+    content << "template<typename OutputIt>\n";
+    content << "OutputIt " << class_name << "::format_to(OutputIt out, const FormatLimits& limits) const\n";
+    content << "{\n";
+    if (fields.empty() && unions.empty())
+    {
+        content << "    (void)limits;\n";
+        content << "    return formatText(out, \"" << class_name << "{}\");\n";
+        content << "}\n\n";
+        return;
+    }
+
+    // Field labels are merged with the punctuation around them
+    for (std::size_t i = 0; i < fields.size(); ++i)
+    {
+        const std::string& field_name = fields[i].get_field_name();
+        const std::string label = (i == 0 ? class_name + "{" : ", ") + field_name + "=";
+        content << "    out = formatText(out, \"" << label << "\");\n";
+        content << "    out = formatValue(out, " << field_name << ", limits);\n";
+    }
+    for (std::size_t i = 0; i < unions.size(); ++i)
+    {
+        // Only the active alternative is printed, e.g. result={errorMessage="..."}
+        const std::string member = unions[i].get_member_name();
+        const std::string label = (fields.empty() && i == 0 ? class_name + "{" : ", ") + member + "={";
+        content << "    out = formatText(out, \"" << label << "\");\n";
+        content << "    switch (" << member << ".index())\n";
+        content << "    {\n";
+        for (std::size_t arm = 0; arm < unions[i].arms.size(); ++arm)
+        {
+            content << "        case " << arm << ":\n";
+            content << "            out = formatText(out, \"" << unions[i].arms[arm].get_field_name() << "=\");\n";
+            content << "            out = formatValue(out, std::get<" << arm << ">(" << member << "), limits);\n";
+            content << "            break;\n";
+        }
+        content << "    }\n";
+        content << "    *out++ = '}';\n";
+    }
+    content << "    *out++ = '}';\n";
+    content << "    return out;\n";
+    content << "}\n\n";
+}
+
 } // namespace curious::dsl::capnpgen
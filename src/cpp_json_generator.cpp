@@ -0,0 +1,992 @@
+#include "cpp_json_generator.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "string_utils.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+// ---- Constructor ----
+
+CppJsonGenerator::CppJsonGenerator(const Schema& schema, const std::string& output_directory, const std::string& include_prefix)
+    : _schema(schema)
+    , _outputDirectory(_resolve_output_directory(output_directory))
+    , _includePrefix(include_prefix)
+{
+    namespace fs = std::filesystem;
+
+    fs::path output_file_path = fs::path(_outputDirectory) / "Json.hpp";
+
+    std::ofstream output_file(output_file_path, std::ios::binary);
+    if (!output_file)
+    {
+        throw std::runtime_error("Failed to create JSON header file: " + output_file_path.string());
+    }
+
+    output_file << _generate_json_content();
+}
+
+// ---- Private static methods ----
+
+std::string CppJsonGenerator::_resolve_output_directory(const std::string& path)
+{
+    namespace fs = std::filesystem;
+    fs::create_directories(path);
+    return path;
+}
+
+std::string CppJsonGenerator::_generate_writer()
+{
+    std::ostringstream content;
+
+    content << "/// @brief Maps an enum to its JSON names; specialized below for every schema enum.\n";
+    content << "template<typename E>\n";
+    content << "struct JsonEnumTraits;\n\n";
+
+    content << "/// @brief Appends compact JSON to a caller-owned string.\n";
+    content << "/// @details Numbers go through std::to_chars and strings are escaped in runs, so writing\n";
+    content << "///          allocates only when the output buffer grows. Reuse the buffer across messages to\n";
+    content << "///          avoid that as well.\n";
+    content << "class JsonWriter\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    /// @brief Append to a buffer (existing content is kept).\n";
+    content << "    /// @param buffer The output buffer; must outlive the writer.\n";
+    content << "    explicit JsonWriter(std::string& buffer) : _buffer(buffer) {}\n\n";
+
+    content << "    /// @brief Start an object.\n";
+    content << "    void begin_object()\n";
+    content << "    {\n";
+    content << "        _separate();\n";
+    content << "        _buffer.push_back('{');\n";
+    content << "        _needsComma = false;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief End an object.\n";
+    content << "    void end_object()\n";
+    content << "    {\n";
+    content << "        _buffer.push_back('}');\n";
+    content << "        _needsComma = true;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Start an array.\n";
+    content << "    void begin_array()\n";
+    content << "    {\n";
+    content << "        _separate();\n";
+    content << "        _buffer.push_back('[');\n";
+    content << "        _needsComma = false;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief End an array.\n";
+    content << "    void end_array()\n";
+    content << "    {\n";
+    content << "        _buffer.push_back(']');\n";
+    content << "        _needsComma = true;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Write an object key.\n";
+    content << "    /// @param name The key, escaped as needed.\n";
+    content << "    void key(std::string_view name)\n";
+    content << "    {\n";
+    content << "        _separate();\n";
+    content << "        _append_quoted(name);\n";
+    content << "        _buffer.push_back(':');\n";
+    content << "        _needsComma = false;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Write null.\n";
+    content << "    void null_value()\n";
+    content << "    {\n";
+    content << "        _separate();\n";
+    content << "        _buffer.append(\"null\", 4);\n";
+    content << "        _needsComma = true;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Write true or false.\n";
+    content << "    void bool_value(bool value)\n";
+    content << "    {\n";
+    content << "        _separate();\n";
+    content << "        if (value)\n";
+    content << "        {\n";
+    content << "            _buffer.append(\"true\", 4);\n";
+    content << "        }\n";
+    content << "        else\n";
+    content << "        {\n";
+    content << "            _buffer.append(\"false\", 5);\n";
+    content << "        }\n";
+    content << "        _needsComma = true;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Write an integer or floating-point number (NaN and infinities become null).\n";
+    content << "    template<typename T>\n";
+    content << "    void number_value(T value)\n";
+    content << "    {\n";
+    content << "        if constexpr (std::is_floating_point_v<T>)\n";
+    content << "        {\n";
+    content << "            if (!std::isfinite(value))\n";
+    content << "            {\n";
+    content << "                null_value();\n";
+    content << "                return;\n";
+    content << "            }\n";
+    content << "        }\n";
+    content << "        _separate();\n";
+    content << "        char digits[32];\n";
+    content << "        const auto result = std::to_chars(digits, digits + sizeof(digits), value);\n";
+    content << "        _buffer.append(digits, static_cast<std::size_t>(result.ptr - digits));\n";
+    content << "        _needsComma = true;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Write a string, escaping quotes, backslashes and control characters.\n";
+    content << "    void string_value(std::string_view value)\n";
+    content << "    {\n";
+    content << "        _separate();\n";
+    content << "        _append_quoted(value);\n";
+    content << "        _needsComma = true;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Write bytes as a base64 string (RFC 4648, padded).\n";
+    content << "    void bytes_value(const std::uint8_t* data, std::size_t size)\n";
+    content << "    {\n";
+    content << "        static constexpr char alphabet[] = \"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/\";\n\n";
+
+    content << "        _separate();\n";
+    content << "        const std::size_t start = _buffer.size();\n";
+    content << "        _buffer.resize(start + 2 + (size + 2) / 3 * 4);\n";
+    content << "        char* out = _buffer.data() + start;\n";
+    content << "        *out++ = '\"';\n";
+    content << "        std::size_t i = 0;\n";
+    content << "        for (; i + 3 <= size; i += 3)\n";
+    content << "        {\n";
+    content << "            const std::uint32_t triple = (std::uint32_t{data[i]} << 16) | (std::uint32_t{data[i + 1]} << 8) | data[i + 2];\n";
+    content << "            *out++ = alphabet[(triple >> 18) & 0x3F];\n";
+    content << "            *out++ = alphabet[(triple >> 12) & 0x3F];\n";
+    content << "            *out++ = alphabet[(triple >> 6) & 0x3F];\n";
+    content << "            *out++ = alphabet[triple & 0x3F];\n";
+    content << "        }\n";
+    content << "        if (i < size)\n";
+    content << "        {\n";
+    content << "            const std::uint32_t triple = (std::uint32_t{data[i]} << 16) | (i + 1 < size ? std::uint32_t{data[i + 1]} << 8 : 0);\n";
+    content << "            *out++ = alphabet[(triple >> 18) & 0x3F];\n";
+    content << "            *out++ = alphabet[(triple >> 12) & 0x3F];\n";
+    content << "            *out++ = i + 1 < size ? alphabet[(triple >> 6) & 0x3F] : '=';\n";
+    content << "            *out++ = '=';\n";
+    content << "        }\n";
+    content << "        *out = '\"';\n";
+    content << "        _needsComma = true;\n";
+    content << "    }\n\n";
+
+    content << "private:\n";
+    content << "    void _separate()\n";
+    content << "    {\n";
+    content << "        if (_needsComma)\n";
+    content << "        {\n";
+    content << "            _buffer.push_back(',');\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    void _append_quoted(std::string_view value)\n";
+    content << "    {\n";
+    content << "        static constexpr char hex[] = \"0123456789abcdef\";\n\n";
+
+    content << "        _buffer.push_back('\"');\n";
+    content << "        std::size_t run_start = 0;\n";
+    content << "        for (std::size_t i = 0; i < value.size(); ++i)\n";
+    content << "        {\n";
+    content << "            const auto c = static_cast<unsigned char>(value[i]);\n";
+    content << "            if (c >= 0x20 && c != '\"' && c != '\\\\')\n";
+    content << "            {\n";
+    content << "                continue;\n";
+    content << "            }\n\n";
+
+    content << "            // Flush the clean run, then the escape\n";
+    content << "            _buffer.append(value.data() + run_start, i - run_start);\n";
+    content << "            run_start = i + 1;\n";
+    content << "            switch (c)\n";
+    content << "            {\n";
+    content << "                case '\"': _buffer.append(\"\\\\\\\"\", 2); break;\n";
+    content << "                case '\\\\': _buffer.append(\"\\\\\\\\\", 2); break;\n";
+    content << "                case '\\n': _buffer.append(\"\\\\n\", 2); break;\n";
+    content << "                case '\\r': _buffer.append(\"\\\\r\", 2); break;\n";
+    content << "                case '\\t': _buffer.append(\"\\\\t\", 2); break;\n";
+    content << "                default:\n";
+    content << "                {\n";
+    content << "                    const char escaped[6] = {'\\\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};\n";
+    content << "                    _buffer.append(escaped, 6);\n";
+    content << "                    break;\n";
+    content << "                }\n";
+    content << "            }\n";
+    content << "        }\n";
+    content << "        _buffer.append(value.data() + run_start, value.size() - run_start);\n";
+    content << "        _buffer.push_back('\"');\n";
+    content << "    }\n\n";
+
+    content << "    std::string& _buffer;\n";
+    content << "    bool         _needsComma = false;\n";
+    content << "};\n";
+
+    return content.str();
+}
+
+std::string CppJsonGenerator::_generate_reader()
+{
+    std::ostringstream content;
+
+    content << "/// @brief Single-pass JSON tokenizer that decodes straight into typed fields.\n";
+    content << "/// @details There is no intermediate DOM: callers pull keys and values in order, and values\n";
+    content << "///          of unknown keys are skipped. Malformed input throws std::runtime_error.\n";
+    content << "class JsonReader\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    /// @brief Read from a buffer; it must outlive the reader.\n";
+    content << "    explicit JsonReader(std::string_view json) : _pos(json.data()), _begin(json.data()), _end(json.data() + json.size()) {}\n\n";
+
+    content << "    /// @brief Consume the opening brace of an object.\n";
+    content << "    void begin_object() { _expect('{'); _first = true; }\n\n";
+
+    content << "    /// @brief Advance to the next key of the current object.\n";
+    content << "    /// @param key Receives the key; valid until the next call.\n";
+    content << "    /// @return False at the closing brace (which is consumed).\n";
+    content << "    bool next_key(std::string_view& key)\n";
+    content << "    {\n";
+    content << "        if (!_next_member('}'))\n";
+    content << "        {\n";
+    content << "            return false;\n";
+    content << "        }\n";
+    content << "        key = _read_string_view();\n";
+    content << "        _expect(':');\n";
+    content << "        return true;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Consume the opening bracket of an array.\n";
+    content << "    void begin_array() { _expect('['); _first = true; }\n\n";
+
+    content << "    /// @brief Advance to the next element of the current array.\n";
+    content << "    /// @return False at the closing bracket (which is consumed).\n";
+    content << "    bool next_element() { return _next_member(']'); }\n\n";
+
+    content << "    /// @brief Consume a null if one is next.\n";
+    content << "    /// @return True if a null was consumed.\n";
+    content << "    bool read_null()\n";
+    content << "    {\n";
+    content << "        _skip_whitespace();\n";
+    content << "        if (_end - _pos >= 4 && std::memcmp(_pos, \"null\", 4) == 0)\n";
+    content << "        {\n";
+    content << "            _pos += 4;\n";
+    content << "            return true;\n";
+    content << "        }\n";
+    content << "        return false;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Check if the next value is a string.\n";
+    content << "    bool next_is_string()\n";
+    content << "    {\n";
+    content << "        _skip_whitespace();\n";
+    content << "        return _pos < _end && *_pos == '\"';\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Read true or false.\n";
+    content << "    bool read_bool()\n";
+    content << "    {\n";
+    content << "        _skip_whitespace();\n";
+    content << "        if (_end - _pos >= 4 && std::memcmp(_pos, \"true\", 4) == 0)\n";
+    content << "        {\n";
+    content << "            _pos += 4;\n";
+    content << "            return true;\n";
+    content << "        }\n";
+    content << "        if (_end - _pos >= 5 && std::memcmp(_pos, \"false\", 5) == 0)\n";
+    content << "        {\n";
+    content << "            _pos += 5;\n";
+    content << "            return false;\n";
+    content << "        }\n";
+    content << "        _fail(\"expected a boolean\");\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Read a number (also accepted as a quoted string, as some encoders write 64-bit values).\n";
+    content << "    template<typename T>\n";
+    content << "    T read_number()\n";
+    content << "    {\n";
+    content << "        _skip_whitespace();\n";
+    content << "        const bool quoted = _pos < _end && *_pos == '\"';\n";
+    content << "        if (quoted)\n";
+    content << "        {\n";
+    content << "            ++_pos;\n";
+    content << "        }\n";
+    content << "        T value{};\n";
+    content << "        const char* start = _pos;\n";
+    content << "        if (start < _end && *start == '+')\n";
+    content << "        {\n";
+    content << "            ++start;\n";
+    content << "        }\n";
+    content << "        const auto result = std::from_chars(start, _end, value);\n";
+    content << "        if (result.ec != std::errc() || result.ptr == start)\n";
+    content << "        {\n";
+    content << "            _fail(\"expected a number\");\n";
+    content << "        }\n";
+    content << "        _pos = result.ptr;\n";
+    content << "        if (quoted)\n";
+    content << "        {\n";
+    content << "            _expect_raw('\"');\n";
+    content << "        }\n";
+    content << "        return value;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Read a string without copying it when it has no escapes.\n";
+    content << "    /// @return The decoded string; valid until the next call.\n";
+    content << "    std::string_view read_string_view() { return _read_string_view(); }\n\n";
+
+    content << "    /// @brief Read a string, decoding escapes and \\\\u sequences into UTF-8.\n";
+    content << "    void read_string(std::string& out)\n";
+    content << "    {\n";
+    content << "        const std::string_view value = _read_string_view();\n";
+    content << "        out.assign(value.data(), value.size());\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Read a base64 string into bytes (padding optional).\n";
+    content << "    void read_bytes(std::vector<std::uint8_t>& out)\n";
+    content << "    {\n";
+    content << "        static constexpr auto table = []\n";
+    content << "        {\n";
+    content << "            std::array<std::int8_t, 256> values{};\n";
+    content << "            values.fill(-1);\n";
+    content << "            for (int i = 0; i < 26; ++i)\n";
+    content << "            {\n";
+    content << "                values['A' + i] = static_cast<std::int8_t>(i);\n";
+    content << "                values['a' + i] = static_cast<std::int8_t>(26 + i);\n";
+    content << "            }\n";
+    content << "            for (int i = 0; i < 10; ++i)\n";
+    content << "            {\n";
+    content << "                values['0' + i] = static_cast<std::int8_t>(52 + i);\n";
+    content << "            }\n";
+    content << "            values['+'] = 62;\n";
+    content << "            values['/'] = 63;\n";
+    content << "            values['-'] = 62; // URL-safe alphabet\n";
+    content << "            values['_'] = 63;\n";
+    content << "            return values;\n";
+    content << "        }();\n\n";
+
+    content << "        _skip_whitespace();\n";
+    content << "        _expect_raw('\"');\n";
+    content << "        const char* start = _pos;\n";
+    content << "        const char* stop = static_cast<const char*>(std::memchr(start, '\"', static_cast<std::size_t>(_end - start)));\n";
+    content << "        if (stop == nullptr)\n";
+    content << "        {\n";
+    content << "            _fail(\"unterminated string\");\n";
+    content << "        }\n";
+    content << "        _pos = stop + 1;\n";
+    content << "        while (stop > start && stop[-1] == '=')\n";
+    content << "        {\n";
+    content << "            --stop;\n";
+    content << "        }\n\n";
+
+    content << "        out.clear();\n";
+    content << "        out.reserve(static_cast<std::size_t>(stop - start) * 3 / 4);\n";
+    content << "        std::uint32_t bits = 0;\n";
+    content << "        int bit_count = 0;\n";
+    content << "        for (const char* p = start; p < stop; ++p)\n";
+    content << "        {\n";
+    content << "            const std::int8_t sextet = table[static_cast<unsigned char>(*p)];\n";
+    content << "            if (sextet < 0)\n";
+    content << "            {\n";
+    content << "                _pos = p;\n";
+    content << "                _fail(\"invalid base64\");\n";
+    content << "            }\n";
+    content << "            bits = (bits << 6) | static_cast<std::uint32_t>(sextet);\n";
+    content << "            bit_count += 6;\n";
+    content << "            if (bit_count >= 8)\n";
+    content << "            {\n";
+    content << "                bit_count -= 8;\n";
+    content << "                out.push_back(static_cast<std::uint8_t>(bits >> bit_count));\n";
+    content << "            }\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Skip the next value of any type.\n";
+    content << "    void skip_value()\n";
+    content << "    {\n";
+    content << "        _skip_whitespace();\n";
+    content << "        if (_pos >= _end)\n";
+    content << "        {\n";
+    content << "            _fail(\"unexpected end of input\");\n";
+    content << "        }\n";
+    content << "        switch (*_pos)\n";
+    content << "        {\n";
+    content << "            case '\"':\n";
+    content << "                _read_string_view();\n";
+    content << "                return;\n";
+    content << "            case '{':\n";
+    content << "            {\n";
+    content << "                begin_object();\n";
+    content << "                std::string_view key;\n";
+    content << "                while (next_key(key))\n";
+    content << "                {\n";
+    content << "                    skip_value();\n";
+    content << "                }\n";
+    content << "                return;\n";
+    content << "            }\n";
+    content << "            case '[':\n";
+    content << "                begin_array();\n";
+    content << "                while (next_element())\n";
+    content << "                {\n";
+    content << "                    skip_value();\n";
+    content << "                }\n";
+    content << "                return;\n";
+    content << "            case 't':\n";
+    content << "            case 'f':\n";
+    content << "                read_bool();\n";
+    content << "                return;\n";
+    content << "            case 'n':\n";
+    content << "                if (!read_null())\n";
+    content << "                {\n";
+    content << "                    _fail(\"expected null\");\n";
+    content << "                }\n";
+    content << "                return;\n";
+    content << "            default:\n";
+    content << "                read_number<double>();\n";
+    content << "                return;\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Check that only whitespace is left.\n";
+    content << "    void finish()\n";
+    content << "    {\n";
+    content << "        _skip_whitespace();\n";
+    content << "        if (_pos != _end)\n";
+    content << "        {\n";
+    content << "            _fail(\"trailing characters\");\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Find a key in a compile-time field-name table.\n";
+    content << "    /// @param names The field names in declaration order.\n";
+    content << "    /// @param key The key to look up.\n";
+    content << "    /// @param hint The index expected next; updated on a match so in-order input hits first try.\n";
+    content << "    /// @return The field index, or -1 for an unknown key.\n";
+    content << "    template<std::size_t N>\n";
+    content << "    static int find_field(const std::array<std::string_view, N>& names, std::string_view key, std::size_t& hint)\n";
+    content << "    {\n";
+    content << "        if (hint < N && names[hint] == key)\n";
+    content << "        {\n";
+    content << "            return static_cast<int>(hint++);\n";
+    content << "        }\n";
+    content << "        for (std::size_t i = 0; i < N; ++i)\n";
+    content << "        {\n";
+    content << "            if (names[i] == key)\n";
+    content << "            {\n";
+    content << "                hint = i + 1;\n";
+    content << "                return static_cast<int>(i);\n";
+    content << "            }\n";
+    content << "        }\n";
+    content << "        return -1;\n";
+    content << "    }\n\n";
+
+    content << "private:\n";
+    content << "    [[noreturn]] void _fail(const char* what) const\n";
+    content << "    {\n";
+    content << "        throw std::runtime_error(std::string(\"JSON parse error at offset \") +\n";
+    content << "                                 std::to_string(_pos - _begin) + \": \" + what);\n";
+    content << "    }\n\n";
+
+    content << "    void _skip_whitespace()\n";
+    content << "    {\n";
+    content << "        while (_pos < _end && (*_pos == ' ' || *_pos == '\\n' || *_pos == '\\r' || *_pos == '\\t'))\n";
+    content << "        {\n";
+    content << "            ++_pos;\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    void _expect_raw(char c)\n";
+    content << "    {\n";
+    content << "        if (_pos >= _end || *_pos != c)\n";
+    content << "        {\n";
+    content << "            _fail(\"unexpected character\");\n";
+    content << "        }\n";
+    content << "        ++_pos;\n";
+    content << "    }\n\n";
+
+    content << "    void _expect(char c)\n";
+    content << "    {\n";
+    content << "        _skip_whitespace();\n";
+    content << "        _expect_raw(c);\n";
+    content << "    }\n\n";
+
+    content << "    bool _next_member(char close)\n";
+    content << "    {\n";
+    content << "        _skip_whitespace();\n";
+    content << "        if (_pos < _end && *_pos == close)\n";
+    content << "        {\n";
+    content << "            ++_pos;\n";
+    content << "            _first = false;\n";
+    content << "            return false;\n";
+    content << "        }\n";
+    content << "        if (!_first)\n";
+    content << "        {\n";
+    content << "            _expect_raw(',');\n";
+    content << "        }\n";
+    content << "        _first = false;\n";
+    content << "        return true;\n";
+    content << "    }\n\n";
+
+    content << "    std::string_view _read_string_view()\n";
+    content << "    {\n";
+    content << "        _expect('\"');\n";
+    content << "        const char* start = _pos;\n";
+    content << "        while (_pos < _end && *_pos != '\"' && *_pos != '\\\\')\n";
+    content << "        {\n";
+    content << "            ++_pos;\n";
+    content << "        }\n";
+    content << "        if (_pos >= _end)\n";
+    content << "        {\n";
+    content << "            _fail(\"unterminated string\");\n";
+    content << "        }\n";
+    content << "        if (*_pos == '\"')\n";
+    content << "        {\n";
+    content << "            // No escapes: point into the input\n";
+    content << "            return std::string_view(start, static_cast<std::size_t>(_pos++ - start));\n";
+    content << "        }\n\n";
+
+    content << "        _scratch.assign(start, static_cast<std::size_t>(_pos - start));\n";
+    content << "        while (_pos < _end && *_pos != '\"')\n";
+    content << "        {\n";
+    content << "            if (*_pos != '\\\\')\n";
+    content << "            {\n";
+    content << "                _scratch.push_back(*_pos++);\n";
+    content << "                continue;\n";
+    content << "            }\n";
+    content << "            if (++_pos >= _end)\n";
+    content << "            {\n";
+    content << "                break;\n";
+    content << "            }\n";
+    content << "            switch (*_pos++)\n";
+    content << "            {\n";
+    content << "                case '\"': _scratch.push_back('\"'); break;\n";
+    content << "                case '\\\\': _scratch.push_back('\\\\'); break;\n";
+    content << "                case '/': _scratch.push_back('/'); break;\n";
+    content << "                case 'b': _scratch.push_back('\\b'); break;\n";
+    content << "                case 'f': _scratch.push_back('\\f'); break;\n";
+    content << "                case 'n': _scratch.push_back('\\n'); break;\n";
+    content << "                case 'r': _scratch.push_back('\\r'); break;\n";
+    content << "                case 't': _scratch.push_back('\\t'); break;\n";
+    content << "                case 'u': _append_code_point(); break;\n";
+    content << "                default: _fail(\"invalid escape\");\n";
+    content << "            }\n";
+    content << "        }\n";
+    content << "        _expect_raw('\"');\n";
+    content << "        return _scratch;\n";
+    content << "    }\n\n";
+
+    content << "    std::uint32_t _read_hex4()\n";
+    content << "    {\n";
+    content << "        if (_end - _pos < 4)\n";
+    content << "        {\n";
+    content << "            _fail(\"truncated \\\\u escape\");\n";
+    content << "        }\n";
+    content << "        std::uint32_t value = 0;\n";
+    content << "        const auto result = std::from_chars(_pos, _pos + 4, value, 16);\n";
+    content << "        if (result.ptr != _pos + 4)\n";
+    content << "        {\n";
+    content << "            _fail(\"invalid \\\\u escape\");\n";
+    content << "        }\n";
+    content << "        _pos += 4;\n";
+    content << "        return value;\n";
+    content << "    }\n\n";
+
+    content << "    void _append_code_point()\n";
+    content << "    {\n";
+    content << "        std::uint32_t code_point = _read_hex4();\n";
+    content << "        if (code_point >= 0xD800 && code_point <= 0xDBFF && _end - _pos >= 6 && _pos[0] == '\\\\' && _pos[1] == 'u')\n";
+    content << "        {\n";
+    content << "            // Surrogate pair\n";
+    content << "            _pos += 2;\n";
+    content << "            const std::uint32_t low = _read_hex4();\n";
+    content << "            if (low < 0xDC00 || low > 0xDFFF)\n";
+    content << "            {\n";
+    content << "                _fail(\"invalid surrogate pair\");\n";
+    content << "            }\n";
+    content << "            code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);\n";
+    content << "        }\n";
+    content << "        if (code_point < 0x80)\n";
+    content << "        {\n";
+    content << "            _scratch.push_back(static_cast<char>(code_point));\n";
+    content << "        }\n";
+    content << "        else if (code_point < 0x800)\n";
+    content << "        {\n";
+    content << "            _scratch.push_back(static_cast<char>(0xC0 | (code_point >> 6)));\n";
+    content << "            _scratch.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));\n";
+    content << "        }\n";
+    content << "        else if (code_point < 0x10000)\n";
+    content << "        {\n";
+    content << "            _scratch.push_back(static_cast<char>(0xE0 | (code_point >> 12)));\n";
+    content << "            _scratch.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));\n";
+    content << "            _scratch.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));\n";
+    content << "        }\n";
+    content << "        else\n";
+    content << "        {\n";
+    content << "            _scratch.push_back(static_cast<char>(0xF0 | (code_point >> 18)));\n";
+    content << "            _scratch.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));\n";
+    content << "            _scratch.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));\n";
+    content << "            _scratch.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    const char* _pos;\n";
+    content << "    const char* _begin;\n";
+    content << "    const char* _end;\n";
+    content << "    bool        _first = false;\n";
+    content << "    std::string _scratch;\n";
+    content << "};\n";
+
+    return content.str();
+}
+
+std::string CppJsonGenerator::_generate_field_codecs()
+{
+    std::ostringstream content;
+
+    content << "template<typename T>\n";
+    content << "struct IsJsonVector : std::false_type {};\n\n";
+
+    content << "template<typename T>\n";
+    content << "struct IsJsonVector<std::vector<T>> : std::true_type {};\n\n";
+
+    content << "template<typename T>\n";
+    content << "struct IsJsonMap : std::false_type {};\n\n";
+
+    content << "template<typename K, typename V>\n";
+    content << "struct IsJsonMap<std::unordered_map<K, V>> : std::true_type {};\n\n";
+
+    content << "template<typename T>\n";
+    content << "struct IsJsonShared : std::false_type {};\n\n";
+
+    content << "template<typename T>\n";
+    content << "struct IsJsonShared<SharedField<T>> : std::true_type {};\n\n";
+
+    content << "template<typename T>\n";
+    content << "struct IsJsonOptional : std::false_type {};\n\n";
+
+    content << "template<typename T>\n";
+    content << "struct IsJsonOptional<std::optional<T>> : std::true_type {};\n\n";
+
+    content << "/// @brief Look up an enum value by its JSON name.\n";
+    content << "/// @throws std::runtime_error if the name is unknown.\n";
+    content << "template<typename E>\n";
+    content << "E jsonParseEnum(std::string_view name)\n";
+    content << "{\n";
+    content << "    for (const auto& [value_name, value] : JsonEnumTraits<E>::_k_values)\n";
+    content << "    {\n";
+    content << "        if (value_name == name)\n";
+    content << "        {\n";
+    content << "            return value;\n";
+    content << "        }\n";
+    content << "    }\n";
+    content << "    throw std::runtime_error(\"JSON parse error: unknown enum value '\" + std::string(name) + \"'\");\n";
+    content << "}\n\n";
+
+    content << "/// @brief Write a map key: strings as-is, enums by name, numbers in decimal.\n";
+    content << "template<typename K>\n";
+    content << "void jsonWriteKey(JsonWriter& writer, const K& key)\n";
+    content << "{\n";
+    content << "    if constexpr (std::is_same_v<K, std::string>)\n";
+    content << "    {\n";
+    content << "        writer.key(key);\n";
+    content << "    }\n";
+    content << "    else if constexpr (std::is_same_v<K, bool>)\n";
+    content << "    {\n";
+    content << "        writer.key(key ? \"true\" : \"false\");\n";
+    content << "    }\n";
+    content << "    else if constexpr (std::is_enum_v<K>)\n";
+    content << "    {\n";
+    content << "        writer.key(JsonEnumTraits<K>::name(key));\n";
+    content << "    }\n";
+    content << "    else\n";
+    content << "    {\n";
+    content << "        char digits[32];\n";
+    content << "        const auto result = std::to_chars(digits, digits + sizeof(digits), key);\n";
+    content << "        writer.key(std::string_view(digits, static_cast<std::size_t>(result.ptr - digits)));\n";
+    content << "    }\n";
+    content << "}\n\n";
+
+    content << "/// @brief Parse a map key written by jsonWriteKey().\n";
+    content << "template<typename K>\n";
+    content << "K jsonParseKey(std::string_view key)\n";
+    content << "{\n";
+    content << "    if constexpr (std::is_same_v<K, std::string>)\n";
+    content << "    {\n";
+    content << "        return K(key);\n";
+    content << "    }\n";
+    content << "    else if constexpr (std::is_same_v<K, bool>)\n";
+    content << "    {\n";
+    content << "        return key == \"true\";\n";
+    content << "    }\n";
+    content << "    else if constexpr (std::is_enum_v<K>)\n";
+    content << "    {\n";
+    content << "        return jsonParseEnum<K>(key);\n";
+    content << "    }\n";
+    content << "    else\n";
+    content << "    {\n";
+    content << "        K value{};\n";
+    content << "        const auto result = std::from_chars(key.data(), key.data() + key.size(), value);\n";
+    content << "        if (result.ec != std::errc() || result.ptr != key.data() + key.size())\n";
+    content << "        {\n";
+    content << "            throw std::runtime_error(\"JSON parse error: invalid map key '\" + std::string(key) + \"'\");\n";
+    content << "        }\n";
+    content << "        return value;\n";
+    content << "    }\n";
+    content << "}\n\n";
+
+    content << "/// @brief Write any generated field type as JSON.\n";
+    content << "/// @details Dispatches at compile time: scalars, enums (by name), strings, bytes (base64), lists,\n";
+    content << "///          maps (objects), shared fields, optional fields (null when unset), and messages or value\n";
+    content << "///          types (their to_json()).\n";
+    content << "template<typename T>\n";
+    content << "void jsonWrite(JsonWriter& writer, const T& value)\n";
+    content << "{\n";
+    content << "    if constexpr (std::is_same_v<T, bool>)\n";
+    content << "    {\n";
+    content << "        writer.bool_value(value);\n";
+    content << "    }\n";
+    content << "    else if constexpr (std::is_enum_v<T>)\n";
+    content << "    {\n";
+    content << "        const std::string_view name = JsonEnumTraits<T>::name(value);\n";
+    content << "        if (name.empty())\n";
+    content << "        {\n";
+    content << "            writer.number_value(static_cast<std::int64_t>(value));\n";
+    content << "        }\n";
+    content << "        else\n";
+    content << "        {\n";
+    content << "            writer.string_value(name);\n";
+    content << "        }\n";
+    content << "    }\n";
+    content << "    else if constexpr (std::is_arithmetic_v<T>)\n";
+    content << "    {\n";
+    content << "        writer.number_value(value);\n";
+    content << "    }\n";
+    content << "    else if constexpr (std::is_same_v<T, std::string>)\n";
+    content << "    {\n";
+    content << "        writer.string_value(value);\n";
+    content << "    }\n";
+    content << "    else if constexpr (std::is_same_v<T, std::vector<std::uint8_t>>)\n";
+    content << "    {\n";
+    content << "        writer.bytes_value(value.data(), value.size());\n";
+    content << "    }\n";
+    content << "    else if constexpr (IsJsonVector<T>::value)\n";
+    content << "    {\n";
+    content << "        writer.begin_array();\n";
+    content << "        for (const auto& element : value)\n";
+    content << "        {\n";
+    content << "            jsonWrite(writer, element);\n";
+    content << "        }\n";
+    content << "        writer.end_array();\n";
+    content << "    }\n";
+    content << "    else if constexpr (IsJsonMap<T>::value)\n";
+    content << "    {\n";
+    content << "        writer.begin_object();\n";
+    content << "        for (const auto& [key, element] : value)\n";
+    content << "        {\n";
+    content << "            jsonWriteKey(writer, key);\n";
+    content << "            jsonWrite(writer, element);\n";
+    content << "        }\n";
+    content << "        writer.end_object();\n";
+    content << "    }\n";
+    content << "    else if constexpr (IsJsonShared<T>::value)\n";
+    content << "    {\n";
+    content << "        jsonWrite(writer, value.get());\n";
+    content << "    }\n";
+    content << "    else if constexpr (IsJsonOptional<T>::value)\n";
+    content << "    {\n";
+    content << "        if (value)\n";
+    content << "        {\n";
+    content << "            jsonWrite(writer, *value);\n";
+    content << "        }\n";
+    content << "        else\n";
+    content << "        {\n";
+    content << "            writer.null_value();\n";
+    content << "        }\n";
+    content << "    }\n";
+    content << "    else\n";
+    content << "    {\n";
+    content << "        value.to_json(writer);\n";
+    content << "    }\n";
+    content << "}\n\n";
+
+    content << "/// @brief Read any generated field type from JSON; the mirror of jsonWrite().\n";
+    content << "/// @details A null leaves the field at its default value, which unsets an optional field.\n";
+    content << "template<typename T>\n";
+    content << "void jsonRead(JsonReader& reader, T& value)\n";
+    content << "{\n";
+    content << "    if (reader.read_null())\n";
+    content << "    {\n";
+    content << "        value = T{};\n";
+    content << "        return;\n";
+    content << "    }\n\n";
+
+    content << "    if constexpr (std::is_same_v<T, bool>)\n";
+    content << "    {\n";
+    content << "        value = reader.read_bool();\n";
+    content << "    }\n";
+    content << "    else if constexpr (std::is_enum_v<T>)\n";
+    content << "    {\n";
+    content << "        if (reader.next_is_string())\n";
+    content << "        {\n";
+    content << "            value = jsonParseEnum<T>(reader.read_string_view());\n";
+    content << "        }\n";
+    content << "        else\n";
+    content << "        {\n";
+    content << "            value = static_cast<T>(reader.read_number<std::int64_t>());\n";
+    content << "        }\n";
+    content << "    }\n";
+    content << "    else if constexpr (std::is_arithmetic_v<T>)\n";
+    content << "    {\n";
+    content << "        value = reader.read_number<T>();\n";
+    content << "    }\n";
+    content << "    else if constexpr (std::is_same_v<T, std::string>)\n";
+    content << "    {\n";
+    content << "        reader.read_string(value);\n";
+    content << "    }\n";
+    content << "    else if constexpr (std::is_same_v<T, std::vector<std::uint8_t>>)\n";
+    content << "    {\n";
+    content << "        reader.read_bytes(value);\n";
+    content << "    }\n";
+    content << "    else if constexpr (IsJsonVector<T>::value)\n";
+    content << "    {\n";
+    content << "        value.clear();\n";
+    content << "        reader.begin_array();\n";
+    content << "        while (reader.next_element())\n";
+    content << "        {\n";
+    content << "            jsonRead(reader, value.emplace_back());\n";
+    content << "        }\n";
+    content << "    }\n";
+    content << "    else if constexpr (IsJsonMap<T>::value)\n";
+    content << "    {\n";
+    content << "        using Key = typename T::key_type;\n";
+    content << "        value.clear();\n";
+    content << "        reader.begin_object();\n";
+    content << "        std::string_view key;\n";
+    content << "        while (reader.next_key(key))\n";
+    content << "        {\n";
+    content << "            jsonRead(reader, value[jsonParseKey<Key>(key)]);\n";
+    content << "        }\n";
+    content << "    }\n";
+    content << "    else if constexpr (IsJsonShared<T>::value)\n";
+    content << "    {\n";
+    content << "        jsonRead(reader, value.mutate());\n";
+    content << "    }\n";
+    content << "    else if constexpr (IsJsonOptional<T>::value)\n";
+    content << "    {\n";
+    content << "        jsonRead(reader, value.emplace());\n";
+    content << "    }\n";
+    content << "    else\n";
+    content << "    {\n";
+    content << "        value.from_json(reader);\n";
+    content << "    }\n";
+    content << "}\n";
+
+    return content.str();
+}
+
+std::string CppJsonGenerator::_generate_enum_traits(const EnumDecl& enum_decl)
+{
+    std::ostringstream content;
+    const std::string& name = enum_decl.name;
+
+    content << "/// @brief JSON names of " << name << ".\n";
+    content << "template<>\n";
+    content << "struct JsonEnumTraits<" << name << ">\n";
+    content << "{\n";
+    content << "    static constexpr std::array<std::pair<std::string_view, " << name << ">, "
+            << enum_decl.values.size() << "> _k_values{{\n";
+    for (const auto& value : enum_decl.values)
+    {
+        content << "        {\"" << value.name << "\", " << name << "::" << value.name << "},\n";
+    }
+    content << "    }};\n\n";
+
+    content << "    /// @brief Get the JSON name of a value (empty if it has none).\n";
+    content << "    static constexpr std::string_view name(" << name << " value)\n";
+    content << "    {\n";
+    content << "        switch (value)\n";
+    content << "        {\n";
+    for (const auto& value : enum_decl.values)
+    {
+        content << "            case " << name << "::" << value.name << ": return \"" << value.name << "\";\n";
+    }
+    content << "            default: return {};\n";
+    content << "        }\n";
+    content << "    }\n";
+    content << "};\n\n";
+
+    return content.str();
+}
+
+// ---- Private instance methods ----
+
+std::string CppJsonGenerator::_generate_json_content() const
+{
+    std::ostringstream content;
+
+    // Use wrapper_namespace_name if specified, otherwise fall back to namespace_name
+    const std::string& raw_ns = _schema.wrapper_namespace_name.empty() ?
+                                  _schema.namespace_name : _schema.wrapper_namespace_name;
+    const std::string ns = raw_ns.empty() ?
+                             "curious::net" :
+                             string_utils::to_cpp_namespace(raw_ns);
+
+    content << "#pragma once\n\n";
+    content << "#ifndef JSON_HPP\n";
+    content << "#define JSON_HPP\n\n";
+
+    // Includes
+    content << "#include <array>\n";
+    content << "#include <charconv>\n";
+    content << "#include <cmath>\n";
+    content << "#include <cstddef>\n";
+    content << "#include <cstdint>\n";
+    content << "#include <cstring>\n";
+    content << "#include <optional>\n";
+    content << "#include <stdexcept>\n";
+    content << "#include <string>\n";
+    content << "#include <string_view>\n";
+    content << "#include <type_traits>\n";
+    content << "#include <unordered_map>\n";
+    content << "#include <utility>\n";
+    content << "#include <vector>\n\n";
+    content << "#include <" << _includePrefix << "MessageBase.hpp>\n";
+    content << "#include <" << _includePrefix << "enums.hpp>\n\n";
+
+    // Open namespace
+    content << "namespace " << ns << "\n";
+    content << "{\n\n";
+
+    content << _generate_writer();
+    content << _generate_reader();
+    content << _generate_field_codecs();
+
+    // Enum name tables, in the same order as enums.hpp
+    std::vector<std::string> enum_names;
+    for (const auto& [name, enum_decl] : _schema.enums)
+    {
+        enum_names.push_back(name);
+    }
+    std::sort(enum_names.begin(), enum_names.end());
+
+    content << "// ---- Enum Name Tables ----\n\n";
+    for (const auto& name : enum_names)
+    {
+        content << _generate_enum_traits(_schema.enums.at(name));
+    }
+
+    // Close namespace
+    content << "} // namespace " << ns << "\n\n";
+
+    // Close header guard
+    content << "#endif // JSON_HPP\n";
+
+    return content.str();
+}
+
+} // namespace curious::dsl::capnpgen
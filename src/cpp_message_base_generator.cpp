@@ -46,6 +46,822 @@ std::string CppMessageBaseGenerator::_resolve_output_directory(const std::string
 
 // ---- Private instance methods ----
 
+std::string CppMessageBaseGenerator::_generate_list_copy_helpers()
+{
+    std::ostringstream content;
+
+    content << "    /// @brief Copy a fixed-width primitive vector into a Cap'n Proto list builder.\n";
+    content << "    /// @details On little-endian hosts the wire layout is identical to std::vector<T>, so the\n";
+    content << "    ///          whole list is copied with one memcpy; otherwise falls back to set() per element.\n";
+    content << "    /// @note Cap'n Proto exposes raw list bytes only on readers. The reader is used to locate the\n";
+    content << "    ///       builder's elements, which live in the MessageBuilder's writable segment, so writing\n";
+    content << "    ///       through the pointer is well-defined. The size check proves the list is a flat array of\n";
+    content << "    ///       sizeof(T) elements before anything is written.\n";
+    content << "    template<typename T, typename ListBuilder>\n";
+    content << "    static void bulkCopyToList(const std::vector<T>& values, ListBuilder& list_builder)\n";
+    content << "    {\n";
+    content << "        // Bools are bit-packed on the wire; only byte-or-wider primitives share the host layout\n";
+    content << "        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,\n";
+    content << "                      \"bulkCopyToList() requires a fixed-width numeric element type\");\n";
+    content << "        static_assert(std::is_same_v<std::remove_cvref_t<decltype(list_builder[0])>, T>,\n";
+    content << "                      \"list element type must match the vector element type\");\n\n";
+
+    content << "        if constexpr (std::endian::native == std::endian::little)\n";
+    content << "        {\n";
+    content << "            auto raw_bytes = ::capnp::AnyList::Reader(list_builder.asReader()).getRawBytes();\n";
+    content << "            if (!values.empty() && raw_bytes.size() == values.size() * sizeof(T))\n";
+    content << "            {\n";
+    content << "                kj::byte* elements = const_cast<kj::byte*>(raw_bytes.begin());\n";
+    content << "                std::memcpy(elements, values.data(), raw_bytes.size());\n";
+    content << "                return;\n";
+    content << "            }\n";
+    content << "        }\n\n";
+
+    content << "        for (std::size_t i = 0; i < values.size(); ++i)\n";
+    content << "        {\n";
+    content << "            list_builder.set(i, values[i]);\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Copy a Cap'n Proto fixed-width primitive list into a vector.\n";
+    content << "    /// @details Mirror of bulkCopyToList(): one memcpy on little-endian hosts.\n";
+    content << "    template<typename T, typename ListReader>\n";
+    content << "    static void bulkCopyFromList(const ListReader& list_reader, std::vector<T>& values)\n";
+    content << "    {\n";
+    content << "        static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,\n";
+    content << "                      \"bulkCopyFromList() requires a fixed-width numeric element type\");\n";
+    content << "        static_assert(std::is_same_v<std::remove_cvref_t<decltype(list_reader[0])>, T>,\n";
+    content << "                      \"list element type must match the vector element type\");\n\n";
+
+    content << "        values.resize(list_reader.size());\n";
+    content << "        if (values.empty())\n";
+    content << "        {\n";
+    content << "            return;\n";
+    content << "        }\n\n";
+
+    content << "        if constexpr (std::endian::native == std::endian::little)\n";
+    content << "        {\n";
+    content << "            auto raw_bytes = ::capnp::AnyList::Reader(list_reader).getRawBytes();\n";
+    content << "            if (raw_bytes.size() == values.size() * sizeof(T))\n";
+    content << "            {\n";
+    content << "                std::memcpy(values.data(), raw_bytes.begin(), raw_bytes.size());\n";
+    content << "                return;\n";
+    content << "            }\n";
+    content << "        }\n\n";
+
+    content << "        for (std::size_t i = 0; i < values.size(); ++i)\n";
+    content << "        {\n";
+    content << "            values[i] = list_reader[i];\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Decode a Cap'n Proto list into a presized vector, splitting large lists across an executor.\n";
+    content << "    /// @details Lists shorter than _k_parallel_decode_threshold are decoded inline. Larger lists are\n";
+    content << "    ///          cut into contiguous ranges and each range is decoded into its own slots, so no\n";
+    content << "    ///          synchronization is needed beyond the executor's completion barrier.\n";
+    content << "    /// @note Readers are immutable, but the traversal limit counter is shared: size\n";
+    content << "    ///       ReaderOptions::traversalLimitInWords for the whole message.\n";
+    content << "    template<typename T, typename ListReader, typename DecodeElement>\n";
+    content << "    static void parallelDecodeList(const ListReader& list_reader, std::vector<T>& values,\n";
+    content << "                                   ParallelExecutor& executor, DecodeElement decode_element)\n";
+    content << "    {\n";
+    content << "        const std::size_t count = list_reader.size();\n";
+    content << "        values.clear();\n";
+    content << "        values.resize(count);\n\n";
+
+    content << "        if (count < _k_parallel_decode_threshold)\n";
+    content << "        {\n";
+    content << "            for (std::size_t i = 0; i < count; ++i)\n";
+    content << "            {\n";
+    content << "                decode_element(list_reader[i], values[i]);\n";
+    content << "            }\n";
+    content << "            return;\n";
+    content << "        }\n\n";
+
+    content << "        // A few ranges per worker keeps the load balanced when element sizes vary\n";
+    content << "        const std::size_t target_ranges = std::max<std::size_t>(1, executor.concurrency() * 4);\n";
+    content << "        const std::size_t range_size = std::max(_k_parallel_decode_min_range,\n";
+    content << "                                                (count + target_ranges - 1) / target_ranges);\n";
+    content << "        const std::size_t range_count = (count + range_size - 1) / range_size;\n\n";
+
+    content << "        executor.parallel_for(range_count, [&](std::size_t range)\n";
+    content << "        {\n";
+    content << "            const std::size_t begin = range * range_size;\n";
+    content << "            const std::size_t end = std::min(begin + range_size, count);\n";
+    content << "            for (std::size_t i = begin; i < end; ++i)\n";
+    content << "            {\n";
+    content << "                decode_element(list_reader[i], values[i]);\n";
+    content << "            }\n";
+    content << "        });\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Hint the CPU to start loading memory that will be read soon.\n";
+    content << "    static void prefetchRead(const void* address)\n";
+    content << "    {\n";
+    content << "#if defined(__GNUC__) || defined(__clang__)\n";
+    content << "        __builtin_prefetch(address, 0, 3);\n";
+    content << "#else\n";
+    content << "        (void) address;\n";
+    content << "#endif\n";
+    content << "    }\n";
+
+    return content.str();
+}
+
+std::string CppMessageBaseGenerator::_generate_utf8_helpers()
+{
+    std::ostringstream content;
+
+    content << "    /// @brief Check that a byte range is well-formed UTF-8.\n";
+    content << "    /// @details ASCII runs are skipped 32 (AVX2) or 16 (SSE2) bytes per step; multi-byte sequences\n";
+    content << "    ///          are decoded by a scalar path that rejects overlongs, surrogates and code points\n";
+    content << "    ///          above U+10FFFF.\n";
+    content << "    /// @param data Pointer to the bytes.\n";
+    content << "    /// @param size Number of bytes.\n";
+    content << "    /// @return True if the bytes are valid UTF-8.\n";
+    content << "    static bool isValidUtf8(const char* data, std::size_t size)\n";
+    content << "    {\n";
+    content << "        const auto* bytes = reinterpret_cast<const unsigned char*>(data);\n";
+    content << "        std::size_t i = 0;\n";
+    content << "        while (i < size)\n";
+    content << "        {\n";
+    content << "            // Skip ASCII runs a vector at a time\n";
+    content << "#if defined(__AVX2__)\n";
+    content << "            while (i + 32 <= size &&\n";
+    content << "                   _mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i))) == 0)\n";
+    content << "            {\n";
+    content << "                i += 32;\n";
+    content << "            }\n";
+    content << "#endif\n";
+    content << "#if defined(__SSE2__)\n";
+    content << "            while (i + 16 <= size &&\n";
+    content << "                   _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i))) == 0)\n";
+    content << "            {\n";
+    content << "                i += 16;\n";
+    content << "            }\n";
+    content << "#endif\n";
+    content << "            if (i == size)\n";
+    content << "            {\n";
+    content << "                break;\n";
+    content << "            }\n\n";
+
+    content << "            const unsigned char lead = bytes[i];\n";
+    content << "            if (lead < 0x80)\n";
+    content << "            {\n";
+    content << "                ++i;\n";
+    content << "                continue;\n";
+    content << "            }\n\n";
+
+    content << "            // Multi-byte sequence: reject overlongs, surrogates and code points above U+10FFFF\n";
+    content << "            std::size_t length = 0;\n";
+    content << "            if ((lead & 0xE0) == 0xC0)\n";
+    content << "            {\n";
+    content << "                length = 2;\n";
+    content << "            }\n";
+    content << "            else if ((lead & 0xF0) == 0xE0)\n";
+    content << "            {\n";
+    content << "                length = 3;\n";
+    content << "            }\n";
+    content << "            else if ((lead & 0xF8) == 0xF0)\n";
+    content << "            {\n";
+    content << "                length = 4;\n";
+    content << "            }\n";
+    content << "            else\n";
+    content << "            {\n";
+    content << "                return false;\n";
+    content << "            }\n";
+    content << "            if (size - i < length)\n";
+    content << "            {\n";
+    content << "                return false;\n";
+    content << "            }\n\n";
+
+    content << "            std::uint32_t code_point = lead & (0x7Fu >> length);\n";
+    content << "            for (std::size_t k = 1; k < length; ++k)\n";
+    content << "            {\n";
+    content << "                const unsigned char next = bytes[i + k];\n";
+    content << "                if ((next & 0xC0) != 0x80)\n";
+    content << "                {\n";
+    content << "                    return false;\n";
+    content << "                }\n";
+    content << "                code_point = (code_point << 6) | (next & 0x3Fu);\n";
+    content << "            }\n\n";
+
+    content << "            static constexpr std::uint32_t k_min_code_point[] = {0, 0, 0x80, 0x800, 0x10000};\n";
+    content << "            if (code_point < k_min_code_point[length] || code_point > 0x10FFFF ||\n";
+    content << "                (code_point >= 0xD800 && code_point <= 0xDFFF))\n";
+    content << "            {\n";
+    content << "                return false;\n";
+    content << "            }\n";
+    content << "            i += length;\n";
+    content << "        }\n";
+    content << "        return true;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Throw if a decoded Text field is not valid UTF-8 (emitted by --validate-utf8).\n";
+    content << "    /// @param data Pointer to the text bytes.\n";
+    content << "    /// @param size Number of bytes.\n";
+    content << "    /// @param field_name Field name for the error message.\n";
+    content << "    /// @throws std::runtime_error on invalid input, which deserialize() reports as a failed decode.\n";
+    content << "    static void requireUtf8(const char* data, std::size_t size, const char* field_name)\n";
+    content << "    {\n";
+    content << "        if (!isValidUtf8(data, size))\n";
+    content << "        {\n";
+    content << "            throw std::runtime_error(std::string(\"Invalid UTF-8 in field '\") + field_name + \"'\");\n";
+    content << "        }\n";
+    content << "    }\n";
+
+    return content.str();
+}
+
+std::string CppMessageBaseGenerator::_generate_parallel_executors()
+{
+    std::ostringstream content;
+
+    content << "/// @brief Runs independent decode tasks for from_capnp_parallel().\n";
+    content << "/// @details Implement this to plug in an application thread pool.\n";
+    content << "class ParallelExecutor\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    virtual ~ParallelExecutor() = default;\n\n";
+
+    content << "    /// @brief Call body(0) .. body(count - 1), possibly concurrently.\n";
+    content << "    /// @param count Number of tasks.\n";
+    content << "    /// @param body Task body; receives the task index.\n";
+    content << "    /// @note Must not return before every call has finished.\n";
+    content << "    virtual void parallel_for(std::size_t count, const std::function<void(std::size_t)>& body) = 0;\n\n";
+
+    content << "    /// @brief Get the number of tasks that can usefully run at once.\n";
+    content << "    virtual std::size_t concurrency() const = 0;\n";
+    content << "};\n\n";
+
+    content << "/// @brief Executor that runs every task on the calling thread.\n";
+    content << "/// @details Used by from_capnp(), so serial and parallel decoding share one code path.\n";
+    content << "class InlineExecutor final : public ParallelExecutor\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    void parallel_for(std::size_t count, const std::function<void(std::size_t)>& body) override\n";
+    content << "    {\n";
+    content << "        for (std::size_t i = 0; i < count; ++i)\n";
+    content << "        {\n";
+    content << "            body(i);\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    std::size_t concurrency() const override { return 1; }\n";
+    content << "};\n\n";
+
+    content << "/// @brief Executor that runs tasks on std::async threads, one per task.\n";
+    content << "/// @details The calling thread runs task 0 itself. Suited to occasional large decodes;\n";
+    content << "///          use a pooled executor for steady traffic.\n";
+    content << "class AsyncExecutor final : public ParallelExecutor\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    void parallel_for(std::size_t count, const std::function<void(std::size_t)>& body) override\n";
+    content << "    {\n";
+    content << "        if (count == 0)\n";
+    content << "        {\n";
+    content << "            return;\n";
+    content << "        }\n\n";
+
+    content << "        std::vector<std::future<void>> futures;\n";
+    content << "        futures.reserve(count - 1);\n";
+    content << "        for (std::size_t i = 1; i < count; ++i)\n";
+    content << "        {\n";
+    content << "            futures.push_back(std::async(std::launch::async, body, i));\n";
+    content << "        }\n\n";
+
+    content << "        body(0);\n";
+    content << "        for (auto& future : futures)\n";
+    content << "        {\n";
+    content << "            future.get();\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    std::size_t concurrency() const override\n";
+    content << "    {\n";
+    content << "        return std::max(1u, std::thread::hardware_concurrency());\n";
+    content << "    }\n";
+    content << "};\n\n";
+
+    return content.str();
+}
+
+std::string CppMessageBaseGenerator::_generate_field_mask()
+{
+    std::ostringstream content;
+
+    content << "/// @brief Selects which fields a masked deserialize() decodes.\n";
+    content << "/// @details Names are DSL field names (inherited fields included). A nested mask narrows a\n";
+    content << "///          message or list-of-message field; without one the field is decoded fully.\n";
+    content << "///          Unselected fields keep their current values and their wire data is never touched.\n";
+    content << "class FieldMask\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    FieldMask() = default;\n\n";
+
+    content << "    /// @brief Select top-level fields.\n";
+    content << "    FieldMask(std::initializer_list<std::string> fields)\n";
+    content << "    {\n";
+    content << "        for (const auto& field : fields)\n";
+    content << "        {\n";
+    content << "            include(field);\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Select a field (decoded fully).\n";
+    content << "    FieldMask& include(std::string field)\n";
+    content << "    {\n";
+    content << "        _fields[std::move(field)] = nullptr;\n";
+    content << "        return *this;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Select a nested message or list-of-message field, decoding only the nested selection.\n";
+    content << "    FieldMask& include(std::string field, FieldMask nested)\n";
+    content << "    {\n";
+    content << "        _fields[std::move(field)] = std::make_shared<const FieldMask>(std::move(nested));\n";
+    content << "        return *this;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Check whether a field is selected.\n";
+    content << "    bool contains(std::string_view field) const { return _fields.find(field) != _fields.end(); }\n\n";
+
+    content << "    /// @brief Get the nested selection of a field, or nullptr to decode it fully.\n";
+    content << "    const FieldMask* nested(std::string_view field) const\n";
+    content << "    {\n";
+    content << "        auto it = _fields.find(field);\n";
+    content << "        return it != _fields.end() ? it->second.get() : nullptr;\n";
+    content << "    }\n\n";
+
+    content << "private:\n";
+    content << "    std::map<std::string, std::shared_ptr<const FieldMask>, std::less<>> _fields;\n";
+    content << "};\n\n";
+
+    return content.str();
+}
+
+std::string CppMessageBaseGenerator::_generate_list_appender()
+{
+    std::ostringstream content;
+
+    content << "/// @brief Appends to a Cap'n Proto list held as an orphan, growing it geometrically.\n";
+    content << "/// @details Elements are written straight into the message arena. Growing past the capacity\n";
+    content << "///          truncates the orphan to a larger size, which reallocates and copies the list\n";
+    content << "///          (the old space stays in the arena, zeroed), so a good capacity hint avoids it.\n";
+    content << "///          finish() trims the list to its size for adoption into the parent struct.\n";
+    content << "/// @tparam ListType The Cap'n Proto list type (e.g., ::capnp::List<::capnp::Text>).\n";
+    content << "template<typename ListType>\n";
+    content << "class ListAppender\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    /// @brief Start an empty list.\n";
+    content << "    /// @param orphanage The orphanage of the message being built.\n";
+    content << "    /// @param capacity_hint Number of elements to allocate up front.\n";
+    content << "    ListAppender(::capnp::Orphanage orphanage, unsigned capacity_hint)\n";
+    content << "        : _orphan(orphanage.newOrphan<ListType>(std::max(capacity_hint, 1u)))\n";
+    content << "        , _list(_orphan.get())\n";
+    content << "        , _capacity(std::max(capacity_hint, 1u))\n";
+    content << "    {\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Continue appending to a list disowned from its parent struct.\n";
+    content << "    /// @param orphan The existing list.\n";
+    content << "    explicit ListAppender(::capnp::Orphan<ListType>&& orphan)\n";
+    content << "        : _orphan(kj::mv(orphan))\n";
+    content << "        , _list(_orphan.get())\n";
+    content << "        , _size(_list.size())\n";
+    content << "        , _capacity(_list.size())\n";
+    content << "    {\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Append a value (primitive, enum, Text or Data element).\n";
+    content << "    /// @param value The value to store.\n";
+    content << "    template<typename Value>\n";
+    content << "    void append(Value&& value)\n";
+    content << "    {\n";
+    content << "        _ensure_capacity(_size + 1);\n";
+    content << "        _list.set(_size++, std::forward<Value>(value));\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Append a struct element and return its builder.\n";
+    content << "    /// @return Builder for the new element, valid until the next append or reserve.\n";
+    content << "    auto append()\n";
+    content << "    {\n";
+    content << "        _ensure_capacity(_size + 1);\n";
+    content << "        return _list[_size++];\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Allocate room for at least the given number of elements.\n";
+    content << "    /// @param capacity The element count to allocate.\n";
+    content << "    void reserve(unsigned capacity)\n";
+    content << "    {\n";
+    content << "        if (capacity > _capacity)\n";
+    content << "        {\n";
+    content << "            _orphan.truncate(capacity);\n";
+    content << "            _list = _orphan.get();\n";
+    content << "            _capacity = capacity;\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Get the number of appended elements.\n";
+    content << "    unsigned size() const { return _size; }\n\n";
+
+    content << "    /// @brief Trim the list to its size and release it for adoption.\n";
+    content << "    /// @return The list orphan.\n";
+    content << "    ::capnp::Orphan<ListType> finish()\n";
+    content << "    {\n";
+    content << "        if (_capacity != _size)\n";
+    content << "        {\n";
+    content << "            _orphan.truncate(_size);\n";
+    content << "        }\n";
+    content << "        return kj::mv(_orphan);\n";
+    content << "    }\n\n";
+
+    content << "private:\n";
+    content << "    void _ensure_capacity(unsigned required)\n";
+    content << "    {\n";
+    content << "        if (required > _capacity)\n";
+    content << "        {\n";
+    content << "            reserve(std::max(required, _capacity * 2));\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    ::capnp::Orphan<ListType>   _orphan;\n";
+    content << "    typename ListType::Builder _list;\n";
+    content << "    unsigned                   _size = 0;\n";
+    content << "    unsigned                   _capacity = 0;\n";
+    content << "};\n\n";
+
+    return content.str();
+}
+
+std::string CppMessageBaseGenerator::_generate_message_impl()
+{
+    std::ostringstream content;
+
+    content << "/// @brief CRTP base giving templated code non-virtual access to a concrete message.\n";
+    content << "/// @details Leaf messages derive from it when generated with --static-dispatch. Everything\n";
+    content << "///          here is resolved at compile time and encodes through the inline\n";
+    content << "///          to_capnp_struct()/from_capnp_struct() templates, so calls on a known type\n";
+    content << "///          inline fully. The USER_TO_CAPNP/USER_FROM_CAPNP sections of the .cpp are not run.\n";
+    content << "/// @tparam Derived The generated message class.\n";
+    content << "template<typename Derived>\n";
+    content << "class MessageImpl\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    /// @brief Get the message type identifier without a virtual call.\n";
+    content << "    static constexpr std::uint64_t message_id() { return Derived::_k_message_id; }\n\n";
+
+    content << "    /// @brief Get the message type name without a virtual call or allocation.\n";
+    content << "    static constexpr std::string_view message_name() { return Derived::_k_message_name; }\n\n";
+
+    content << "    /// @brief Serialize with statically dispatched field encoding.\n";
+    content << "    /// @return SerializedData containing word-aligned serialized data.\n";
+    content << "    SerializedData encode() const\n";
+    content << "    {\n";
+    content << "        ::capnp::MallocMessageBuilder msg_builder;\n";
+    content << "        _derived().to_capnp_struct(msg_builder.initRoot<typename Derived::CapnpType>());\n";
+    content << "        return SerializedData(capnp::messageToFlatArray(msg_builder));\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Deserialize with statically dispatched field decoding.\n";
+    content << "    /// @param data Pointer to word-aligned serialized data.\n";
+    content << "    /// @param size Size of the data buffer in bytes.\n";
+    content << "    /// @return True if deserialization succeeded, false otherwise.\n";
+    content << "    bool decode(const std::uint8_t* data, std::size_t size)\n";
+    content << "    {\n";
+    content << "        try\n";
+    content << "        {\n";
+    content << "            kj::ArrayPtr<const capnp::word> words(reinterpret_cast<const capnp::word*>(data),\n";
+    content << "                                                  size / sizeof(capnp::word));\n";
+    content << "            ::capnp::FlatArrayMessageReader reader(words);\n";
+    content << "            static_cast<Derived&>(*this).from_capnp_struct(reader.getRoot<typename Derived::CapnpType>());\n";
+    content << "            return true;\n";
+    content << "        }\n";
+    content << "        catch (...)\n";
+    content << "        {\n";
+    content << "            return false;\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "protected:\n";
+    content << "    MessageImpl() = default;\n";
+    content << "    ~MessageImpl() = default;\n\n";
+
+    content << "private:\n";
+    content << "    const Derived& _derived() const { return static_cast<const Derived&>(*this); }\n";
+    content << "};\n\n";
+
+    return content.str();
+}
+
+std::string CppMessageBaseGenerator::_generate_patch_helpers()
+{
+    std::ostringstream content;
+
+    content << "    /// @brief Locate the root struct's data section in a flat-array message.\n";
+    content << "    /// @param data Serialized message (segment table followed by segments).\n";
+    content << "    /// @param size Size of the buffer in bytes.\n";
+    content << "    /// @param data_section_bytes Receives the data section size in bytes.\n";
+    content << "    /// @return Pointer to the data section, or nullptr if the buffer is malformed or the\n";
+    content << "    ///         root is not a plain struct pointer in the first segment.\n";
+    content << "    static std::uint8_t* rootDataSection(std::uint8_t* data, std::size_t size, std::size_t& data_section_bytes)\n";
+    content << "    {\n";
+    content << "        if (data == nullptr || size < 8)\n";
+    content << "        {\n";
+    content << "            return nullptr;\n";
+    content << "        }\n\n";
+
+    content << "        // Segment table: segment count - 1, then one size per segment, padded to a word\n";
+    content << "        const std::uint64_t segment_count = std::uint64_t(readWire<std::uint32_t>(data)) + 1;\n";
+    content << "        const std::uint64_t table_bytes = ((segment_count + 2) / 2) * 8;\n";
+    content << "        if (table_bytes + 8 > size)\n";
+    content << "        {\n";
+    content << "            return nullptr;\n";
+    content << "        }\n\n";
+
+    content << "        std::uint8_t* segment = data + table_bytes;\n";
+    content << "        const std::uint64_t segment_bytes = std::min<std::uint64_t>(std::uint64_t(readWire<std::uint32_t>(data + 4)) * 8,\n";
+    content << "                                                                    size - table_bytes);\n\n";
+
+    content << "        // Root pointer: struct kind (0), signed word offset, data words, pointer count\n";
+    content << "        const std::uint64_t root = readWire<std::uint64_t>(segment);\n";
+    content << "        if (root == 0 || (root & 3) != 0)\n";
+    content << "        {\n";
+    content << "            return nullptr;\n";
+    content << "        }\n\n";
+
+    content << "        const std::int64_t offset_words = static_cast<std::int32_t>(static_cast<std::uint32_t>(root)) >> 2;\n";
+    content << "        const std::uint64_t data_words = (root >> 32) & 0xffffu;\n";
+    content << "        const std::int64_t start = 8 + offset_words * 8;\n";
+    content << "        if (start < 8 || std::uint64_t(start) + data_words * 8 > segment_bytes)\n";
+    content << "        {\n";
+    content << "            return nullptr;\n";
+    content << "        }\n\n";
+
+    content << "        data_section_bytes = data_words * 8;\n";
+    content << "        return segment + start;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Overwrite a numeric or enum field of the root struct in place.\n";
+    content << "    /// @details Cap'n Proto stores value XOR default, little-endian.\n";
+    content << "    /// @return False if the root's data section does not cover the field.\n";
+    content << "    template<typename WireT, typename T>\n";
+    content << "    static bool patchDataField(std::uint8_t* data, std::size_t size, std::size_t byte_offset,\n";
+    content << "                               T value, T default_value)\n";
+    content << "    {\n";
+    content << "        std::size_t data_section_bytes = 0;\n";
+    content << "        std::uint8_t* section = rootDataSection(data, size, data_section_bytes);\n";
+    content << "        if (section == nullptr || byte_offset + sizeof(WireT) > data_section_bytes)\n";
+    content << "        {\n";
+    content << "            return false;\n";
+    content << "        }\n\n";
+
+    content << "        WireT bits = toWireBits<WireT>(value) ^ toWireBits<WireT>(default_value);\n";
+    content << "        writeWire(section + byte_offset, bits);\n";
+    content << "        return true;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Overwrite a Bool field of the root struct in place.\n";
+    content << "    /// @return False if the root's data section does not cover the field.\n";
+    content << "    static bool patchBoolField(std::uint8_t* data, std::size_t size, std::size_t bit_offset,\n";
+    content << "                               bool value, bool default_value)\n";
+    content << "    {\n";
+    content << "        std::size_t data_section_bytes = 0;\n";
+    content << "        std::uint8_t* section = rootDataSection(data, size, data_section_bytes);\n";
+    content << "        if (section == nullptr || bit_offset / 8 >= data_section_bytes)\n";
+    content << "        {\n";
+    content << "            return false;\n";
+    content << "        }\n\n";
+
+    content << "        const std::uint8_t mask = static_cast<std::uint8_t>(1u << (bit_offset % 8));\n";
+    content << "        if (value != default_value)\n";
+    content << "        {\n";
+    content << "            section[bit_offset / 8] |= mask;\n";
+    content << "        }\n";
+    content << "        else\n";
+    content << "        {\n";
+    content << "            section[bit_offset / 8] &= static_cast<std::uint8_t>(~mask);\n";
+    content << "        }\n";
+    content << "        return true;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Reinterpret a value as its unsigned wire representation.\n";
+    content << "    template<typename WireT, typename T>\n";
+    content << "    static WireT toWireBits(T value)\n";
+    content << "    {\n";
+    content << "        if constexpr (std::is_floating_point_v<T>)\n";
+    content << "        {\n";
+    content << "            return std::bit_cast<WireT>(value);\n";
+    content << "        }\n";
+    content << "        else\n";
+    content << "        {\n";
+    content << "            return static_cast<WireT>(value);\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Read a little-endian unsigned value.\n";
+    content << "    template<typename WireT>\n";
+    content << "    static WireT readWire(const std::uint8_t* bytes)\n";
+    content << "    {\n";
+    content << "        WireT value = 0;\n";
+    content << "        for (std::size_t i = 0; i < sizeof(WireT); ++i)\n";
+    content << "        {\n";
+    content << "            value |= static_cast<WireT>(static_cast<WireT>(bytes[i]) << (8 * i));\n";
+    content << "        }\n";
+    content << "        return value;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Write a little-endian unsigned value.\n";
+    content << "    template<typename WireT>\n";
+    content << "    static void writeWire(std::uint8_t* bytes, WireT value)\n";
+    content << "    {\n";
+    content << "        for (std::size_t i = 0; i < sizeof(WireT); ++i)\n";
+    content << "        {\n";
+    content << "            bytes[i] = static_cast<std::uint8_t>(value >> (8 * i));\n";
+    content << "        }\n";
+    content << "    }\n";
+
+    return content.str();
+}
+
+std::string CppMessageBaseGenerator::_generate_shared_field()
+{
+    std::ostringstream content;
+
+    content << "/// @brief Copy-on-write storage for large fields annotated with @shared.\n";
+    content << "/// @details Copies share one immutable value through a refcount; the first mutate()\n";
+    content << "///          on a shared handle clones it. Reads never allocate or copy.\n";
+    content << "/// @tparam T The stored value type (e.g., std::vector<YoutubeVideo>).\n";
+    content << "template<typename T>\n";
+    content << "class SharedField\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    SharedField() = default;\n\n";
+
+    content << "    /// @brief Store a value (takes ownership).\n";
+    content << "    SharedField(T value) : _valueSptr(std::make_shared<T>(std::move(value))) {}\n\n";
+
+    content << "    /// @brief Replace the value (other holders keep the previous one).\n";
+    content << "    SharedField& operator=(T value)\n";
+    content << "    {\n";
+    content << "        _valueSptr = std::make_shared<T>(std::move(value));\n";
+    content << "        return *this;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Read the value without copying.\n";
+    content << "    const T& get() const\n";
+    content << "    {\n";
+    content << "        static const T empty{};\n";
+    content << "        return _valueSptr ? *_valueSptr : empty;\n";
+    content << "    }\n\n";
+
+    content << "    const T& operator*() const { return get(); }\n";
+    content << "    const T* operator->() const { return &get(); }\n";
+    content << "    operator const T&() const { return get(); }\n\n";
+
+    content << "    /// @brief Get a mutable reference, cloning the value first if it is shared.\n";
+    content << "    T& mutate()\n";
+    content << "    {\n";
+    content << "        if (!_valueSptr)\n";
+    content << "        {\n";
+    content << "            _valueSptr = std::make_shared<T>();\n";
+    content << "        }\n";
+    content << "        else if (_valueSptr.use_count() > 1)\n";
+    content << "        {\n";
+    content << "            _valueSptr = std::make_shared<T>(*_valueSptr);\n";
+    content << "        }\n";
+    content << "        return *_valueSptr;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Detach from any shared value and return a fresh, empty one.\n";
+    content << "    T& reset()\n";
+    content << "    {\n";
+    content << "        _valueSptr = std::make_shared<T>();\n";
+    content << "        return *_valueSptr;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Check whether other handles currently share the value.\n";
+    content << "    bool is_shared() const { return _valueSptr.use_count() > 1; }\n\n";
+
+    content << "    // Read-only container conveniences\n";
+    content << "    bool empty() const { return get().empty(); }\n";
+    content << "    std::size_t size() const { return get().size(); }\n";
+    content << "    auto begin() const { return get().begin(); }\n";
+    content << "    auto end() const { return get().end(); }\n";
+    content << "    decltype(auto) operator[](std::size_t index) const { return get()[index]; }\n\n";
+
+    content << "private:\n";
+    content << "    std::shared_ptr<T> _valueSptr;\n";
+    content << "};\n\n";
+
+    return content.str();
+}
+
+std::string CppMessageBaseGenerator::_generate_shared_serialized_data()
+{
+    std::ostringstream content;
+
+    content << "/// @brief Immutable, atomically refcounted serialized message buffer.\n";
+    content << "/// @details Copies share the same bytes, so one encode can be fanned out to many\n";
+    content << "///          subscribers, transports and queues at the cost of a refcount increment.\n";
+    content << "///          slice() returns a view into the same buffer without copying.\n";
+    content << "class SharedSerializedData\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    SharedSerializedData() = default;\n\n";
+
+    content << "    /// @brief Take ownership of a freshly serialized message.\n";
+    content << "    explicit SharedSerializedData(SerializedData&& data)\n";
+    content << "    {\n";
+    content << "        auto words = std::make_shared<const kj::Array<capnp::word>>(data.release());\n";
+    content << "        _bytesPtr = reinterpret_cast<const std::uint8_t*>(words->begin());\n";
+    content << "        _size = words->size() * sizeof(capnp::word);\n";
+    content << "        _ownerSptr = std::move(words);\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Take ownership of a received frame without copying it.\n";
+    content << "    explicit SharedSerializedData(std::vector<std::uint8_t>&& frame)\n";
+    content << "    {\n";
+    content << "        auto bytes = std::make_shared<const std::vector<std::uint8_t>>(std::move(frame));\n";
+    content << "        _bytesPtr = bytes->data();\n";
+    content << "        _size = bytes->size();\n";
+    content << "        _ownerSptr = std::move(bytes);\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Share bytes kept alive by another owner (e.g., a memory-mapped file) without copying.\n";
+    content << "    /// @param owner Keeps the bytes alive for as long as any copy of this handle exists.\n";
+    content << "    /// @param bytes Start of the data (word-aligned for in-place decoding).\n";
+    content << "    /// @param size Size of the data in bytes.\n";
+    content << "    SharedSerializedData(std::shared_ptr<const void> owner, const std::uint8_t* bytes, std::size_t size)\n";
+    content << "        : _ownerSptr(std::move(owner))\n";
+    content << "        , _bytesPtr(bytes)\n";
+    content << "        , _size(size)\n";
+    content << "    {\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Copy a received frame once into a word-aligned shared buffer.\n";
+    content << "    /// @param data Pointer to the frame bytes.\n";
+    content << "    /// @param size Size of the frame in bytes.\n";
+    content << "    static SharedSerializedData copy_of(const std::uint8_t* data, std::size_t size)\n";
+    content << "    {\n";
+    content << "        auto words = kj::heapArray<capnp::word>((size + sizeof(capnp::word) - 1) / sizeof(capnp::word));\n";
+    content << "        if (size > 0)\n";
+    content << "        {\n";
+    content << "            std::memcpy(words.begin(), data, size);\n";
+    content << "        }\n";
+    content << "        SharedSerializedData result(SerializedData(kj::mv(words)));\n";
+    content << "        result._size = size;\n";
+    content << "        return result;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Check if data is valid.\n";
+    content << "    explicit operator bool() const { return _bytesPtr != nullptr && _size > 0; }\n\n";
+
+    content << "    /// @brief Get raw data pointer.\n";
+    content << "    const void* data() const { return _bytesPtr; }\n\n";
+
+    content << "    /// @brief Get data as byte pointer.\n";
+    content << "    const std::uint8_t* bytes() const { return _bytesPtr; }\n\n";
+
+    content << "    /// @brief Get size in bytes.\n";
+    content << "    std::size_t size() const { return _size; }\n\n";
+
+    content << "    /// @brief Get the data as Cap'n Proto words (for FlatArrayMessageReader).\n";
+    content << "    kj::ArrayPtr<const capnp::word> words() const\n";
+    content << "    {\n";
+    content << "        return kj::ArrayPtr<const capnp::word>(reinterpret_cast<const capnp::word*>(_bytesPtr),\n";
+    content << "                                               _size / sizeof(capnp::word));\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Get a view of a sub-range sharing the same buffer.\n";
+    content << "    /// @param offset Byte offset into this view.\n";
+    content << "    /// @param length Number of bytes in the slice.\n";
+    content << "    /// @throws std::out_of_range if the range exceeds this view.\n";
+    content << "    SharedSerializedData slice(std::size_t offset, std::size_t length) const\n";
+    content << "    {\n";
+    content << "        if (offset > _size || length > _size - offset)\n";
+    content << "        {\n";
+    content << "            throw std::out_of_range(\"SharedSerializedData slice out of range\");\n";
+    content << "        }\n";
+    content << "        SharedSerializedData result;\n";
+    content << "        result._ownerSptr = _ownerSptr;\n";
+    content << "        result._bytesPtr = _bytesPtr + offset;\n";
+    content << "        result._size = length;\n";
+    content << "        return result;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Number of handles currently sharing the buffer.\n";
+    content << "    long use_count() const { return _ownerSptr.use_count(); }\n\n";
+
+    content << "private:\n";
+    content << "    std::shared_ptr<const void> _ownerSptr;\n";
+    content << "    const std::uint8_t*         _bytesPtr = nullptr;\n";
+    content << "    std::size_t                 _size = 0;\n";
+    content << "};\n\n";
+
+    return content.str();
+}
+
 std::string CppMessageBaseGenerator::_generate_message_base_content()
 {
     std::ostringstream content;
@@ -63,14 +879,32 @@ std::string CppMessageBaseGenerator::_generate_message_base_content()
     content << "#define MESSAGEBASE_HPP\n\n";
 
     // Includes
+    content << "#include <algorithm>\n";
+    content << "#include <bit>\n";
     content << "#include <cstdint>\n";
     content << "#include <cstdlib>\n";
+    content << "#include <cstring>\n";
+    content << "#include <functional>\n";
+    content << "#include <future>\n";
+    content << "#include <initializer_list>\n";
+    content << "#include <map>\n";
     content << "#include <vector>\n";
     content << "#include <memory>\n";
+    content << "#include <stdexcept>\n";
     content << "#include <string>\n";
+    content << "#include <string_view>\n";
+    content << "#include <thread>\n";
+    content << "#include <type_traits>\n";
     content << "#include <utility>\n\n";
     content << "#include <kj/array.h>\n";
-    content << "#include <capnp/common.h>\n\n";
+    content << "#include <capnp/any.h>\n";
+    content << "#include <capnp/common.h>\n";
+    content << "#include <capnp/message.h>\n";
+    content << "#include <capnp/serialize.h>\n";
+    content << "#include <sys/uio.h>\n\n";
+    content << "#if defined(__SSE2__) || defined(__AVX2__)\n";
+    content << "#include <immintrin.h>\n";
+    content << "#endif\n\n";
 
     // Open namespace
     content << "namespace " << ns << "\n";
@@ -118,6 +952,90 @@ std::string CppMessageBaseGenerator::_generate_message_base_content()
     content << "    kj::Array<capnp::word> release() { return kj::mv(words); }\n";
     content << "};\n\n";
 
+    // SerializedSegments struct - scatter-gather view over the builder's segments
+    content << "/// @brief Scatter-gather view of a serialized Cap'n Proto message.\n";
+    content << "/// @details Owns the message builder and exposes the segment table plus one iovec per\n";
+    content << "///          builder segment, so the message can be handed to writev()/sendmsg()\n";
+    content << "///          without flattening it into a contiguous array first.\n";
+    content << "struct SerializedSegments\n";
+    content << "{\n";
+    content << "    std::unique_ptr<::capnp::MallocMessageBuilder> builder;\n";
+    content << "    std::vector<std::uint32_t> table;\n";
+    content << "    std::vector<struct iovec> iov;\n\n";
+
+    content << "    SerializedSegments() = default;\n";
+    content << "    explicit SerializedSegments(std::unique_ptr<::capnp::MallocMessageBuilder>&& b)\n";
+    content << "        : builder(std::move(b))\n";
+    content << "    {\n";
+    content << "        auto segments = builder->getSegmentsForOutput();\n\n";
+
+    content << "        // Segment table: (count - 1), then each segment size in words, padded to 8 bytes\n";
+    content << "        table.assign((segments.size() + 2) & ~static_cast<std::size_t>(1), 0);\n";
+    content << "        table[0] = _to_wire(static_cast<std::uint32_t>(segments.size() - 1));\n";
+    content << "        for (std::size_t i = 0; i < segments.size(); ++i)\n";
+    content << "        {\n";
+    content << "            table[i + 1] = _to_wire(static_cast<std::uint32_t>(segments[i].size()));\n";
+    content << "        }\n\n";
+
+    content << "        iov.reserve(segments.size() + 1);\n";
+    content << "        iov.push_back({table.data(), table.size() * sizeof(std::uint32_t)});\n";
+    content << "        for (const auto& segment : segments)\n";
+    content << "        {\n";
+    content << "            iov.push_back({const_cast<capnp::word*>(segment.begin()),\n";
+    content << "                           segment.size() * sizeof(capnp::word)});\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    // Move-only semantics (iovecs point into the owned builder)\n";
+    content << "    SerializedSegments(const SerializedSegments&) = delete;\n";
+    content << "    SerializedSegments& operator=(const SerializedSegments&) = delete;\n\n";
+
+    content << "    SerializedSegments(SerializedSegments&& other) noexcept = default;\n";
+    content << "    SerializedSegments& operator=(SerializedSegments&& other) noexcept = default;\n\n";
+
+    content << "    ~SerializedSegments() = default;\n\n";
+
+    content << "    /// @brief Check if data is valid.\n";
+    content << "    explicit operator bool() const { return builder != nullptr && !iov.empty(); }\n\n";
+
+    content << "    /// @brief Get the iovec array (segment table first, then each segment).\n";
+    content << "    const struct iovec* iovecs() const { return iov.data(); }\n\n";
+
+    content << "    /// @brief Get the number of iovec entries.\n";
+    content << "    std::size_t iovec_count() const { return iov.size(); }\n\n";
+
+    content << "    /// @brief Get the total size in bytes across all iovecs.\n";
+    content << "    std::size_t size() const\n";
+    content << "    {\n";
+    content << "        std::size_t total = 0;\n";
+    content << "        for (const auto& entry : iov)\n";
+    content << "        {\n";
+    content << "            total += entry.iov_len;\n";
+    content << "        }\n";
+    content << "        return total;\n";
+    content << "    }\n\n";
+
+    content << "private:\n";
+    content << "    /// @brief Convert a host value to the little-endian wire representation.\n";
+    content << "    static std::uint32_t _to_wire(std::uint32_t value)\n";
+    content << "    {\n";
+    content << "        if constexpr (std::endian::native == std::endian::little)\n";
+    content << "        {\n";
+    content << "            return value;\n";
+    content << "        }\n";
+    content << "        else\n";
+    content << "        {\n";
+    content << "            return ((value & 0xffu) << 24) | ((value & 0xff00u) << 8) |\n";
+    content << "                   ((value >> 8) & 0xff00u) | (value >> 24);\n";
+    content << "        }\n";
+    content << "    }\n";
+    content << "};\n\n";
+
+    content << _generate_shared_serialized_data();
+    content << _generate_shared_field();
+    content << _generate_parallel_executors();
+    content << _generate_field_mask();
+
     // MessageBase class
     content << "/// @brief Base class for all generated message classes.\n";
     content << "/// @details Provides common serialization/deserialization interface.\n";
@@ -161,6 +1079,11 @@ std::string CppMessageBaseGenerator::_generate_message_base_content()
     content << "    /// @note This avoids the vector copy overhead of serialize().\n";
     content << "    virtual SerializedData serialize_fast() const = 0;\n\n";
 
+    content << "    /// @brief Serialize this message as a segment table plus per-segment iovecs.\n";
+    content << "    /// @return SerializedSegments ready for writev()/sendmsg().\n";
+    content << "    /// @note Skips the flattening copy done by serialize_fast() for multi-segment messages.\n";
+    content << "    virtual SerializedSegments serialize_segments() const = 0;\n\n";
+
     content << "    /// @brief Deserialize from a byte vector.\n";
     content << "    /// @param data The serialized data.\n";
     content << "    /// @return True if deserialization succeeded, false otherwise.\n";
@@ -170,9 +1093,79 @@ std::string CppMessageBaseGenerator::_generate_message_base_content()
     content << "    /// @param data Pointer to the data buffer.\n";
     content << "    /// @param size Size of the data buffer in bytes.\n";
     content << "    /// @return True if deserialization succeeded, false otherwise.\n";
-    content << "    virtual bool deserialize(const std::uint8_t* data, std::size_t size) = 0;\n";
+    content << "    virtual bool deserialize(const std::uint8_t* data, std::size_t size) = 0;\n\n";
+
+    content << "    /// @brief Convert this object to a Cap'n Proto message builder.\n";
+    content << "    /// @param message_builder The Cap'n Proto message builder to populate.\n";
+    content << "    virtual void to_capnp(::capnp::MessageBuilder& message_builder) const = 0;\n\n";
+
+    content << "    /// @brief Populate this object from a Cap'n Proto message reader.\n";
+    content << "    /// @param message_reader The Cap'n Proto message reader to read from.\n";
+    content << "    virtual void from_capnp(::capnp::MessageReader& message_reader) = 0;\n\n";
+
+    content << "    /// @brief Populate only the fields selected by a mask.\n";
+    content << "    /// @param message_reader The Cap'n Proto message reader to read from.\n";
+    content << "    /// @param mask The fields to decode; other fields are left unchanged.\n";
+    content << "    /// @note Skips the USER_FROM_CAPNP section.\n";
+    content << "    virtual void from_capnp(::capnp::MessageReader& message_reader, const FieldMask& mask) = 0;\n\n";
+
+    content << "    /// @brief Serialize once into a refcounted buffer for fan-out.\n";
+    content << "    /// @return SharedSerializedData that can be copied to every subscriber cheaply.\n";
+    content << "    SharedSerializedData serialize_shared() const\n";
+    content << "    {\n";
+    content << "        return SharedSerializedData(serialize_fast());\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Deserialize from a refcounted buffer.\n";
+    content << "    /// @param data The shared serialized data.\n";
+    content << "    /// @return True if deserialization succeeded, false otherwise.\n";
+    content << "    bool deserialize(const SharedSerializedData& data)\n";
+    content << "    {\n";
+    content << "        return deserialize(data.bytes(), data.size());\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Deserialize only the fields selected by a mask.\n";
+    content << "    /// @param data Pointer to the data buffer.\n";
+    content << "    /// @param size Size of the data buffer in bytes.\n";
+    content << "    /// @param mask The fields to decode; other fields are left unchanged.\n";
+    content << "    /// @return True if deserialization succeeded, false otherwise.\n";
+    content << "    bool deserialize(const std::uint8_t* data, std::size_t size, const FieldMask& mask)\n";
+    content << "    {\n";
+    content << "        try\n";
+    content << "        {\n";
+    content << "            kj::ArrayPtr<const capnp::word> words(reinterpret_cast<const capnp::word*>(data),\n";
+    content << "                                                  size / sizeof(capnp::word));\n";
+    content << "            ::capnp::FlatArrayMessageReader reader(words);\n";
+    content << "            from_capnp(reader, mask);\n";
+    content << "            return true;\n";
+    content << "        }\n";
+    content << "        catch (...)\n";
+    content << "        {\n";
+    content << "            return false;\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief How many elements ahead list encoders prefetch nested messages.\n";
+    content << "    static constexpr std::size_t _k_list_prefetch_distance = 4;\n\n";
+
+    content << "    /// @brief Minimum list length that from_capnp_parallel() splits across the executor.\n";
+    content << "    static constexpr std::size_t _k_parallel_decode_threshold = 8192;\n\n";
+
+    content << "    /// @brief Minimum number of elements decoded by one parallel task.\n";
+    content << "    static constexpr std::size_t _k_parallel_decode_min_range = 2048;\n\n";
+
+    // List codec helpers are public so generated value types can share them
+    content << _generate_list_copy_helpers();
+    content << "\n";
+    content << _generate_utf8_helpers();
+    content << "\n";
+    content << "protected:\n";
+    content << _generate_patch_helpers();
     content << "};\n\n";
 
+    content << _generate_message_impl();
+    content << _generate_list_appender();
+
     // Close namespace
     content << "} // namespace " << ns << "\n\n";
 
@@ -0,0 +1,560 @@
+#include "cpp_message_builder_generator.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "string_utils.hpp"
+#include "type_converter.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+// ---- Constructor ----
+
+CppMessageBuilderGenerator::CppMessageBuilderGenerator(const Schema& schema, const std::string& output_directory, const std::string& include_prefix)
+    : _schema(schema)
+    , _outputDirectory(_resolve_output_directory(output_directory))
+    , _includePrefix(include_prefix)
+{
+    for (const auto& [name, message] : _schema.messages)
+    {
+        // Value types are nested-only; they have no msgType header to build a root from
+        if (message.is_value_type())
+        {
+            continue;
+        }
+
+        _write_file(name + "Builder.hpp", _generate_builder_content(message, false));
+
+        // Forward-only writers are for messages that carry (potentially huge) lists
+        const std::vector<Type> all_fields = _get_all_fields(message);
+        bool has_list = std::any_of(all_fields.begin(), all_fields.end(),
+                                    [](const Type& field) { return field.is_list(); });
+        if (has_list)
+        {
+            _write_file(name + "Writer.hpp", _generate_builder_content(message, true));
+        }
+    }
+}
+
+// ---- Private static methods ----
+
+std::string CppMessageBuilderGenerator::_resolve_output_directory(const std::string& path)
+{
+    namespace fs = std::filesystem;
+    fs::create_directories(path);
+    return path;
+}
+
+std::string CppMessageBuilderGenerator::_to_enum_value_name(const std::string& message_name)
+{
+    if (message_name.empty())
+    {
+        return message_name;
+    }
+
+    // Convert PascalCase to camelCase (first letter lowercase)
+    std::string result = message_name;
+    result[0] = static_cast<char>(std::tolower(static_cast<unsigned char>(result[0])));
+    return result;
+}
+
+std::string CppMessageBuilderGenerator::_to_capnp_method_name(const std::string& field_name)
+{
+    if (field_name.empty())
+    {
+        return field_name;
+    }
+
+    // Capitalize first letter for Cap'n Proto accessors (e.g., viewCount -> ViewCount)
+    std::string result = field_name;
+    result[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(result[0])));
+    return result;
+}
+
+// ---- Private instance methods ----
+
+void CppMessageBuilderGenerator::_write_file(const std::string& file_name, const std::string& content) const
+{
+    namespace fs = std::filesystem;
+
+    fs::path output_file_path = fs::path(_outputDirectory) / file_name;
+
+    std::ofstream output_file(output_file_path, std::ios::binary);
+    if (!output_file)
+    {
+        throw std::runtime_error("Failed to create builder header file: " + output_file_path.string());
+    }
+
+    output_file << content;
+}
+
+std::vector<Type> CppMessageBuilderGenerator::_get_all_fields(const Message& message) const
+{
+    std::vector<Type> all_fields;
+
+    // Recursively get parent fields first
+    if (!message.parent_name.empty())
+    {
+        auto parent_it = _schema.messages.find(message.parent_name);
+        if (parent_it != _schema.messages.end())
+        {
+            auto parent_fields = _get_all_fields(parent_it->second);
+            all_fields.insert(all_fields.end(), parent_fields.begin(), parent_fields.end());
+        }
+    }
+
+    // Add this message's own fields
+    all_fields.insert(all_fields.end(), message.fields.begin(), message.fields.end());
+
+    return all_fields;
+}
+
+bool CppMessageBuilderGenerator::_is_enum_type(const Type& type) const
+{
+    return type.is_enum() ||
+           (type.is_custom() && (_schema.enums.count(type.get_custom_name()) > 0 || type.get_custom_name() == "MessageType"));
+}
+
+bool CppMessageBuilderGenerator::_is_message_type(const Type& type) const
+{
+    return type.is_custom() && !_is_enum_type(type) &&
+           _schema.messages.count(type.get_custom_name()) > 0;
+}
+
+void CppMessageBuilderGenerator::_generate_field_accessors(const Type& field, const std::string& capnp_ns,
+                                                           bool with_getters, std::ostringstream& public_content,
+                                                           std::ostringstream& private_content) const
+{
+    const std::string& field_name = field.get_field_name();
+    const std::string method_name = _to_capnp_method_name(field_name);
+
+    // Getters go last for each field and are dropped for forward-only writers
+    std::ostringstream getter_content;
+
+    if (field.is_list() && field.get_element_type() != nullptr)
+    {
+        const Type& element_type = *field.get_element_type();
+        const std::string list_type = TypeConverter::get_capnp_cpp_type(field, capnp_ns);
+        const std::string appender_name = "_" + field_name + "Appender";
+
+        public_content << "    /// @brief Allocate room for at least the given number of " << field_name << " elements.\n";
+        public_content << "    /// @param capacity The element count to allocate.\n";
+        public_content << "    void reserve_" << field_name << "(unsigned capacity)\n";
+        public_content << "    {\n";
+        public_content << "        if (!" << appender_name << " && !_root.has" << method_name << "())\n";
+        public_content << "        {\n";
+        public_content << "            " << appender_name << ".emplace(_builderUptr->getOrphanage(), capacity);\n";
+        public_content << "        }\n";
+        public_content << "        else\n";
+        public_content << "        {\n";
+        public_content << "            _" << field_name << "_appender().reserve(capacity);\n";
+        public_content << "        }\n";
+        public_content << "    }\n\n";
+
+        if (_is_message_type(element_type))
+        {
+            const std::string& element_name = element_type.get_custom_name();
+            public_content << "    /// @brief Append a " << field_name << " element and return its Cap'n Proto builder.\n";
+            public_content << "    /// @return Builder for the new element, valid until the next append to " << field_name << ".\n";
+            public_content << "    ::" << capnp_ns << "::" << element_name << "::Builder add_" << field_name << "()\n";
+            public_content << "    {\n";
+            public_content << "        return _" << field_name << "_appender().append();\n";
+            public_content << "    }\n\n";
+
+            public_content << "    /// @brief Append a copy of a message object to " << field_name << ".\n";
+            public_content << "    /// @param value The element to encode.\n";
+            public_content << "    void add_" << field_name << "(const " << element_name << "& value)\n";
+            public_content << "    {\n";
+            public_content << "        value.to_capnp_struct(_" << field_name << "_appender().append());\n";
+            public_content << "    }\n\n";
+        }
+        else if (_is_enum_type(element_type))
+        {
+            const std::string& enum_name = element_type.get_custom_name();
+            public_content << "    /// @brief Append a " << field_name << " element.\n";
+            public_content << "    void add_" << field_name << "(" << enum_name << " value)\n";
+            public_content << "    {\n";
+            public_content << "        _" << field_name << "_appender().append(static_cast<::" << capnp_ns << "::" << enum_name << ">(value));\n";
+            public_content << "    }\n\n";
+        }
+        else if (element_type.is_primitive() && element_type.get_cpp_type() == "std::string")
+        {
+            public_content << "    /// @brief Append a " << field_name << " element (copied into the arena).\n";
+            public_content << "    void add_" << field_name << "(std::string_view value)\n";
+            public_content << "    {\n";
+            public_content << "        _" << field_name << "_appender().append(::capnp::Text::Reader(value.data(), value.size()));\n";
+            public_content << "    }\n\n";
+        }
+        else if (element_type.is_primitive() && element_type.get_cpp_type() == "std::vector<uint8_t>")
+        {
+            public_content << "    /// @brief Append a " << field_name << " element (copied into the arena).\n";
+            public_content << "    void add_" << field_name << "(std::span<const std::uint8_t> value)\n";
+            public_content << "    {\n";
+            public_content << "        _" << field_name << "_appender().append(::capnp::Data::Reader(value.data(), value.size()));\n";
+            public_content << "    }\n\n";
+        }
+        else if (element_type.is_primitive())
+        {
+            public_content << "    /// @brief Append a " << field_name << " element.\n";
+            public_content << "    void add_" << field_name << "(" << element_type.get_cpp_type() << " value)\n";
+            public_content << "    {\n";
+            public_content << "        _" << field_name << "_appender().append(value);\n";
+            public_content << "    }\n\n";
+        }
+
+        public_content << "    /// @brief Get the number of " << field_name << " elements.\n";
+        public_content << "    unsigned " << field_name << "_size() const\n";
+        public_content << "    {\n";
+        public_content << "        return " << appender_name << " ? " << appender_name << "->size() : _root.asReader().get"
+                       << method_name << "().size();\n";
+        public_content << "    }\n\n";
+
+        getter_content << "    /// @brief Read " << field_name << " back from the arena.\n";
+        getter_content << "    /// @note Seals pending appends; appending again afterwards resumes on the same list.\n";
+        getter_content << "    " << list_type << "::Reader get_" << field_name << "()\n";
+        getter_content << "    {\n";
+        getter_content << "        _flush_" << field_name << "();\n";
+        getter_content << "        return _root.asReader().get" << method_name << "();\n";
+        getter_content << "    }\n\n";
+
+        private_content << "    std::optional<ListAppender<" << list_type << ">> " << appender_name << ";\n\n";
+
+        private_content << "    ListAppender<" << list_type << ">& _" << field_name << "_appender()\n";
+        private_content << "    {\n";
+        private_content << "        if (!" << appender_name << ")\n";
+        private_content << "        {\n";
+        private_content << "            if (_root.has" << method_name << "())\n";
+        private_content << "            {\n";
+        private_content << "                " << appender_name << ".emplace(_root.disown" << method_name << "());\n";
+        private_content << "            }\n";
+        private_content << "            else\n";
+        private_content << "            {\n";
+        private_content << "                " << appender_name << ".emplace(_builderUptr->getOrphanage(), 0u);\n";
+        private_content << "            }\n";
+        private_content << "        }\n";
+        private_content << "        return *" << appender_name << ";\n";
+        private_content << "    }\n\n";
+
+        private_content << "    void _flush_" << field_name << "()\n";
+        private_content << "    {\n";
+        private_content << "        if (" << appender_name << ")\n";
+        private_content << "        {\n";
+        private_content << "            _root.adopt" << method_name << "(" << appender_name << "->finish());\n";
+        private_content << "            " << appender_name << ".reset();\n";
+        private_content << "        }\n";
+        private_content << "    }\n\n";
+    }
+    else if (field.is_map())
+    {
+        public_content << "    /// @brief Initialize " << field_name << " in place and return its Cap'n Proto builder.\n";
+        public_content << "    auto init_" << field_name << "() { return _root.init" << method_name << "(); }\n\n";
+
+        getter_content << "    /// @brief Read " << field_name << " back from the arena.\n";
+        getter_content << "    auto get_" << field_name << "() const { return _root.asReader().get" << method_name << "(); }\n\n";
+    }
+    else if (_is_message_type(field))
+    {
+        const std::string& type_name = field.get_custom_name();
+        public_content << "    /// @brief Initialize " << field_name << " in place and return its Cap'n Proto builder.\n";
+        public_content << "    ::" << capnp_ns << "::" << type_name << "::Builder init_" << field_name << "()\n";
+        public_content << "    {\n";
+        public_content << "        return _root.init" << method_name << "();\n";
+        public_content << "    }\n\n";
+
+        public_content << "    /// @brief Encode a copy of a message object into " << field_name << ".\n";
+        public_content << "    void set_" << field_name << "(const " << type_name << "& value)\n";
+        public_content << "    {\n";
+        public_content << "        value.to_capnp_struct(_root.init" << method_name << "());\n";
+        public_content << "    }\n\n";
+
+        getter_content << "    /// @brief Read " << field_name << " back from the arena.\n";
+        getter_content << "    ::" << capnp_ns << "::" << type_name << "::Reader get_" << field_name << "() const\n";
+        getter_content << "    {\n";
+        getter_content << "        return _root.asReader().get" << method_name << "();\n";
+        getter_content << "    }\n\n";
+    }
+    else if (_is_enum_type(field))
+    {
+        const std::string& enum_name = field.get_custom_name();
+        public_content << "    /// @brief Set " << field_name << ".\n";
+        public_content << "    void set_" << field_name << "(" << enum_name << " value)\n";
+        public_content << "    {\n";
+        public_content << "        _root.set" << method_name << "(static_cast<::" << capnp_ns << "::" << enum_name << ">(value));\n";
+        public_content << "    }\n\n";
+
+        getter_content << "    /// @brief Get " << field_name << ".\n";
+        getter_content << "    " << enum_name << " get_" << field_name << "() const\n";
+        getter_content << "    {\n";
+        getter_content << "        return static_cast<" << enum_name << ">(_root.asReader().get" << method_name << "());\n";
+        getter_content << "    }\n\n";
+    }
+    else if (field.is_primitive() && field.get_cpp_type() == "std::string")
+    {
+        public_content << "    /// @brief Set " << field_name << " (copied into the arena).\n";
+        public_content << "    void set_" << field_name << "(std::string_view value)\n";
+        public_content << "    {\n";
+        public_content << "        _root.set" << method_name << "(::capnp::Text::Reader(value.data(), value.size()));\n";
+        public_content << "    }\n\n";
+
+        getter_content << "    /// @brief Get " << field_name << " as a view into the arena.\n";
+        getter_content << "    std::string_view get_" << field_name << "() const\n";
+        getter_content << "    {\n";
+        getter_content << "        auto text = _root.asReader().get" << method_name << "();\n";
+        getter_content << "        return std::string_view(text.begin(), text.size());\n";
+        getter_content << "    }\n\n";
+    }
+    else if (field.is_primitive() && field.get_cpp_type() == "std::vector<uint8_t>")
+    {
+        public_content << "    /// @brief Set " << field_name << " (copied into the arena).\n";
+        public_content << "    void set_" << field_name << "(std::span<const std::uint8_t> value)\n";
+        public_content << "    {\n";
+        public_content << "        _root.set" << method_name << "(::capnp::Data::Reader(value.data(), value.size()));\n";
+        public_content << "    }\n\n";
+
+        getter_content << "    /// @brief Get " << field_name << " as a view into the arena.\n";
+        getter_content << "    std::span<const std::uint8_t> get_" << field_name << "() const\n";
+        getter_content << "    {\n";
+        getter_content << "        auto data = _root.asReader().get" << method_name << "();\n";
+        getter_content << "        return std::span<const std::uint8_t>(data.begin(), data.size());\n";
+        getter_content << "    }\n\n";
+    }
+    else if (field.is_primitive())
+    {
+        const std::string cpp_type = field.get_cpp_type();
+        public_content << "    /// @brief Set " << field_name << ".\n";
+        public_content << "    void set_" << field_name << "(" << cpp_type << " value) { _root.set" << method_name << "(value); }\n\n";
+
+        getter_content << "    /// @brief Get " << field_name << ".\n";
+        getter_content << "    " << cpp_type << " get_" << field_name << "() const { return _root.asReader().get" << method_name << "(); }\n\n";
+    }
+
+    if (with_getters)
+    {
+        public_content << getter_content.str();
+    }
+}
+
+std::string CppMessageBuilderGenerator::_generate_builder_content(const Message& message, bool forward_only) const
+{
+    std::ostringstream content;
+
+    // Use wrapper_namespace_name if specified, otherwise fall back to namespace_name
+    const std::string& raw_ns = _schema.wrapper_namespace_name.empty() ?
+                                  _schema.namespace_name : _schema.wrapper_namespace_name;
+    const std::string ns = raw_ns.empty() ?
+                             "curious::net" :
+                             string_utils::to_cpp_namespace(raw_ns);
+    const std::string capnp_ns = _schema.namespace_name.empty() ?
+                                   "curious::message" :
+                                   string_utils::to_cpp_namespace(_schema.namespace_name);
+
+    const std::string class_name = message.name + (forward_only ? "Writer" : "Builder");
+    const std::vector<Type> all_fields = _get_all_fields(message);
+
+    // Header guard
+    std::string guard_name;
+    for (char c : class_name)
+    {
+        guard_name += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    guard_name += "_HPP";
+
+    content << "#pragma once\n\n";
+    content << "#ifndef " << guard_name << "\n";
+    content << "#define " << guard_name << "\n\n";
+
+    // Includes
+    content << "#include <cstddef>\n";
+    content << "#include <cstdint>\n";
+    content << "#include <memory>\n";
+    content << "#include <optional>\n";
+    content << "#include <span>\n";
+    content << "#include <string_view>\n";
+    content << "#include <utility>\n\n";
+    content << "#include <capnp/message.h>\n";
+    content << "#include <capnp/orphan.h>\n";
+    content << "#include <capnp/serialize.h>\n";
+    content << "#include <kj/io.h>\n\n";
+    content << "#include <" << _includePrefix << "MessageBase.hpp>\n";
+    content << "#include <" << _includePrefix << "enums.hpp>\n";
+    content << "#include <" << _includePrefix << message.name << ".hpp>\n";
+
+    // Message objects accepted by set_<field>() / add_<field>()
+    std::set<std::string> included_types{message.name};
+    for (const auto& field : all_fields)
+    {
+        const Type* nested_type = field.is_list() ? field.get_element_type() : &field;
+        if (nested_type != nullptr && _is_message_type(*nested_type) &&
+            included_types.insert(nested_type->get_custom_name()).second)
+        {
+            content << "#include <" << _includePrefix << nested_type->get_custom_name() << ".hpp>\n";
+        }
+    }
+    content << "\n";
+
+    // Open namespace
+    content << "namespace " << ns << "\n";
+    content << "{\n\n";
+
+    std::ostringstream public_content;
+    std::ostringstream private_content;
+    std::vector<std::string> list_fields;
+    for (const auto& field : all_fields)
+    {
+        // msgType is fixed by the constructor
+        if (field.get_field_name() == "msgType")
+        {
+            continue;
+        }
+        if (field.is_list() && field.get_element_type() != nullptr)
+        {
+            list_fields.push_back(field.get_field_name());
+        }
+        _generate_field_accessors(field, capnp_ns, !forward_only, public_content, private_content);
+    }
+
+    if (forward_only)
+    {
+        content << "/// @brief Forward-only writer for producing a large " << message.name << " incrementally.\n";
+        content << "/// @details Set the scalar fields, then append list elements one at a time (e.g., rows\n";
+        content << "///          from a database cursor) straight into the Cap'n Proto arena. No element objects\n";
+        content << "///          or std::vector are materialized, so peak memory is the encoded message itself.\n";
+        content << "///          write_to() streams the segments without flattening them into one array.\n";
+    }
+    else
+    {
+        content << "/// @brief Builder-backed " << message.name << " whose fields live directly in a Cap'n Proto arena.\n";
+        content << "/// @details Setters write into an owned MallocMessageBuilder and lists grow in place (see\n";
+        content << "///          ListAppender), so building a message never fills intermediate C++ containers and\n";
+        content << "///          serializing it copies nothing but the segments. Inherited fields are included.\n";
+        content << "///          Use " << message.name << " instead when the object is read and edited more than sent.\n";
+    }
+    content << "class " << class_name << "\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    using CapnpType = " << message.name << "::CapnpType;\n\n";
+
+    if (forward_only)
+    {
+        content << "    /// @brief Start an empty message with its msgType header set.\n";
+        content << "    /// @param expected_bytes Expected encoded size; when known, the arena starts as one\n";
+        content << "    ///                       segment of that size and never reallocates.\n";
+        content << "    explicit " << class_name << "(std::size_t expected_bytes = 0)\n";
+        content << "        : _builderUptr(std::make_unique<::capnp::MallocMessageBuilder>(\n";
+        content << "              expected_bytes == 0 ? ::capnp::SUGGESTED_FIRST_SEGMENT_WORDS :\n";
+        content << "                                    static_cast<unsigned>(expected_bytes / sizeof(::capnp::word) + 1)))\n";
+    }
+    else
+    {
+        content << "    /// @brief Start an empty message with its msgType header set.\n";
+        content << "    /// @param first_segment_words Size of the first arena segment in words; sizing it for the\n";
+        content << "    ///                            whole message keeps it in one segment.\n";
+        content << "    explicit " << class_name << "(unsigned first_segment_words = ::capnp::SUGGESTED_FIRST_SEGMENT_WORDS)\n";
+        content << "        : _builderUptr(std::make_unique<::capnp::MallocMessageBuilder>(first_segment_words))\n";
+    }
+    content << "        , _root(_builderUptr->initRoot<CapnpType>())\n";
+    content << "    {\n";
+    content << "        _root.setMsgType(static_cast<::" << capnp_ns << "::MessageType>(MessageType::"
+            << _to_enum_value_name(message.name) << "));\n";
+    content << "    }\n\n";
+
+    content << "    // Move-only semantics (the root builder points into the owned arena)\n";
+    content << "    " << class_name << "(const " << class_name << "&) = delete;\n";
+    content << "    " << class_name << "& operator=(const " << class_name << "&) = delete;\n";
+    content << "    " << class_name << "(" << class_name << "&&) noexcept = default;\n";
+    content << "    " << class_name << "& operator=(" << class_name << "&&) noexcept = default;\n";
+    content << "    ~" << class_name << "() = default;\n\n";
+
+    content << public_content.str();
+
+    if (forward_only)
+    {
+        content << "    /// @brief Get the bytes allocated in the arena so far (an upper bound on the encoded size).\n";
+        content << "    /// @details Lets a producer stop appending once a size budget is reached.\n";
+        content << "    std::size_t size_in_bytes() const\n";
+        content << "    {\n";
+        content << "        return _builderUptr->sizeInWords() * sizeof(::capnp::word);\n";
+        content << "    }\n\n";
+
+        content << "    /// @brief Finish the message and write it to a file descriptor, one writev() per batch of segments.\n";
+        content << "    /// @param fd The file descriptor or socket to write to.\n";
+        content << "    /// @throws kj::Exception on write errors.\n";
+        content << "    void write_to(int fd) &&\n";
+        content << "    {\n";
+        content << "        _flush_lists();\n";
+        content << "        ::capnp::writeMessageToFd(fd, *_builderUptr);\n";
+        content << "    }\n\n";
+
+        content << "    /// @brief Finish the message and write it to a stream.\n";
+        content << "    /// @param output The stream to write to.\n";
+        content << "    void write_to(kj::OutputStream& output) &&\n";
+        content << "    {\n";
+        content << "        _flush_lists();\n";
+        content << "        ::capnp::writeMessage(output, *_builderUptr);\n";
+        content << "    }\n\n";
+    }
+    else
+    {
+        content << "    /// @brief Get the root Cap'n Proto builder for fields without a dedicated accessor.\n";
+        content << "    /// @note Seals pending list appends first.\n";
+        content << "    CapnpType::Builder root()\n";
+        content << "    {\n";
+        content << "        _flush_lists();\n";
+        content << "        return _root;\n";
+        content << "    }\n\n";
+
+        content << "    /// @brief Decode the built message into a " << message.name << " object.\n";
+        content << "    /// @param message The object to populate.\n";
+        content << "    void to_message(" << message.name << "& message)\n";
+        content << "    {\n";
+        content << "        _flush_lists();\n";
+        content << "        message.from_capnp_struct(_root.asReader());\n";
+        content << "    }\n\n";
+
+        content << "    /// @brief Serialize to a contiguous flat array.\n";
+        content << "    /// @return SerializedData holding the flattened segments.\n";
+        content << "    SerializedData serialize_fast()\n";
+        content << "    {\n";
+        content << "        _flush_lists();\n";
+        content << "        return SerializedData(::capnp::messageToFlatArray(*_builderUptr));\n";
+        content << "    }\n\n";
+    }
+
+    content << "    /// @brief Hand the arena over for writev()/sendmsg() without copying.\n";
+    content << "    /// @return SerializedSegments owning the arena; this object is empty afterwards.\n";
+    content << "    SerializedSegments release_segments() &&\n";
+    content << "    {\n";
+    content << "        _flush_lists();\n";
+    content << "        return SerializedSegments(std::move(_builderUptr));\n";
+    content << "    }\n\n";
+
+    content << "private:\n";
+    content << "    /// @brief Adopt every pending list back into the root struct.\n";
+    content << "    void _flush_lists()\n";
+    content << "    {\n";
+    for (const auto& field_name : list_fields)
+    {
+        content << "        _flush_" << field_name << "();\n";
+    }
+    content << "    }\n\n";
+
+    content << private_content.str();
+
+    content << "    std::unique_ptr<::capnp::MallocMessageBuilder> _builderUptr;\n";
+    content << "    CapnpType::Builder                            _root;\n";
+    content << "};\n\n";
+
+    // Close namespace
+    content << "} // namespace " << ns << "\n\n";
+
+    // Close header guard
+    content << "#endif // " << guard_name << "\n";
+
+    return content.str();
+}
+
+} // namespace curious::dsl::capnpgen
@@ -0,0 +1,758 @@
+#include "cpp_message_log_generator.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "string_utils.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+// ---- Constructor ----
+
+CppMessageLogGenerator::CppMessageLogGenerator(const Schema& schema, const std::string& output_directory, const std::string& include_prefix)
+    : _schema(schema)
+    , _outputDirectory(_resolve_output_directory(output_directory))
+    , _includePrefix(include_prefix)
+{
+    namespace fs = std::filesystem;
+
+    fs::path output_file_path = fs::path(_outputDirectory) / "MessageLog.hpp";
+
+    std::ofstream output_file(output_file_path, std::ios::binary);
+    if (!output_file)
+    {
+        throw std::runtime_error("Failed to create message log header file: " + output_file_path.string());
+    }
+
+    output_file << _generate_message_log_content();
+}
+
+// ---- Private static methods ----
+
+std::string CppMessageLogGenerator::_resolve_output_directory(const std::string& path)
+{
+    namespace fs = std::filesystem;
+    fs::create_directories(path);
+    return path;
+}
+
+std::string CppMessageLogGenerator::_generate_log_classes()
+{
+    std::ostringstream content;
+
+    content << "/// @brief Header in front of every record; the payload follows, padded to a word boundary.\n";
+    content << "/// @details The length is stored last (with release ordering), so a reader that sees a\n";
+    content << "///          non-zero length also sees the rest of the record. A zero length ends the data.\n";
+    content << "struct MessageLogRecordHeader\n";
+    content << "{\n";
+    content << "    std::uint32_t length;\n";
+    content << "    std::uint32_t type;\n";
+    content << "    std::uint64_t offset;\n";
+    content << "    std::int64_t  timestamp_ns;\n";
+    content << "};\n\n";
+
+    content << "static_assert(sizeof(MessageLogRecordHeader) == 24, \"record header must stay word-aligned\");\n\n";
+
+    content << "/// @brief One sparse index point: the first record at or after a segment position.\n";
+    content << "struct MessageLogIndexEntry\n";
+    content << "{\n";
+    content << "    std::uint64_t offset;\n";
+    content << "    std::int64_t  timestamp_ns;\n";
+    content << "    std::uint64_t position;\n";
+    content << "};\n\n";
+
+    content << "/// @brief Tuning for MessageLogWriter.\n";
+    content << "struct MessageLogOptions\n";
+    content << "{\n";
+    content << "    /// @brief Preallocated size of each segment file; larger records get a segment of their own size.\n";
+    content << "    std::size_t segment_bytes = std::size_t{64} << 20;\n\n";
+
+    content << "    /// @brief Bytes between sparse index points.\n";
+    content << "    std::size_t index_interval_bytes = std::size_t{64} << 10;\n\n";
+
+    content << "    /// @brief Flush each segment to disk with msync() when it is sealed.\n";
+    content << "    bool sync_on_rotate = true;\n";
+    content << "};\n\n";
+
+    content << "/// @brief One memory-mapped segment file: `<base offset, 20 digits>.log` plus a sealed `.idx`.\n";
+    content << "/// @details Files are preallocated with ftruncate() and never shrunk, so readers mapping a\n";
+    content << "///          segment that is still being written never fault past the end of the file.\n";
+    content << "class MessageLogSegment\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    static constexpr char _k_magic[8] = {'C', 'M', 'L', 'O', 'G', '0', '0', '1'};\n";
+    content << "    static constexpr std::size_t _k_header_bytes = 16;\n\n";
+
+    content << "    /// @brief Map a segment file, creating it with the given capacity if it does not exist.\n";
+    content << "    /// @param path Segment file path.\n";
+    content << "    /// @param base_offset Offset of the first record (written to new files only).\n";
+    content << "    /// @param capacity Size of a new file; 0 to open an existing file read-only.\n";
+    content << "    /// @return The mapped segment.\n";
+    content << "    static std::shared_ptr<MessageLogSegment> open(const std::string& path, std::uint64_t base_offset, std::size_t capacity)\n";
+    content << "    {\n";
+    content << "        const bool writable = capacity != 0;\n";
+    content << "        const int fd = ::open(path.c_str(), writable ? (O_RDWR | O_CREAT | O_CLOEXEC) : (O_RDONLY | O_CLOEXEC), 0644);\n";
+    content << "        if (fd < 0)\n";
+    content << "        {\n";
+    content << "            _fail(\"open\", path);\n";
+    content << "        }\n\n";
+
+    content << "        struct stat info{};\n";
+    content << "        if (::fstat(fd, &info) != 0)\n";
+    content << "        {\n";
+    content << "            ::close(fd);\n";
+    content << "            _fail(\"fstat\", path);\n";
+    content << "        }\n";
+    content << "        std::size_t size = static_cast<std::size_t>(info.st_size);\n";
+    content << "        const bool created = size == 0 && writable;\n";
+    content << "        if (created)\n";
+    content << "        {\n";
+    content << "            if (::ftruncate(fd, static_cast<off_t>(capacity)) != 0)\n";
+    content << "            {\n";
+    content << "                ::close(fd);\n";
+    content << "                _fail(\"ftruncate\", path);\n";
+    content << "            }\n";
+    content << "            size = capacity;\n";
+    content << "        }\n";
+    content << "        if (size < _k_header_bytes)\n";
+    content << "        {\n";
+    content << "            ::close(fd);\n";
+    content << "            throw std::runtime_error(\"Message log segment too small: \" + path);\n";
+    content << "        }\n\n";
+
+    content << "        void* mapping = ::mmap(nullptr, size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);\n";
+    content << "        ::close(fd);\n";
+    content << "        if (mapping == MAP_FAILED)\n";
+    content << "        {\n";
+    content << "            _fail(\"mmap\", path);\n";
+    content << "        }\n\n";
+
+    content << "        auto segment = std::shared_ptr<MessageLogSegment>(new MessageLogSegment(path, static_cast<std::uint8_t*>(mapping), size));\n";
+    content << "        if (created)\n";
+    content << "        {\n";
+    content << "            std::memcpy(segment->_data, _k_magic, sizeof(_k_magic));\n";
+    content << "            std::memcpy(segment->_data + sizeof(_k_magic), &base_offset, sizeof(base_offset));\n";
+    content << "        }\n";
+    content << "        else if (std::memcmp(segment->_data, _k_magic, sizeof(_k_magic)) != 0)\n";
+    content << "        {\n";
+    content << "            throw std::runtime_error(\"Not a message log segment: \" + path);\n";
+    content << "        }\n";
+    content << "        std::memcpy(&segment->_baseOffset, segment->_data + sizeof(_k_magic), sizeof(segment->_baseOffset));\n";
+    content << "        return segment;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief List the segment files of a log directory, oldest first.\n";
+    content << "    static std::vector<std::string> list(const std::string& directory)\n";
+    content << "    {\n";
+    content << "        std::vector<std::string> paths;\n";
+    content << "        if (!std::filesystem::is_directory(directory))\n";
+    content << "        {\n";
+    content << "            return paths;\n";
+    content << "        }\n";
+    content << "        for (const auto& file : std::filesystem::directory_iterator(directory))\n";
+    content << "        {\n";
+    content << "            if (file.path().extension() == \".log\")\n";
+    content << "            {\n";
+    content << "                paths.push_back(file.path().string());\n";
+    content << "            }\n";
+    content << "        }\n";
+    content << "        std::sort(paths.begin(), paths.end());\n";
+    content << "        return paths;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Build the path of the segment starting at a record offset.\n";
+    content << "    static std::string path_for(const std::string& directory, std::uint64_t base_offset)\n";
+    content << "    {\n";
+    content << "        char name[32];\n";
+    content << "        std::snprintf(name, sizeof(name), \"%020llu.log\", static_cast<unsigned long long>(base_offset));\n";
+    content << "        return (std::filesystem::path(directory) / name).string();\n";
+    content << "    }\n\n";
+
+    content << "    MessageLogSegment(const MessageLogSegment&) = delete;\n";
+    content << "    MessageLogSegment& operator=(const MessageLogSegment&) = delete;\n\n";
+
+    content << "    ~MessageLogSegment()\n";
+    content << "    {\n";
+    content << "        ::munmap(_data, _size);\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Read the header at a position, or return false at the end of the written data.\n";
+    content << "    bool header_at(std::size_t position, MessageLogRecordHeader& header) const\n";
+    content << "    {\n";
+    content << "        if (position + sizeof(MessageLogRecordHeader) > _size)\n";
+    content << "        {\n";
+    content << "            return false;\n";
+    content << "        }\n";
+    content << "        auto* length = reinterpret_cast<std::uint32_t*>(_data + position);\n";
+    content << "        header.length = std::atomic_ref<std::uint32_t>(*length).load(std::memory_order_acquire);\n";
+    content << "        if (header.length == 0 || position + record_bytes(header.length) > _size)\n";
+    content << "        {\n";
+    content << "            return false;\n";
+    content << "        }\n";
+    content << "        std::memcpy(&header.type, _data + position + 4, sizeof(header) - 4);\n";
+    content << "        return true;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Write a record at a position; the length is published last.\n";
+    content << "    void write_at(std::size_t position, const MessageLogRecordHeader& header, const std::uint8_t* payload)\n";
+    content << "    {\n";
+    content << "        std::uint8_t* record = _data + position;\n";
+    content << "        std::memcpy(record + sizeof(MessageLogRecordHeader), payload, header.length);\n";
+    content << "        std::memcpy(record + 4, &header.type, sizeof(header) - 4);\n";
+    content << "        std::atomic_ref<std::uint32_t>(*reinterpret_cast<std::uint32_t*>(record)).store(header.length, std::memory_order_release);\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Walk the written records, building a sparse index.\n";
+    content << "    /// @param interval Bytes between index points.\n";
+    content << "    /// @param next_offset Receives the offset after the last record (unchanged if there is none).\n";
+    content << "    /// @return The position after the last record.\n";
+    content << "    std::size_t scan(std::size_t interval, std::vector<MessageLogIndexEntry>& index, std::uint64_t& next_offset) const\n";
+    content << "    {\n";
+    content << "        index.clear();\n";
+    content << "        std::size_t position = _k_header_bytes;\n";
+    content << "        std::size_t next_index_position = position;\n";
+    content << "        MessageLogRecordHeader header{};\n";
+    content << "        while (header_at(position, header))\n";
+    content << "        {\n";
+    content << "            if (position >= next_index_position)\n";
+    content << "            {\n";
+    content << "                index.push_back({header.offset, header.timestamp_ns, position});\n";
+    content << "                next_index_position = position + interval;\n";
+    content << "            }\n";
+    content << "            next_offset = header.offset + 1;\n";
+    content << "            position += record_bytes(header.length);\n";
+    content << "        }\n";
+    content << "        return position;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Load the sparse index written when the segment was sealed.\n";
+    content << "    /// @return False if there is no index file.\n";
+    content << "    bool load_index(std::vector<MessageLogIndexEntry>& index) const\n";
+    content << "    {\n";
+    content << "        std::ifstream file(index_path(), std::ios::binary);\n";
+    content << "        if (!file)\n";
+    content << "        {\n";
+    content << "            return false;\n";
+    content << "        }\n";
+    content << "        file.seekg(0, std::ios::end);\n";
+    content << "        const auto bytes = static_cast<std::size_t>(file.tellg());\n";
+    content << "        file.seekg(0);\n";
+    content << "        index.resize(bytes / sizeof(MessageLogIndexEntry));\n";
+    content << "        file.read(reinterpret_cast<char*>(index.data()), static_cast<std::streamsize>(index.size() * sizeof(MessageLogIndexEntry)));\n";
+    content << "        return static_cast<bool>(file);\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Write the sparse index and optionally flush the mapped data to disk.\n";
+    content << "    void seal(const std::vector<MessageLogIndexEntry>& index, bool sync)\n";
+    content << "    {\n";
+    content << "        if (sync)\n";
+    content << "        {\n";
+    content << "            ::msync(_data, _size, MS_SYNC);\n";
+    content << "        }\n";
+    content << "        std::ofstream file(index_path(), std::ios::binary | std::ios::trunc);\n";
+    content << "        file.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size() * sizeof(MessageLogIndexEntry)));\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Flush the mapped data to disk.\n";
+    content << "    void sync() { ::msync(_data, _size, MS_SYNC); }\n\n";
+
+    content << "    /// @brief Get the size of a record with a payload of the given length.\n";
+    content << "    static std::size_t record_bytes(std::size_t length)\n";
+    content << "    {\n";
+    content << "        return sizeof(MessageLogRecordHeader) + (length + 7) / 8 * 8;\n";
+    content << "    }\n\n";
+
+    content << "    const std::uint8_t* data() const { return _data; }\n";
+    content << "    std::size_t size() const { return _size; }\n";
+    content << "    std::uint64_t base_offset() const { return _baseOffset; }\n";
+    content << "    const std::string& path() const { return _path; }\n";
+    content << "    std::string index_path() const { return _path.substr(0, _path.size() - 4) + \".idx\"; }\n\n";
+
+    content << "private:\n";
+    content << "    MessageLogSegment(std::string path, std::uint8_t* data, std::size_t size)\n";
+    content << "        : _path(std::move(path))\n";
+    content << "        , _data(data)\n";
+    content << "        , _size(size)\n";
+    content << "    {\n";
+    content << "    }\n\n";
+
+    content << "    [[noreturn]] static void _fail(const char* call, const std::string& path)\n";
+    content << "    {\n";
+    content << "        throw std::runtime_error(std::string(\"Message log \") + call + \" failed for \" + path + \": \" + std::strerror(errno));\n";
+    content << "    }\n\n";
+
+    content << "    std::string   _path;\n";
+    content << "    std::uint8_t* _data;\n";
+    content << "    std::size_t   _size;\n";
+    content << "    std::uint64_t _baseOffset = 0;\n";
+    content << "};\n\n";
+
+    content << "/// @brief One record read from a message log.\n";
+    content << "struct MessageLogEntry\n";
+    content << "{\n";
+    content << "    std::uint64_t offset = 0;\n";
+    content << "    std::int64_t  timestamp_ns = 0;\n";
+    content << "    MessageType   type{};\n\n";
+
+    content << "    /// @brief The serialized message: a zero-copy view into the mapped segment.\n";
+    content << "    SharedSerializedData data;\n\n";
+
+    content << "    /// @brief Wrap the record for typed views without decoding it.\n";
+    content << "    std::optional<RawMessage> raw() const { return RawMessage::parse(data); }\n\n";
+
+    content << "    /// @brief Decode the record through the factory.\n";
+    content << "    /// @return The message, or nullptr if the type is unknown or the data is malformed.\n";
+    content << "    std::shared_ptr<MessageBase> to_object() const\n";
+    content << "    {\n";
+    content << "        try\n";
+    content << "        {\n";
+    content << "            std::shared_ptr<MessageBase> message = FactoryBuilder::createMessage(type);\n";
+    content << "            return message->deserialize(data) ? message : nullptr;\n";
+    content << "        }\n";
+    content << "        catch (...)\n";
+    content << "        {\n";
+    content << "            return nullptr;\n";
+    content << "        }\n";
+    content << "    }\n";
+    content << "};\n\n";
+
+    content << "/// @brief Appends framed messages to memory-mapped segment files.\n";
+    content << "/// @details Each record carries its type, a timestamp and a log-wide offset. A segment is\n";
+    content << "///          sealed (index written, data synced) when the next record does not fit, and the\n";
+    content << "///          next one starts at the following offset. Reopening a directory resumes after the\n";
+    content << "///          last complete record. Appends are not thread-safe.\n";
+    content << "class MessageLogWriter\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    /// @brief Open or create a log directory.\n";
+    content << "    /// @param directory Directory holding the segment files.\n";
+    content << "    /// @param options Segment and index tuning.\n";
+    content << "    explicit MessageLogWriter(std::string directory, MessageLogOptions options = {})\n";
+    content << "        : _directory(std::move(directory))\n";
+    content << "        , _options(options)\n";
+    content << "    {\n";
+    content << "        std::filesystem::create_directories(_directory);\n";
+    content << "        const auto paths = MessageLogSegment::list(_directory);\n";
+    content << "        if (!paths.empty())\n";
+    content << "        {\n";
+    content << "            // Resume after the last complete record of the newest segment\n";
+    content << "            _segmentSptr = MessageLogSegment::open(paths.back(), 0, _options.segment_bytes);\n";
+    content << "            _nextOffset = _segmentSptr->base_offset();\n";
+    content << "            _position = _segmentSptr->scan(_options.index_interval_bytes, _index, _nextOffset);\n";
+    content << "            _nextIndexPosition = _index.empty() ? _position : _index.back().position + _options.index_interval_bytes;\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    MessageLogWriter(const MessageLogWriter&) = delete;\n";
+    content << "    MessageLogWriter& operator=(const MessageLogWriter&) = delete;\n\n";
+
+    content << "    /// @brief Seal the active segment.\n";
+    content << "    ~MessageLogWriter()\n";
+    content << "    {\n";
+    content << "        if (_segmentSptr)\n";
+    content << "        {\n";
+    content << "            _segmentSptr->seal(_index, _options.sync_on_rotate);\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Append a message.\n";
+    content << "    /// @param message The message to record.\n";
+    content << "    /// @param timestamp_ns Record time in nanoseconds since the epoch (defaults to now).\n";
+    content << "    /// @return The offset of the record.\n";
+    content << "    std::uint64_t append(const MessageBase& message, std::int64_t timestamp_ns = now())\n";
+    content << "    {\n";
+    content << "        const SerializedData data = message.serialize_fast();\n";
+    content << "        return append(static_cast<MessageType>(message.get_message_id()), data.bytes(), data.size(), timestamp_ns);\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Append an already serialized message.\n";
+    content << "    /// @param type The message type.\n";
+    content << "    /// @param data Flat-array message bytes.\n";
+    content << "    /// @param size Size of the data in bytes.\n";
+    content << "    /// @param timestamp_ns Record time in nanoseconds since the epoch.\n";
+    content << "    /// @return The offset of the record.\n";
+    content << "    std::uint64_t append(MessageType type, const std::uint8_t* data, std::size_t size, std::int64_t timestamp_ns)\n";
+    content << "    {\n";
+    content << "        const std::uint64_t offset = _nextOffset;\n";
+    content << "        _append_at(offset, static_cast<std::uint32_t>(type), data, size, timestamp_ns);\n";
+    content << "        return offset;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Flush the active segment to disk.\n";
+    content << "    void flush()\n";
+    content << "    {\n";
+    content << "        if (_segmentSptr)\n";
+    content << "        {\n";
+    content << "            _segmentSptr->sync();\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Get the offset the next record will get.\n";
+    content << "    std::uint64_t next_offset() const { return _nextOffset; }\n\n";
+
+    content << "    /// @brief Get the current time in nanoseconds since the epoch.\n";
+    content << "    static std::int64_t now()\n";
+    content << "    {\n";
+    content << "        return std::chrono::duration_cast<std::chrono::nanoseconds>(\n";
+    content << "            std::chrono::system_clock::now().time_since_epoch()).count();\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Copy a log keeping only the newest record of each key.\n";
+    content << "    /// @details Records keep their offsets and timestamps; records without a key are all kept.\n";
+    content << "    /// @param source Directory of the log to compact.\n";
+    content << "    /// @param target Directory for the compacted log (should be empty).\n";
+    content << "    /// @param key_of Returns the key of an entry, or std::nullopt to always keep it.\n";
+    content << "    /// @param options Segment and index tuning for the new log.\n";
+    content << "    /// @return The number of records kept.\n";
+    content << "    template<typename KeyFn>\n";
+    content << "    static std::size_t compact(const std::string& source, const std::string& target, KeyFn&& key_of,\n";
+    content << "                               MessageLogOptions options = {});\n\n";
+
+    content << "private:\n";
+    content << "    void _append_at(std::uint64_t offset, std::uint32_t type, const std::uint8_t* data, std::size_t size,\n";
+    content << "                    std::int64_t timestamp_ns)\n";
+    content << "    {\n";
+    content << "        if (size == 0 || size > std::numeric_limits<std::uint32_t>::max())\n";
+    content << "        {\n";
+    content << "            throw std::invalid_argument(\"Message log records must hold 1 byte to 4 GiB\");\n";
+    content << "        }\n\n";
+
+    content << "        const std::size_t record_bytes = MessageLogSegment::record_bytes(size);\n";
+    content << "        if (!_segmentSptr || _position + record_bytes > _segmentSptr->size())\n";
+    content << "        {\n";
+    content << "            _rotate(offset, record_bytes);\n";
+    content << "        }\n\n";
+
+    content << "        const MessageLogRecordHeader header{static_cast<std::uint32_t>(size), type, offset, timestamp_ns};\n";
+    content << "        if (_position >= _nextIndexPosition)\n";
+    content << "        {\n";
+    content << "            _index.push_back({offset, timestamp_ns, _position});\n";
+    content << "            _nextIndexPosition = _position + _options.index_interval_bytes;\n";
+    content << "        }\n";
+    content << "        _segmentSptr->write_at(_position, header, data);\n";
+    content << "        _position += record_bytes;\n";
+    content << "        _nextOffset = offset + 1;\n";
+    content << "    }\n\n";
+
+    content << "    void _rotate(std::uint64_t base_offset, std::size_t record_bytes)\n";
+    content << "    {\n";
+    content << "        if (_segmentSptr)\n";
+    content << "        {\n";
+    content << "            _segmentSptr->seal(_index, _options.sync_on_rotate);\n";
+    content << "        }\n\n";
+
+    content << "        // Room for the record and a zero length after it\n";
+    content << "        const std::size_t capacity = std::max(_options.segment_bytes,\n";
+    content << "                                              MessageLogSegment::_k_header_bytes + record_bytes + sizeof(std::uint64_t));\n";
+    content << "        _segmentSptr = MessageLogSegment::open(MessageLogSegment::path_for(_directory, base_offset), base_offset, capacity);\n";
+    content << "        _index.clear();\n";
+    content << "        _position = MessageLogSegment::_k_header_bytes;\n";
+    content << "        _nextIndexPosition = _position;\n";
+    content << "    }\n\n";
+
+    content << "    std::string                         _directory;\n";
+    content << "    MessageLogOptions                   _options;\n";
+    content << "    std::shared_ptr<MessageLogSegment>  _segmentSptr;\n";
+    content << "    std::vector<MessageLogIndexEntry>   _index;\n";
+    content << "    std::size_t                         _position = 0;\n";
+    content << "    std::size_t                         _nextIndexPosition = 0;\n";
+    content << "    std::uint64_t                       _nextOffset = 0;\n";
+    content << "};\n\n";
+
+    content << "/// @brief Iterates a message log through read-only mappings.\n";
+    content << "/// @details Entries are zero-copy views that keep their segment mapped. The reader can follow a\n";
+    content << "///          log that is still being written: next() returns false at the current end, and\n";
+    content << "///          refresh() picks up segments created since. Seeking assumes timestamps never decrease.\n";
+    content << "class MessageLogReader\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    /// @brief Open a log directory and position at the first record.\n";
+    content << "    explicit MessageLogReader(std::string directory)\n";
+    content << "        : _directory(std::move(directory))\n";
+    content << "    {\n";
+    content << "        refresh();\n";
+    content << "        _position = MessageLogSegment::_k_header_bytes;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Map segments created since the last call.\n";
+    content << "    void refresh()\n";
+    content << "    {\n";
+    content << "        for (const auto& path : MessageLogSegment::list(_directory))\n";
+    content << "        {\n";
+    content << "            if (!_segments.empty() && path <= _segments.back().segment->path())\n";
+    content << "            {\n";
+    content << "                continue;\n";
+    content << "            }\n";
+    content << "            Segment segment;\n";
+    content << "            segment.segment = MessageLogSegment::open(path, 0, 0);\n";
+    content << "            if (!segment.segment->load_index(segment.index))\n";
+    content << "            {\n";
+    content << "                std::uint64_t next_offset = 0;\n";
+    content << "                segment.segment->scan(_k_scan_interval, segment.index, next_offset);\n";
+    content << "            }\n";
+    content << "            _segments.push_back(std::move(segment));\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Read the next record.\n";
+    content << "    /// @param entry Receives the record; records with an unknown type are skipped.\n";
+    content << "    /// @return False at the end of the written data.\n";
+    content << "    bool next(MessageLogEntry& entry)\n";
+    content << "    {\n";
+    content << "        while (true)\n";
+    content << "        {\n";
+    content << "            if (_current >= _segments.size())\n";
+    content << "            {\n";
+    content << "                refresh();\n";
+    content << "                if (_current >= _segments.size())\n";
+    content << "                {\n";
+    content << "                    return false;\n";
+    content << "                }\n";
+    content << "            }\n\n";
+
+    content << "            const auto& segment = _segments[_current].segment;\n";
+    content << "            MessageLogRecordHeader header{};\n";
+    content << "            if (segment->header_at(_position, header))\n";
+    content << "            {\n";
+    content << "                entry.offset = header.offset;\n";
+    content << "                entry.timestamp_ns = header.timestamp_ns;\n";
+    content << "                if (!isValidMessageType(header.type))\n";
+    content << "                {\n";
+    content << "                    // Not written by this schema's append(); skip rather than mislabel it\n";
+    content << "                    _position += MessageLogSegment::record_bytes(header.length);\n";
+    content << "                    continue;\n";
+    content << "                }\n";
+    content << "                entry.type = static_cast<MessageType>(header.type);\n";
+    content << "                entry.data = SharedSerializedData(segment, segment->data() + _position + sizeof(MessageLogRecordHeader), header.length);\n";
+    content << "                _position += MessageLogSegment::record_bytes(header.length);\n";
+    content << "                return true;\n";
+    content << "            }\n";
+    content << "            if (_current + 1 == _segments.size())\n";
+    content << "            {\n";
+    content << "                refresh();\n";
+    content << "                if (_current + 1 == _segments.size())\n";
+    content << "                {\n";
+    content << "                    return false;\n";
+    content << "                }\n";
+    content << "            }\n";
+    content << "            ++_current;\n";
+    content << "            _position = MessageLogSegment::_k_header_bytes;\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Position at the first record with an offset at or after the given one.\n";
+    content << "    void seek_offset(std::uint64_t offset)\n";
+    content << "    {\n";
+    content << "        _seek([offset](const MessageLogIndexEntry& point) { return point.offset <= offset; },\n";
+    content << "              [offset](const MessageLogRecordHeader& header) { return header.offset >= offset; });\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Position at the first record with a timestamp at or after the given one.\n";
+    content << "    void seek_time(std::int64_t timestamp_ns)\n";
+    content << "    {\n";
+    content << "        _seek([timestamp_ns](const MessageLogIndexEntry& point) { return point.timestamp_ns <= timestamp_ns; },\n";
+    content << "              [timestamp_ns](const MessageLogRecordHeader& header) { return header.timestamp_ns >= timestamp_ns; });\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Decode the remaining records through the factory and hand them to a handler.\n";
+    content << "    /// @param handler Called with each decoded std::shared_ptr<MessageBase>.\n";
+    content << "    /// @param speed Playback rate relative to the recorded timestamps (2.0 is twice as fast);\n";
+    content << "    ///              0 replays as fast as possible.\n";
+    content << "    /// @return The number of messages delivered (malformed or unknown records are skipped).\n";
+    content << "    template<typename Handler>\n";
+    content << "    std::size_t replay(Handler&& handler, double speed = 1.0)\n";
+    content << "    {\n";
+    content << "        const auto start = std::chrono::steady_clock::now();\n";
+    content << "        std::optional<std::int64_t> first_timestamp;\n";
+    content << "        std::size_t delivered = 0;\n";
+    content << "        MessageLogEntry entry;\n";
+    content << "        while (next(entry))\n";
+    content << "        {\n";
+    content << "            if (speed > 0)\n";
+    content << "            {\n";
+    content << "                if (!first_timestamp)\n";
+    content << "                {\n";
+    content << "                    first_timestamp = entry.timestamp_ns;\n";
+    content << "                }\n";
+    content << "                const auto elapsed = static_cast<double>(entry.timestamp_ns - *first_timestamp) / speed;\n";
+    content << "                std::this_thread::sleep_until(start + std::chrono::nanoseconds(static_cast<std::int64_t>(elapsed)));\n";
+    content << "            }\n";
+    content << "            if (auto message = entry.to_object())\n";
+    content << "            {\n";
+    content << "                handler(std::move(message));\n";
+    content << "                ++delivered;\n";
+    content << "            }\n";
+    content << "        }\n";
+    content << "        return delivered;\n";
+    content << "    }\n\n";
+
+    content << "private:\n";
+    content << "    struct Segment\n";
+    content << "    {\n";
+    content << "        std::shared_ptr<MessageLogSegment> segment;\n";
+    content << "        std::vector<MessageLogIndexEntry>  index;\n";
+    content << "    };\n\n";
+
+    content << "    /// @brief Index spacing used when a segment has no sealed index yet.\n";
+    content << "    static constexpr std::size_t _k_scan_interval = std::size_t{64} << 10;\n\n";
+
+    content << "    template<typename IndexBefore, typename Reached>\n";
+    content << "    void _seek(IndexBefore index_before, Reached reached)\n";
+    content << "    {\n";
+    content << "        refresh();\n\n";
+
+    content << "        // Last segment, then last index point, that starts at or before the target\n";
+    content << "        _current = 0;\n";
+    content << "        for (std::size_t i = 1; i < _segments.size(); ++i)\n";
+    content << "        {\n";
+    content << "            if (!_segments[i].index.empty() && index_before(_segments[i].index.front()))\n";
+    content << "            {\n";
+    content << "                _current = i;\n";
+    content << "            }\n";
+    content << "        }\n";
+    content << "        _position = MessageLogSegment::_k_header_bytes;\n";
+    content << "        if (_current < _segments.size())\n";
+    content << "        {\n";
+    content << "            for (const auto& point : _segments[_current].index)\n";
+    content << "            {\n";
+    content << "                if (!index_before(point))\n";
+    content << "                {\n";
+    content << "                    break;\n";
+    content << "                }\n";
+    content << "                _position = point.position;\n";
+    content << "            }\n";
+    content << "        }\n\n";
+
+    content << "        // Scan forward to the first record that reaches the target\n";
+    content << "        while (_current < _segments.size())\n";
+    content << "        {\n";
+    content << "            const auto& segment = _segments[_current].segment;\n";
+    content << "            MessageLogRecordHeader header{};\n";
+    content << "            while (segment->header_at(_position, header))\n";
+    content << "            {\n";
+    content << "                if (reached(header))\n";
+    content << "                {\n";
+    content << "                    return;\n";
+    content << "                }\n";
+    content << "                _position += MessageLogSegment::record_bytes(header.length);\n";
+    content << "            }\n";
+    content << "            if (_current + 1 == _segments.size())\n";
+    content << "            {\n";
+    content << "                return;\n";
+    content << "            }\n";
+    content << "            ++_current;\n";
+    content << "            _position = MessageLogSegment::_k_header_bytes;\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    std::string          _directory;\n";
+    content << "    std::vector<Segment> _segments;\n";
+    content << "    std::size_t          _current = 0;\n";
+    content << "    std::size_t          _position = 0;\n";
+    content << "};\n\n";
+
+    content << "template<typename KeyFn>\n";
+    content << "std::size_t MessageLogWriter::compact(const std::string& source, const std::string& target, KeyFn&& key_of,\n";
+    content << "                                      MessageLogOptions options)\n";
+    content << "{\n";
+    content << "    // First pass: the newest offset of every key\n";
+    content << "    std::unordered_map<std::string, std::uint64_t> newest;\n";
+    content << "    {\n";
+    content << "        MessageLogReader reader(source);\n";
+    content << "        MessageLogEntry entry;\n";
+    content << "        while (reader.next(entry))\n";
+    content << "        {\n";
+    content << "            if (std::optional<std::string> key = key_of(entry))\n";
+    content << "            {\n";
+    content << "                newest[std::move(*key)] = entry.offset;\n";
+    content << "            }\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    // Second pass: copy the survivors, keeping their offsets and timestamps\n";
+    content << "    MessageLogWriter writer(target, options);\n";
+    content << "    MessageLogReader reader(source);\n";
+    content << "    MessageLogEntry entry;\n";
+    content << "    std::size_t kept = 0;\n";
+    content << "    while (reader.next(entry))\n";
+    content << "    {\n";
+    content << "        std::optional<std::string> key = key_of(entry);\n";
+    content << "        if (key && newest.at(*key) != entry.offset)\n";
+    content << "        {\n";
+    content << "            continue;\n";
+    content << "        }\n";
+    content << "        writer._append_at(entry.offset, static_cast<std::uint32_t>(entry.type), entry.data.bytes(), entry.data.size(),\n";
+    content << "                          entry.timestamp_ns);\n";
+    content << "        ++kept;\n";
+    content << "    }\n";
+    content << "    return kept;\n";
+    content << "}\n";
+
+    return content.str();
+}
+
+// ---- Private instance methods ----
+
+std::string CppMessageLogGenerator::_generate_message_log_content() const
+{
+    std::ostringstream content;
+
+    // Use wrapper_namespace_name if specified, otherwise fall back to namespace_name
+    const std::string& raw_ns = _schema.wrapper_namespace_name.empty() ?
+                                  _schema.namespace_name : _schema.wrapper_namespace_name;
+    const std::string ns = raw_ns.empty() ?
+                             "curious::net" :
+                             string_utils::to_cpp_namespace(raw_ns);
+
+    content << "#pragma once\n\n";
+    content << "#ifndef MESSAGELOG_HPP\n";
+    content << "#define MESSAGELOG_HPP\n\n";
+
+    // Includes
+    content << "#include <algorithm>\n";
+    content << "#include <atomic>\n";
+    content << "#include <cerrno>\n";
+    content << "#include <chrono>\n";
+    content << "#include <cstddef>\n";
+    content << "#include <cstdint>\n";
+    content << "#include <cstdio>\n";
+    content << "#include <cstring>\n";
+    content << "#include <filesystem>\n";
+    content << "#include <fstream>\n";
+    content << "#include <limits>\n";
+    content << "#include <memory>\n";
+    content << "#include <optional>\n";
+    content << "#include <stdexcept>\n";
+    content << "#include <string>\n";
+    content << "#include <thread>\n";
+    content << "#include <unordered_map>\n";
+    content << "#include <utility>\n";
+    content << "#include <vector>\n\n";
+    content << "#include <fcntl.h>\n";
+    content << "#include <sys/mman.h>\n";
+    content << "#include <sys/stat.h>\n";
+    content << "#include <unistd.h>\n\n";
+    content << "#include <" << _includePrefix << "MessageBase.hpp>\n";
+    content << "#include <" << _includePrefix << "RawMessage.hpp>\n";
+    content << "#include <" << _includePrefix << "enums.hpp>\n";
+    content << "#include <" << _includePrefix << "factory_builder.h>\n\n";
+
+    // Open namespace
+    content << "namespace " << ns << "\n";
+    content << "{\n\n";
+
+    content << _generate_log_classes();
+
+    // Close namespace
+    content << "\n} // namespace " << ns << "\n\n";
+
+    // Close header guard
+    content << "#endif // MESSAGELOG_HPP\n";
+
+    return content.str();
+}
+
+} // namespace curious::dsl::capnpgen
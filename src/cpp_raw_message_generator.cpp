@@ -0,0 +1,255 @@
+#include "cpp_raw_message_generator.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "string_utils.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+// ---- Constructor ----
+
+CppRawMessageGenerator::CppRawMessageGenerator(const Schema& schema, const std::string& output_directory, const std::string& include_prefix)
+    : _schema(schema)
+    , _outputDirectory(_resolve_output_directory(output_directory))
+    , _includePrefix(include_prefix)
+{
+    namespace fs = std::filesystem;
+
+    // Construct output file path
+    fs::path output_file_path = fs::path(_outputDirectory) / "RawMessage.hpp";
+
+    // Generate content
+    std::string content = _generate_raw_message_content();
+
+    // Write to file
+    std::ofstream output_file(output_file_path, std::ios::binary);
+    if (!output_file)
+    {
+        throw std::runtime_error("Failed to create RawMessage header file: " + output_file_path.string());
+    }
+
+    output_file << content;
+}
+
+// ---- Private static methods ----
+
+std::string CppRawMessageGenerator::_resolve_output_directory(const std::string& path)
+{
+    namespace fs = std::filesystem;
+    fs::create_directories(path);
+    return path;
+}
+
+// ---- Private instance methods ----
+
+std::string CppRawMessageGenerator::_generate_raw_message_content()
+{
+    std::ostringstream content;
+
+    // Use wrapper_namespace_name if specified, otherwise fall back to namespace_name
+    const std::string& raw_ns = _schema.wrapper_namespace_name.empty() ?
+                                  _schema.namespace_name : _schema.wrapper_namespace_name;
+    const std::string ns = raw_ns.empty() ?
+                             "curious::net" :
+                             string_utils::to_cpp_namespace(raw_ns);
+
+    // Header guard
+    content << "#pragma once\n\n";
+    content << "#ifndef RAWMESSAGE_HPP\n";
+    content << "#define RAWMESSAGE_HPP\n\n";
+
+    // Includes
+    content << "#include <cstdint>\n";
+    content << "#include <memory>\n";
+    content << "#include <optional>\n";
+    content << "#include <utility>\n\n";
+    content << "#include <capnp/any.h>\n";
+    content << "#include <capnp/serialize.h>\n";
+    content << "#include <kj/array.h>\n\n";
+    content << "#include <" << _includePrefix << "MessageBase.hpp>\n";
+    content << "#include <" << _includePrefix << "enums.hpp>\n";
+    content << "#include <" << _includePrefix << "factory_builder.h>\n\n";
+
+    // Open namespace
+    content << "namespace " << ns << "\n";
+    content << "{\n\n";
+
+    content << "/// @brief Validated handle over a received message that is never decoded or re-encoded.\n";
+    content << "/// @details Owns the received bytes, exposes the message type and Cap'n Proto views for\n";
+    content << "///          peeking routing fields, and forwards the original bytes to any writer.\n";
+    content << "///          Because inherited fields are flattened in declaration order, any message can\n";
+    content << "///          be viewed as one of its parents (e.g., view<Request>().getRequestId()).\n";
+    content << "class RawMessage\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    /// @brief Adopt and validate a received buffer.\n";
+    content << "    /// @param data The received message bytes (flat array encoding).\n";
+    content << "    /// @return The handle, or std::nullopt if the bytes are not a valid message, have no msgType\n";
+    content << "    ///         or carry an unknown type.\n";
+    content << "    static std::optional<RawMessage> parse(SharedSerializedData data)\n";
+    content << "    {\n";
+    content << "        // Cap'n Proto reads words in place; realign unaligned slices once\n";
+    content << "        if (reinterpret_cast<std::uintptr_t>(data.bytes()) % alignof(capnp::word) != 0)\n";
+    content << "        {\n";
+    content << "            data = SharedSerializedData::copy_of(data.bytes(), data.size());\n";
+    content << "        }\n\n";
+
+    content << "        try\n";
+    content << "        {\n";
+    content << "            RawMessage message(std::move(data));\n\n";
+
+    content << "            // Walk every pointer once so later views cannot hit out-of-bounds data\n";
+    content << "            auto root = message._readerUptr->getRoot<::capnp::AnyStruct>();\n";
+    content << "            root.totalSize();\n\n";
+
+    content << "            // A data section too short for msgType leaves the type unknown\n";
+    content << "            auto data_section = root.getDataSection();\n";
+    content << "            if (data_section.size() < sizeof(std::uint16_t))\n";
+    content << "            {\n";
+    content << "                return std::nullopt;\n";
+    content << "            }\n\n";
+
+    content << "            // msgType is always field @0: the first little-endian UInt16 of the data section\n";
+    content << "            std::uint16_t raw_type = static_cast<std::uint16_t>(data_section[0]) |\n";
+    content << "                                     static_cast<std::uint16_t>(data_section[1] << 8);\n";
+    content << "            if (!isValidMessageType(raw_type))\n";
+    content << "            {\n";
+    content << "                return std::nullopt;\n";
+    content << "            }\n";
+    content << "            message._type = static_cast<MessageType>(raw_type);\n\n";
+
+    content << "            return message;\n";
+    content << "        }\n";
+    content << "        catch (...)\n";
+    content << "        {\n";
+    content << "            return std::nullopt;\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Adopt and validate a received frame.\n";
+    content << "    /// @param frame The received message bytes.\n";
+    content << "    /// @return The handle, or std::nullopt if the bytes are not a valid message.\n";
+    content << "    static std::optional<RawMessage> parse(std::vector<std::uint8_t>&& frame)\n";
+    content << "    {\n";
+    content << "        return parse(SharedSerializedData(std::move(frame)));\n";
+    content << "    }\n\n";
+
+    content << "    // Move-only semantics (the reader points into the owned buffer)\n";
+    content << "    RawMessage(const RawMessage&) = delete;\n";
+    content << "    RawMessage& operator=(const RawMessage&) = delete;\n";
+    content << "    RawMessage(RawMessage&&) noexcept = default;\n";
+    content << "    RawMessage& operator=(RawMessage&&) noexcept = default;\n";
+    content << "    ~RawMessage() = default;\n\n";
+
+    content << "    /// @brief Get the message type read from the msgType header field.\n";
+    content << "    MessageType type() const { return _type; }\n\n";
+
+    content << "    /// @brief Peek fields through a Cap'n Proto reader without decoding the message.\n";
+    content << "    /// @tparam CapnpStruct The Cap'n Proto struct type (the message itself or a parent).\n";
+    content << "    /// @return A reader valid for the lifetime of this handle.\n";
+    content << "    template<typename CapnpStruct>\n";
+    content << "    typename CapnpStruct::Reader view() const\n";
+    content << "    {\n";
+    content << "        return _readerUptr->getRoot<CapnpStruct>();\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Decode into an owned message object on demand.\n";
+    content << "    /// @tparam Message The generated message class.\n";
+    content << "    /// @param message The object to populate.\n";
+    content << "    /// @return True if decoding succeeded, false otherwise.\n";
+    content << "    template<typename Message>\n";
+    content << "    bool to_message(Message& message) const\n";
+    content << "    {\n";
+    content << "        try\n";
+    content << "        {\n";
+    content << "            message.from_capnp(*_readerUptr);\n";
+    content << "            return true;\n";
+    content << "        }\n";
+    content << "        catch (...)\n";
+    content << "        {\n";
+    content << "            return false;\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Decode into a message object created by the factory from type().\n";
+    content << "    /// @return The decoded message, or nullptr if the type has no message class or decoding failed.\n";
+    content << "    std::shared_ptr<MessageBase> to_object() const\n";
+    content << "    {\n";
+    content << "        try\n";
+    content << "        {\n";
+    content << "            std::shared_ptr<MessageBase> message = FactoryBuilder::createMessage(_type);\n";
+    content << "            return message->deserialize(_data) ? message : nullptr;\n";
+    content << "        }\n";
+    content << "        catch (...)\n";
+    content << "        {\n";
+    content << "            return nullptr;\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Get the original bytes as a refcounted buffer.\n";
+    content << "    const SharedSerializedData& data() const { return _data; }\n\n";
+
+    content << "    /// @brief Get data as byte pointer.\n";
+    content << "    const std::uint8_t* bytes() const { return _data.bytes(); }\n\n";
+
+    content << "    /// @brief Get size in bytes.\n";
+    content << "    std::size_t size() const { return _data.size(); }\n\n";
+
+    content << "    /// @brief Hand the original bytes to a SerializedData writer without copying.\n";
+    content << "    /// @details The returned array keeps the buffer alive and must be treated as read-only.\n";
+    content << "    SerializedData to_serialized_data() const\n";
+    content << "    {\n";
+    content << "        auto words = _data.words();\n";
+    content << "        if (words.size() == 0)\n";
+    content << "        {\n";
+    content << "            return SerializedData();\n";
+    content << "        }\n\n";
+
+    content << "        // The disposer owns a buffer reference and deletes itself when the array is released\n";
+    content << "        auto* disposer = new SharedArrayDisposer(_data);\n";
+    content << "        return SerializedData(kj::Array<capnp::word>(const_cast<capnp::word*>(words.begin()),\n";
+    content << "                                                     words.size(), *disposer));\n";
+    content << "    }\n\n";
+
+    content << "private:\n";
+    content << "    /// @brief Array disposer that keeps a SharedSerializedData alive until disposal.\n";
+    content << "    class SharedArrayDisposer final : public kj::ArrayDisposer\n";
+    content << "    {\n";
+    content << "    public:\n";
+    content << "        explicit SharedArrayDisposer(SharedSerializedData data) : _data(std::move(data)) {}\n\n";
+
+    content << "    protected:\n";
+    content << "        void disposeImpl(void*, size_t, size_t, size_t, void (*)(void*)) const override\n";
+    content << "        {\n";
+    content << "            delete this;\n";
+    content << "        }\n\n";
+
+    content << "    private:\n";
+    content << "        SharedSerializedData _data;\n";
+    content << "    };\n\n";
+
+    content << "    explicit RawMessage(SharedSerializedData&& data)\n";
+    content << "        : _data(std::move(data))\n";
+    content << "        , _readerUptr(std::make_unique<::capnp::FlatArrayMessageReader>(_data.words()))\n";
+    content << "    {\n";
+    content << "    }\n\n";
+
+    content << "    SharedSerializedData                            _data;\n";
+    content << "    std::unique_ptr<::capnp::FlatArrayMessageReader> _readerUptr;\n";
+    content << "    MessageType                                     _type = static_cast<MessageType>(0);\n";
+    content << "};\n\n";
+
+    // Close namespace
+    content << "} // namespace " << ns << "\n\n";
+
+    // Close header guard
+    content << "#endif // RAWMESSAGE_HPP\n";
+
+    return content.str();
+}
+
+} // namespace curious::dsl::capnpgen
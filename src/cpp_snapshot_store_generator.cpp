@@ -0,0 +1,540 @@
+#include "cpp_snapshot_store_generator.hpp"
+
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "string_utils.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+// ---- Constructor ----
+
+CppSnapshotStoreGenerator::CppSnapshotStoreGenerator(const Schema& schema, const std::string& output_directory, const std::string& include_prefix)
+    : _schema(schema)
+    , _outputDirectory(_resolve_output_directory(output_directory))
+    , _includePrefix(include_prefix)
+{
+    // Use wrapper_namespace_name if specified, otherwise fall back to namespace_name
+    const std::string& raw_ns = _schema.wrapper_namespace_name.empty() ?
+                                  _schema.namespace_name : _schema.wrapper_namespace_name;
+    _namespace = raw_ns.empty() ? "curious::net" : string_utils::to_cpp_namespace(raw_ns);
+
+    _write_file("SnapshotStore.hpp", _generate_snapshot_store_content());
+
+    for (const auto& [name, message] : _schema.messages)
+    {
+        if (!message.key_field.empty())
+        {
+            _write_file(name + "SnapshotStore.hpp", _generate_message_snapshot_store_content(message));
+        }
+    }
+}
+
+// ---- Private static methods ----
+
+std::string CppSnapshotStoreGenerator::_resolve_output_directory(const std::string& path)
+{
+    namespace fs = std::filesystem;
+    fs::create_directories(path);
+    return path;
+}
+
+std::string CppSnapshotStoreGenerator::_generate_store_classes()
+{
+    std::ostringstream content;
+
+    content << "/// @brief Fixed header at the start of a snapshot store file.\n";
+    content << "/// @details The messages follow as word-aligned flat arrays, then the key bytes of string keys,\n";
+    content << "///          then the index sorted by key.\n";
+    content << "struct SnapshotStoreHeader\n";
+    content << "{\n";
+    content << "    static constexpr char _k_magic[8] = {'C', 'S', 'N', 'A', 'P', '0', '0', '1'};\n\n";
+
+    content << "    char          magic[8];\n";
+    content << "    std::uint64_t message_id;\n";
+    content << "    std::uint64_t count;\n";
+    content << "    std::uint64_t index_position;\n";
+    content << "};\n\n";
+
+    content << "/// @brief One index entry; entries are sorted by key and keys are unique.\n";
+    content << "struct SnapshotStoreIndexEntry\n";
+    content << "{\n";
+    content << "    /// @brief The integer key, or the file position of the key bytes for string keys.\n";
+    content << "    std::uint64_t key;\n\n";
+
+    content << "    /// @brief Length of the key bytes (0 for integer keys).\n";
+    content << "    std::uint64_t key_length;\n\n";
+
+    content << "    /// @brief File position and size of the serialized message.\n";
+    content << "    std::uint64_t position;\n";
+    content << "    std::uint64_t size;\n";
+    content << "};\n\n";
+
+    content << "static_assert(sizeof(SnapshotStoreHeader) == 32, \"snapshot header must stay word-aligned\");\n";
+    content << "static_assert(sizeof(SnapshotStoreIndexEntry) == 32, \"snapshot index entries must stay word-aligned\");\n\n";
+
+    content << "/// @brief Writes a snapshot store file for messages keyed by KeyTraits.\n";
+    content << "/// @details Messages are encoded and written as they are added, so only the keys stay in memory.\n";
+    content << "///          finish() sorts the index and renames the file into place, so a store opened by\n";
+    content << "///          readers is always complete. When a key is added twice, the last message wins.\n";
+    content << "/// @tparam Message The generated message class.\n";
+    content << "/// @tparam KeyTraits Provides Key (an integer or std::string_view) and key_of(message).\n";
+    content << "template<typename Message, typename KeyTraits>\n";
+    content << "class SnapshotStoreWriter\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    using Key = typename KeyTraits::Key;\n\n";
+
+    content << "    /// @brief Start writing a store; the file appears at path when finish() returns.\n";
+    content << "    /// @param path Destination file path.\n";
+    content << "    explicit SnapshotStoreWriter(std::string path)\n";
+    content << "        : _path(std::move(path))\n";
+    content << "        , _tempPath(_path + \".tmp\")\n";
+    content << "        , _file(_tempPath, std::ios::binary | std::ios::trunc)\n";
+    content << "    {\n";
+    content << "        if (!_file)\n";
+    content << "        {\n";
+    content << "            throw std::runtime_error(\"Failed to create snapshot store: \" + _tempPath);\n";
+    content << "        }\n";
+    content << "        const SnapshotStoreHeader header{};\n";
+    content << "        _write(&header, sizeof(header));\n";
+    content << "    }\n\n";
+
+    content << "    SnapshotStoreWriter(const SnapshotStoreWriter&) = delete;\n";
+    content << "    SnapshotStoreWriter& operator=(const SnapshotStoreWriter&) = delete;\n\n";
+
+    content << "    /// @brief Discard the partial file if finish() was not called.\n";
+    content << "    ~SnapshotStoreWriter()\n";
+    content << "    {\n";
+    content << "        if (!_finished)\n";
+    content << "        {\n";
+    content << "            _file.close();\n";
+    content << "            std::error_code error;\n";
+    content << "            std::filesystem::remove(_tempPath, error);\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Encode and append a message.\n";
+    content << "    void add(const Message& message)\n";
+    content << "    {\n";
+    content << "        const SerializedData data = message.serialize_fast();\n";
+    content << "        _pending.push_back({StoredKey(KeyTraits::key_of(message)), _position, data.size()});\n";
+    content << "        _write(data.bytes(), data.size());\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Encode and append every message of a range.\n";
+    content << "    template<typename Range>\n";
+    content << "    void add_all(const Range& messages)\n";
+    content << "    {\n";
+    content << "        for (const auto& message : messages)\n";
+    content << "        {\n";
+    content << "            add(message);\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Write the sorted index and publish the file.\n";
+    content << "    /// @return The number of messages in the store (one per distinct key).\n";
+    content << "    std::size_t finish()\n";
+    content << "    {\n";
+    content << "        std::stable_sort(_pending.begin(), _pending.end(),\n";
+    content << "                         [](const Pending& a, const Pending& b) { return a.key < b.key; });\n\n";
+
+    content << "        // Keep the last message of each key; string keys are written next to the index\n";
+    content << "        std::vector<SnapshotStoreIndexEntry> index;\n";
+    content << "        index.reserve(_pending.size());\n";
+    content << "        for (std::size_t i = 0; i < _pending.size(); ++i)\n";
+    content << "        {\n";
+    content << "            const Pending& pending = _pending[i];\n";
+    content << "            if (i + 1 < _pending.size() && !(pending.key < _pending[i + 1].key))\n";
+    content << "            {\n";
+    content << "                continue;\n";
+    content << "            }\n";
+    content << "            SnapshotStoreIndexEntry entry{0, 0, pending.position, pending.size};\n";
+    content << "            if constexpr (std::is_integral_v<Key>)\n";
+    content << "            {\n";
+    content << "                entry.key = static_cast<std::uint64_t>(pending.key);\n";
+    content << "            }\n";
+    content << "            else\n";
+    content << "            {\n";
+    content << "                entry.key = _position;\n";
+    content << "                entry.key_length = pending.key.size();\n";
+    content << "                _write(pending.key.data(), pending.key.size());\n";
+    content << "            }\n";
+    content << "            index.push_back(entry);\n";
+    content << "        }\n\n";
+
+    content << "        const char padding[8] = {};\n";
+    content << "        _write(padding, (8 - _position % 8) % 8);\n\n";
+
+    content << "        SnapshotStoreHeader header{};\n";
+    content << "        std::memcpy(header.magic, SnapshotStoreHeader::_k_magic, sizeof(header.magic));\n";
+    content << "        header.message_id = Message::_k_message_id;\n";
+    content << "        header.count = index.size();\n";
+    content << "        header.index_position = _position;\n";
+    content << "        _write(index.data(), index.size() * sizeof(SnapshotStoreIndexEntry));\n";
+    content << "        _file.seekp(0);\n";
+    content << "        _file.write(reinterpret_cast<const char*>(&header), sizeof(header));\n";
+    content << "        _file.close();\n";
+    content << "        if (!_file)\n";
+    content << "        {\n";
+    content << "            throw std::runtime_error(\"Failed to write snapshot store: \" + _tempPath);\n";
+    content << "        }\n\n";
+
+    content << "        std::filesystem::rename(_tempPath, _path);\n";
+    content << "        _finished = true;\n";
+    content << "        _pending.clear();\n";
+    content << "        return index.size();\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Write a store from a range of messages in one call.\n";
+    content << "    /// @return The number of messages in the store.\n";
+    content << "    template<typename Range>\n";
+    content << "    static std::size_t write(const std::string& path, const Range& messages)\n";
+    content << "    {\n";
+    content << "        SnapshotStoreWriter writer(path);\n";
+    content << "        writer.add_all(messages);\n";
+    content << "        return writer.finish();\n";
+    content << "    }\n\n";
+
+    content << "private:\n";
+    content << "    using StoredKey = std::conditional_t<std::is_integral_v<Key>, Key, std::string>;\n\n";
+
+    content << "    struct Pending\n";
+    content << "    {\n";
+    content << "        StoredKey     key;\n";
+    content << "        std::uint64_t position;\n";
+    content << "        std::uint64_t size;\n";
+    content << "    };\n\n";
+
+    content << "    void _write(const void* data, std::size_t size)\n";
+    content << "    {\n";
+    content << "        _file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));\n";
+    content << "        _position += size;\n";
+    content << "    }\n\n";
+
+    content << "    std::string          _path;\n";
+    content << "    std::string          _tempPath;\n";
+    content << "    std::ofstream        _file;\n";
+    content << "    std::vector<Pending> _pending;\n";
+    content << "    std::uint64_t        _position = 0;\n";
+    content << "    bool                 _finished = false;\n";
+    content << "};\n\n";
+
+    content << "/// @brief Read-only snapshot store served straight from a memory mapping.\n";
+    content << "/// @details open() maps the file and checks its header, so startup costs one mmap call\n";
+    content << "///          regardless of the number of messages. Lookups binary-search the sorted index\n";
+    content << "///          and return zero-copy views that keep the mapping alive. Copies share the mapping.\n";
+    content << "/// @tparam Message The generated message class.\n";
+    content << "/// @tparam KeyTraits Provides Key (an integer or std::string_view) and key_of(message).\n";
+    content << "template<typename Message, typename KeyTraits>\n";
+    content << "class SnapshotStore\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    using Key = typename KeyTraits::Key;\n\n";
+
+    content << "    /// @brief Map a store file.\n";
+    content << "    /// @param path File written by SnapshotStoreWriter.\n";
+    content << "    /// @return The store.\n";
+    content << "    /// @throws std::runtime_error if the file cannot be mapped or is not a store of Message.\n";
+    content << "    static SnapshotStore open(const std::string& path)\n";
+    content << "    {\n";
+    content << "        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);\n";
+    content << "        if (fd < 0)\n";
+    content << "        {\n";
+    content << "            _fail(\"open\", path);\n";
+    content << "        }\n";
+    content << "        struct stat info{};\n";
+    content << "        if (::fstat(fd, &info) != 0)\n";
+    content << "        {\n";
+    content << "            ::close(fd);\n";
+    content << "            _fail(\"fstat\", path);\n";
+    content << "        }\n";
+    content << "        const auto size = static_cast<std::size_t>(info.st_size);\n";
+    content << "        if (size < sizeof(SnapshotStoreHeader))\n";
+    content << "        {\n";
+    content << "            ::close(fd);\n";
+    content << "            throw std::runtime_error(\"Not a snapshot store: \" + path);\n";
+    content << "        }\n";
+    content << "        void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);\n";
+    content << "        ::close(fd);\n";
+    content << "        if (mapping == MAP_FAILED)\n";
+    content << "        {\n";
+    content << "            _fail(\"mmap\", path);\n";
+    content << "        }\n";
+    content << "        auto mapping_sptr = std::make_shared<const Mapping>(static_cast<const std::uint8_t*>(mapping), size);\n\n";
+
+    content << "        // Lookups touch a handful of scattered pages; skip readahead\n";
+    content << "        ::madvise(mapping, size, MADV_RANDOM);\n\n";
+
+    content << "        SnapshotStoreHeader header{};\n";
+    content << "        std::memcpy(&header, mapping_sptr->data, sizeof(header));\n";
+    content << "        const bool index_fits = header.index_position % 8 == 0 && header.index_position <= size &&\n";
+    content << "                                header.count <= (size - header.index_position) / sizeof(SnapshotStoreIndexEntry);\n";
+    content << "        if (std::memcmp(header.magic, SnapshotStoreHeader::_k_magic, sizeof(header.magic)) != 0 ||\n";
+    content << "            header.message_id != Message::_k_message_id || !index_fits)\n";
+    content << "        {\n";
+    content << "            throw std::runtime_error(\"Not a snapshot store of \" + std::string(Message::_k_message_name) + \": \" + path);\n";
+    content << "        }\n";
+    content << "        return SnapshotStore(std::move(mapping_sptr), header);\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Get the number of messages.\n";
+    content << "    std::size_t size() const { return _count; }\n\n";
+
+    content << "    /// @brief Check if a key is present.\n";
+    content << "    bool contains(Key key) const { return _find(key) < _count; }\n\n";
+
+    content << "    /// @brief Look a message up without decoding it.\n";
+    content << "    /// @return A view into the mapping, or std::nullopt if the key is absent or the record is malformed.\n";
+    content << "    std::optional<RawMessage> find(Key key) const\n";
+    content << "    {\n";
+    content << "        const std::size_t i = _find(key);\n";
+    content << "        return i < _count ? at(i) : std::nullopt;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Look a message up and decode it.\n";
+    content << "    /// @return False if the key is absent or the record is malformed.\n";
+    content << "    bool find(Key key, Message& message) const\n";
+    content << "    {\n";
+    content << "        auto raw = find(key);\n";
+    content << "        return raw && raw->to_message(message);\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Get the message at a position of the key order, without decoding it.\n";
+    content << "    std::optional<RawMessage> at(std::size_t i) const\n";
+    content << "    {\n";
+    content << "        SharedSerializedData data = data_at(i);\n";
+    content << "        return data ? RawMessage::parse(std::move(data)) : std::nullopt;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Get the serialized message at a position of the key order.\n";
+    content << "    /// @return A zero-copy view, or an empty one if the record lies outside the file.\n";
+    content << "    SharedSerializedData data_at(std::size_t i) const\n";
+    content << "    {\n";
+    content << "        const SnapshotStoreIndexEntry entry = _entry(i);\n";
+    content << "        if (entry.position % 8 != 0 || entry.position > _mappingSptr->size ||\n";
+    content << "            entry.size > _mappingSptr->size - entry.position)\n";
+    content << "        {\n";
+    content << "            return SharedSerializedData();\n";
+    content << "        }\n";
+    content << "        return SharedSerializedData(_mappingSptr, _mappingSptr->data + entry.position, entry.size);\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Get the key at a position of the key order (keys are sorted ascending).\n";
+    content << "    Key key_at(std::size_t i) const\n";
+    content << "    {\n";
+    content << "        const SnapshotStoreIndexEntry entry = _entry(i);\n";
+    content << "        if constexpr (std::is_integral_v<Key>)\n";
+    content << "        {\n";
+    content << "            return static_cast<Key>(entry.key);\n";
+    content << "        }\n";
+    content << "        else\n";
+    content << "        {\n";
+    content << "            if (entry.key > _mappingSptr->size || entry.key_length > _mappingSptr->size - entry.key)\n";
+    content << "            {\n";
+    content << "                return Key();\n";
+    content << "            }\n";
+    content << "            return Key(reinterpret_cast<const char*>(_mappingSptr->data + entry.key), entry.key_length);\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "private:\n";
+    content << "    /// @brief Owns the mapping; unmapped when the store and every view are gone.\n";
+    content << "    struct Mapping\n";
+    content << "    {\n";
+    content << "        Mapping(const std::uint8_t* bytes, std::size_t length) : data(bytes), size(length) {}\n";
+    content << "        Mapping(const Mapping&) = delete;\n";
+    content << "        Mapping& operator=(const Mapping&) = delete;\n";
+    content << "        ~Mapping() { ::munmap(const_cast<std::uint8_t*>(data), size); }\n\n";
+
+    content << "        const std::uint8_t* data;\n";
+    content << "        std::size_t         size;\n";
+    content << "    };\n\n";
+
+    content << "    SnapshotStore(std::shared_ptr<const Mapping> mapping, const SnapshotStoreHeader& header)\n";
+    content << "        : _mappingSptr(std::move(mapping))\n";
+    content << "        , _indexPtr(_mappingSptr->data + header.index_position)\n";
+    content << "        , _count(static_cast<std::size_t>(header.count))\n";
+    content << "    {\n";
+    content << "    }\n\n";
+
+    content << "    [[noreturn]] static void _fail(const char* call, const std::string& path)\n";
+    content << "    {\n";
+    content << "        throw std::runtime_error(std::string(\"Snapshot store \") + call + \" failed for \" + path + \": \" + std::strerror(errno));\n";
+    content << "    }\n\n";
+
+    content << "    SnapshotStoreIndexEntry _entry(std::size_t i) const\n";
+    content << "    {\n";
+    content << "        if (i >= _count)\n";
+    content << "        {\n";
+    content << "            throw std::out_of_range(\"SnapshotStore index out of range\");\n";
+    content << "        }\n";
+    content << "        SnapshotStoreIndexEntry entry{};\n";
+    content << "        std::memcpy(&entry, _indexPtr + i * sizeof(SnapshotStoreIndexEntry), sizeof(entry));\n";
+    content << "        return entry;\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Binary-search the index; returns _count if the key is absent.\n";
+    content << "    std::size_t _find(Key key) const\n";
+    content << "    {\n";
+    content << "        std::size_t low = 0;\n";
+    content << "        std::size_t high = _count;\n";
+    content << "        while (low < high)\n";
+    content << "        {\n";
+    content << "            const std::size_t middle = low + (high - low) / 2;\n";
+    content << "            if (key_at(middle) < key)\n";
+    content << "            {\n";
+    content << "                low = middle + 1;\n";
+    content << "            }\n";
+    content << "            else\n";
+    content << "            {\n";
+    content << "                high = middle;\n";
+    content << "            }\n";
+    content << "        }\n";
+    content << "        return low < _count && key_at(low) == key ? low : _count;\n";
+    content << "    }\n\n";
+
+    content << "    std::shared_ptr<const Mapping> _mappingSptr;\n";
+    content << "    const std::uint8_t*            _indexPtr = nullptr;\n";
+    content << "    std::size_t                    _count = 0;\n";
+    content << "};\n";
+
+    return content.str();
+}
+
+// ---- Private instance methods ----
+
+void CppSnapshotStoreGenerator::_write_file(const std::string& file_name, const std::string& content) const
+{
+    namespace fs = std::filesystem;
+
+    fs::path output_file_path = fs::path(_outputDirectory) / file_name;
+    std::ofstream output_file(output_file_path, std::ios::binary);
+    if (!output_file)
+    {
+        throw std::runtime_error("Failed to create snapshot store header file: " + output_file_path.string());
+    }
+
+    output_file << content;
+}
+
+std::string CppSnapshotStoreGenerator::_generate_snapshot_store_content() const
+{
+    std::ostringstream content;
+
+    content << "#pragma once\n\n";
+    content << "#ifndef SNAPSHOTSTORE_HPP\n";
+    content << "#define SNAPSHOTSTORE_HPP\n\n";
+
+    // Includes
+    content << "#include <algorithm>\n";
+    content << "#include <cerrno>\n";
+    content << "#include <cstddef>\n";
+    content << "#include <cstdint>\n";
+    content << "#include <cstring>\n";
+    content << "#include <filesystem>\n";
+    content << "#include <fstream>\n";
+    content << "#include <memory>\n";
+    content << "#include <optional>\n";
+    content << "#include <stdexcept>\n";
+    content << "#include <string>\n";
+    content << "#include <string_view>\n";
+    content << "#include <type_traits>\n";
+    content << "#include <utility>\n";
+    content << "#include <vector>\n\n";
+    content << "#include <fcntl.h>\n";
+    content << "#include <sys/mman.h>\n";
+    content << "#include <sys/stat.h>\n";
+    content << "#include <unistd.h>\n\n";
+    content << "#include <" << _includePrefix << "MessageBase.hpp>\n";
+    content << "#include <" << _includePrefix << "RawMessage.hpp>\n\n";
+
+    // Open namespace
+    content << "namespace " << _namespace << "\n";
+    content << "{\n\n";
+
+    content << _generate_store_classes();
+
+    // Close namespace
+    content << "\n} // namespace " << _namespace << "\n\n";
+
+    // Close header guard
+    content << "#endif // SNAPSHOTSTORE_HPP\n";
+
+    return content.str();
+}
+
+std::string CppSnapshotStoreGenerator::_generate_message_snapshot_store_content(const Message& message) const
+{
+    std::ostringstream content;
+
+    const Type* key_field = nullptr;
+    for (const auto& field : message.fields)
+    {
+        if (field.get_field_name() == message.key_field)
+        {
+            key_field = &field;
+        }
+    }
+    if (key_field == nullptr)
+    {
+        throw std::runtime_error("Key field not found: " + message.name + "." + message.key_field);
+    }
+
+    const bool string_key = key_field->get_capnp_type() == "Text";
+    const std::string key_type = string_key ? "std::string_view" : key_field->get_cpp_type();
+    const std::string traits_name = message.name + "SnapshotKey";
+
+    // Header guard
+    std::string guard_name;
+    for (char c : message.name + "SnapshotStore")
+    {
+        guard_name += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    guard_name += "_HPP";
+
+    content << "#pragma once\n\n";
+    content << "#ifndef " << guard_name << "\n";
+    content << "#define " << guard_name << "\n\n";
+
+    // Includes
+    content << "#include <cstdint>\n";
+    content << "#include <string_view>\n\n";
+    content << "#include <" << _includePrefix << "SnapshotStore.hpp>\n";
+    content << "#include <" << _includePrefix << message.name << ".hpp>\n\n";
+
+    // Open namespace
+    content << "namespace " << _namespace << "\n";
+    content << "{\n\n";
+
+    content << "/// @brief Indexes " << message.name << " snapshot stores by " << message.key_field << " (from @key).\n";
+    content << "struct " << traits_name << "\n";
+    content << "{\n";
+    content << "    using Key = " << key_type << ";\n\n";
+
+    content << "    static constexpr std::string_view _k_field_name = \"" << message.key_field << "\";\n\n";
+
+    content << "    static Key key_of(const " << message.name << "& message) { return message." << message.key_field << "; }\n";
+    content << "};\n\n";
+
+    content << "/// @brief Writes " << message.name << " snapshot stores, e.g. "
+            << message.name << "SnapshotWriter::write(path, messages).\n";
+    content << "using " << message.name << "SnapshotWriter = SnapshotStoreWriter<" << message.name << ", " << traits_name << ">;\n\n";
+
+    content << "/// @brief Serves " << message.name << " lookups by " << message.key_field << " from a mapped snapshot store.\n";
+    content << "using " << message.name << "SnapshotStore = SnapshotStore<" << message.name << ", " << traits_name << ">;\n\n";
+
+    // Close namespace
+    content << "} // namespace " << _namespace << "\n\n";
+
+    // Close header guard
+    content << "#endif // " << guard_name << "\n";
+
+    return content.str();
+}
+
+} // namespace curious::dsl::capnpgen
@@ -9,6 +9,7 @@
 #include <stdexcept>
 
 #include "string_utils.hpp"
+#include "struct_layout.hpp"
 #include "type_converter.hpp"
 
 namespace curious::dsl::capnpgen
@@ -65,11 +66,13 @@ std::string extract_between_markers(const std::string& content,
 CppSourceGenerator::CppSourceGenerator(const Schema& schema,
                                        const std::string& output_directory,
                                        const std::string& capnp_header_name,
-                                       const std::string& include_prefix)
+                                       const std::string& include_prefix,
+                                       bool validate_utf8)
     : _schema(schema)
     , _outputDirectory(_resolve_output_directory(output_directory))
     , _capnpHeaderName(capnp_header_name)
     , _includePrefix(include_prefix)
+    , _validateUtf8(validate_utf8)
 {
     // Initialize enum names set for proper type handling
     for (const auto& [enum_name, enum_decl] : _schema.enums)
@@ -78,9 +81,13 @@ CppSourceGenerator::CppSourceGenerator(const Schema& schema,
     }
 
     // Generate source for each message
+    // Value types are header-only
     for (const auto& [message_name, message] : _schema.messages)
     {
-        _generate_source_for_message(message);
+        if (!message.is_value_type())
+        {
+            _generate_source_for_message(message);
+        }
     }
 }
 
@@ -147,6 +154,23 @@ bool CppSourceGenerator::_is_schema_enum(const std::string& type_name) const
     return _schema.enums.find(type_name) != _schema.enums.end();
 }
 
+bool CppSourceGenerator::_is_parallel_list(const Type& field) const
+{
+    if (!field.is_list() || field.get_element_type() == nullptr)
+    {
+        return false;
+    }
+
+    // Nested messages and strings are costly per element; fixed-width lists are one memcpy
+    const Type* element_type = field.get_element_type();
+    if (element_type->is_custom())
+    {
+        const std::string& type_name = element_type->get_custom_name();
+        return !_is_schema_enum(type_name) && type_name != "MessageType";
+    }
+    return element_type->get_cpp_type() == "std::string";
+}
+
 std::string CppSourceGenerator::_generate_field_to_capnp(const Type& field, const std::string& builder_expr)
 {
     std::ostringstream code;
@@ -171,8 +195,16 @@ std::string CppSourceGenerator::_generate_field_to_capnp(const Type& field, cons
         }
     }
 
+    if (field.has_annotation("optional"))
+    {
+        code << TypeConverter::generate_optional_to_capnp_code(field, builder_expr, 1, _enumNames);
+        return code.str();
+    }
+
     // For non-enum types, use the TypeConverter (pass known enums for proper list<enum> handling)
-    code << TypeConverter::generate_to_capnp_code(field, builder_expr, field_name, field_name, 1, _enumNames);
+    code << TypeConverter::generate_to_capnp_code(field, builder_expr,
+                                                  TypeConverter::get_value_expr(field, field_name),
+                                                  field_name, 1, _enumNames);
     return code.str();
 }
 
@@ -195,8 +227,64 @@ std::string CppSourceGenerator::_generate_field_from_capnp(const Type& field, co
         }
     }
 
+    if (field.has_annotation("optional"))
+    {
+        code << TypeConverter::generate_optional_from_capnp_code(field, reader_expr, 1, _enumNames, _validateUtf8);
+        return code.str();
+    }
+
+    if (_is_parallel_list(field))
+    {
+        // Large lists are split across the executor; elements decode independently
+        std::string target = field_name;
+        std::string indent = "    ";
+        if (field.has_annotation("shared"))
+        {
+            code << "    {\n";
+            code << "        auto& " << field_name << "_value = " << field_name << ".reset();\n";
+            target = field_name + "_value";
+            indent = "        ";
+        }
+
+        const Type* element_type = field.get_element_type();
+        std::string decode_body = element_type->is_custom() ?
+                                    "value.from_capnp_struct(item);" :
+                                    "value = item;";
+        if (_validateUtf8 && element_type->get_cpp_type() == "std::string")
+        {
+            // Checked per element, so a bad string fails the decode from whichever range holds it
+            decode_body = "MessageBase::requireUtf8(item.begin(), item.size(), \"" + field_name + "\"); " +
+                          decode_body;
+        }
+
+        code << indent << "if (" << reader_expr << ".has" << capnp_method << "())\n";
+        code << indent << "{\n";
+        code << indent << "    parallelDecodeList(" << reader_expr << ".get" << capnp_method << "(), "
+             << target << ", executor,\n";
+        code << indent << "                       [](const auto& item, " << element_type->get_cpp_type()
+             << "& value) { " << decode_body << " });\n";
+        code << indent << "}\n";
+
+        if (field.has_annotation("shared"))
+        {
+            code << "    }\n";
+        }
+        return code.str();
+    }
+
+    if (field.has_annotation("shared"))
+    {
+        // Decode into a fresh, unshared value so existing snapshot holders are unaffected
+        code << "    {\n";
+        code << "        auto& " << field_name << "_value = " << field_name << ".reset();\n";
+        code << TypeConverter::generate_from_capnp_code(field, reader_expr, field_name + "_value", 2, _enumNames,
+                                                        _validateUtf8);
+        code << "    }\n";
+        return code.str();
+    }
+
     // For non-enum types, use the TypeConverter (pass known enums for proper list<enum> handling)
-    code << TypeConverter::generate_from_capnp_code(field, reader_expr, field_name, 1, _enumNames);
+    code << TypeConverter::generate_from_capnp_code(field, reader_expr, field_name, 1, _enumNames, _validateUtf8);
     return code.str();
 }
 
@@ -274,6 +362,25 @@ std::vector<Type> CppSourceGenerator::_get_all_fields(const Message& message) co
     return all_fields;
 }
 
+std::vector<UnionDecl> CppSourceGenerator::_get_all_unions(const Message& message) const
+{
+    std::vector<UnionDecl> all_unions;
+
+    // Recursively get parent unions first
+    if (!message.parent_name.empty())
+    {
+        auto parent_it = _schema.messages.find(message.parent_name);
+        if (parent_it != _schema.messages.end())
+        {
+            all_unions = _get_all_unions(parent_it->second);
+        }
+    }
+
+    all_unions.insert(all_unions.end(), message.unions.begin(), message.unions.end());
+
+    return all_unions;
+}
+
 std::string CppSourceGenerator::_generate_to_capnp(const Message& message, const std::string& user_to_capnp)
 {
     std::ostringstream code;
@@ -294,6 +401,12 @@ std::string CppSourceGenerator::_generate_to_capnp(const Message& message, const
         code << _generate_field_to_capnp(field, "root");
         code << "\n";
     }
+    for (const auto& union_decl : _get_all_unions(message))
+    {
+        code << "    // Union: " << union_decl.get_member_name() << "\n";
+        code << TypeConverter::generate_union_to_capnp_code(union_decl, "root", 1, _enumNames);
+        code << "\n";
+    }
 
     code << USER_TO_CAPNP_START << "\n";
     if (!user_to_capnp.empty())
@@ -315,11 +428,28 @@ std::string CppSourceGenerator::_generate_from_capnp(const Message& message,
 
     code << "void " << message.name << "::from_capnp(::capnp::MessageReader& message_reader)\n";
     code << "{\n";
+    code << "    InlineExecutor executor;\n";
+    code << "    from_capnp_parallel(message_reader, executor);\n";
+    code << "}\n\n";
+
+    code << "void " << message.name << "::from_capnp_parallel(::capnp::MessageReader& message_reader, "
+         << "ParallelExecutor& executor)\n";
+    code << "{\n";
     code << "    auto root = message_reader.getRoot<" << capnp_struct << ">();\n\n";
 
     // Get ALL fields including inherited ones
     auto all_fields = _get_all_fields(message);
 
+    bool has_parallel_list = false;
+    for (const auto& field : all_fields)
+    {
+        has_parallel_list = has_parallel_list || _is_parallel_list(field);
+    }
+    if (!has_parallel_list)
+    {
+        code << "    (void) executor;\n\n";
+    }
+
     // Generate field conversions for all fields (inherited + own)
     for (const auto& field : all_fields)
     {
@@ -327,6 +457,12 @@ std::string CppSourceGenerator::_generate_from_capnp(const Message& message,
         code << _generate_field_from_capnp(field, "root");
         code << "\n";
     }
+    for (const auto& union_decl : _get_all_unions(message))
+    {
+        code << "    // Union: " << union_decl.get_member_name() << "\n";
+        code << TypeConverter::generate_union_from_capnp_code(union_decl, "root", 1, _enumNames, _validateUtf8);
+        code << "\n";
+    }
 
     code << USER_FROM_CAPNP_START << "\n";
     if (!user_from_capnp.empty())
@@ -336,6 +472,12 @@ std::string CppSourceGenerator::_generate_from_capnp(const Message& message,
     code << USER_FROM_CAPNP_END << "\n";
     code << "}\n\n";
 
+    code << "void " << message.name << "::from_capnp(::capnp::MessageReader& message_reader, "
+         << "const FieldMask& mask)\n";
+    code << "{\n";
+    code << "    from_capnp_struct(message_reader.getRoot<" << capnp_struct << ">(), mask);\n";
+    code << "}\n\n";
+
     return code.str();
 }
 
@@ -352,8 +494,12 @@ std::string CppSourceGenerator::_generate_copy_from(const Message& message,
     {
         code << "    " << field.get_field_name() << " = other." << field.get_field_name() << ";\n";
     }
+    for (const auto& union_decl : message.unions)
+    {
+        code << "    " << union_decl.get_member_name() << " = other." << union_decl.get_member_name() << ";\n";
+    }
 
-    if (!message.fields.empty())
+    if (!message.fields.empty() || !message.unions.empty())
     {
         code << "\n";
     }
@@ -425,15 +571,20 @@ std::string CppSourceGenerator::_generate_source_content(const Message& message,
         content << "    : MessageBase(std::move(other))\n";
     }
 
-    // Move each field
+    // Move each field (in member declaration order)
     if (!message.fields.empty())
     {
-        for (const auto& field : message.fields)
+        for (const auto& field : StructLayout::order_members(_schema, message))
         {
             content << "    , " << field.get_field_name() << "(std::move(other."
                     << field.get_field_name() << "))\n";
         }
     }
+    for (const auto& union_decl : message.unions)
+    {
+        content << "    , " << union_decl.get_member_name() << "(std::move(other."
+                << union_decl.get_member_name() << "))\n";
+    }
     content << "{\n";
     content << "}\n\n";
 
@@ -470,6 +621,11 @@ std::string CppSourceGenerator::_generate_source_content(const Message& message,
         content << "        " << field.get_field_name() << " = std::move(other."
                 << field.get_field_name() << ");\n";
     }
+    for (const auto& union_decl : message.unions)
+    {
+        content << "        " << union_decl.get_member_name() << " = std::move(other."
+                << union_decl.get_member_name() << ");\n";
+    }
 
     content << "    }\n";
     content << "    return *this;\n";
@@ -481,12 +637,12 @@ std::string CppSourceGenerator::_generate_source_content(const Message& message,
     content << "// ---- MessageBase Interface ----\n\n";
     content << "std::uint64_t " << message.name << "::get_message_id() const\n";
     content << "{\n";
-    content << "    return " << message.id << ";\n";
+    content << "    return _k_message_id;\n";
     content << "}\n\n";
 
     content << "std::string " << message.name << "::get_message_name() const\n";
     content << "{\n";
-    content << "    return \"" << message.name << "\";\n";
+    content << "    return std::string(_k_message_name);\n";
     content << "}\n\n";
 
     content << "std::vector<std::uint8_t> " << message.name << "::serialize() const\n";
@@ -503,6 +659,14 @@ std::string CppSourceGenerator::_generate_source_content(const Message& message,
     content << "    return SerializedData(capnp::messageToFlatArray(msg_builder));\n";
     content << "}\n\n";
 
+    content << "SerializedSegments " << message.name << "::serialize_segments() const\n";
+    content << "{\n";
+    content << "    auto msg_builder = std::make_unique<::capnp::MallocMessageBuilder>();\n";
+    content << "    to_capnp(*msg_builder);\n";
+    content << "    // Scatter-gather: iovecs point straight at the builder's segments\n";
+    content << "    return SerializedSegments(std::move(msg_builder));\n";
+    content << "}\n\n";
+
     content << "bool " << message.name << "::deserialize(const std::vector<std::uint8_t>& data)\n";
     content << "{\n";
     content << "    return deserialize(data.data(), data.size());\n";
@@ -0,0 +1,338 @@
+#include "cpp_view_generator.hpp"
+
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+#include "string_utils.hpp"
+#include "type_converter.hpp"
+
+namespace curious::dsl::capnpgen
+{
+
+// ---- Constructor ----
+
+CppViewGenerator::CppViewGenerator(const Schema& schema, const std::string& output_directory, const std::string& include_prefix,
+                                   bool validate_utf8)
+    : _schema(schema)
+    , _outputDirectory(_resolve_output_directory(output_directory))
+    , _includePrefix(include_prefix)
+    , _validateUtf8(validate_utf8)
+{
+    namespace fs = std::filesystem;
+
+    for (const auto& [view_name, view] : _schema.views)
+    {
+        fs::path output_file_path = fs::path(_outputDirectory) / (view_name + ".hpp");
+
+        std::ofstream output_file(output_file_path, std::ios::binary);
+        if (!output_file)
+        {
+            throw std::runtime_error("Failed to create view header file: " + output_file_path.string());
+        }
+
+        output_file << _generate_view_content(view);
+    }
+}
+
+// ---- Private static methods ----
+
+std::string CppViewGenerator::_resolve_output_directory(const std::string& path)
+{
+    namespace fs = std::filesystem;
+    fs::create_directories(path);
+    return path;
+}
+
+std::string CppViewGenerator::_to_capnp_method_name(const std::string& field_name)
+{
+    if (field_name.empty())
+    {
+        return field_name;
+    }
+
+    std::string result = field_name;
+    result[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(result[0])));
+    return result;
+}
+
+// ---- Private instance methods ----
+
+const Type& CppViewGenerator::_find_field(const std::string& message_name, const std::string& field_name) const
+{
+    // Schema::_validate_views() guarantees the field exists in the message or a parent
+    const Message* message = &_schema.messages.at(message_name);
+    while (true)
+    {
+        for (const auto& field : message->fields)
+        {
+            if (field.get_field_name() == field_name)
+            {
+                return field;
+            }
+        }
+        message = &_schema.messages.at(message->parent_name);
+    }
+}
+
+bool CppViewGenerator::_is_schema_enum(const std::string& type_name) const
+{
+    return _schema.enums.find(type_name) != _schema.enums.end();
+}
+
+std::string CppViewGenerator::_generate_view_content(const View& view)
+{
+    std::ostringstream content;
+
+    // Use wrapper_namespace_name if specified, otherwise fall back to namespace_name
+    const std::string& raw_ns = _schema.wrapper_namespace_name.empty() ?
+                                  _schema.namespace_name : _schema.wrapper_namespace_name;
+    const std::string ns = raw_ns.empty() ?
+                             "curious::net" :
+                             string_utils::to_cpp_namespace(raw_ns);
+
+    // Get the capnp namespace
+    const std::string capnp_ns = _schema.namespace_name.empty() ?
+                                   "curious::message" :
+                                   string_utils::to_cpp_namespace(_schema.namespace_name);
+
+    // Header guard
+    std::string guard_name = view.name;
+    for (char& c : guard_name)
+    {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    guard_name += "_HPP";
+
+    content << "#pragma once\n\n";
+    content << "#ifndef " << guard_name << "\n";
+    content << "#define " << guard_name << "\n\n";
+
+    // Includes: nested views and fully decoded nested messages
+    std::set<std::string> dependencies;
+    std::vector<std::string> field_names;
+    for (const auto& view_field : view.fields)
+    {
+        const Type& field = _find_field(view.source_name, view_field.name);
+        const Type* nested_type = field.is_list() ? field.get_element_type() : &field;
+        if (!view_field.view_name.empty())
+        {
+            dependencies.insert(view_field.view_name);
+        }
+        else if (nested_type != nullptr && nested_type->is_custom() &&
+                 _schema.messages.count(nested_type->get_custom_name()) > 0)
+        {
+            dependencies.insert(nested_type->get_custom_name());
+        }
+        field_names.push_back(view_field.name);
+    }
+
+    content << "#include <cstdint>\n";
+    content << "#include <string>\n";
+    content << "#include <unordered_map>\n";
+    content << "#include <vector>\n\n";
+    content << "#include <capnp/serialize.h>\n";
+    content << "#include <kj/array.h>\n\n";
+    content << "#include \"enums.hpp\"\n";
+    if (_validateUtf8)
+    {
+        content << "#include <" << _includePrefix << "MessageBase.hpp>\n";
+    }
+    content << "#include <messages/network_msg.capnp.h>\n";
+    for (const auto& dependency : dependencies)
+    {
+        content << "#include \"" << dependency << ".hpp\"\n";
+    }
+    content << "\n";
+
+    // Open namespace
+    content << "namespace " << ns << "\n";
+    content << "{\n\n";
+
+    content << "/// @brief Projection of " << view.source_name << ":";
+    for (std::size_t i = 0; i < field_names.size(); ++i)
+    {
+        content << (i == 0 ? " " : ", ") << field_names[i];
+    }
+    content << ".\n";
+    content << "/// @details Decodes only these fields from full " << view.source_name
+            << " wire data; all other fields are skipped.\n";
+    content << "class " << view.name << "\n";
+    content << "{\n";
+    content << "public:\n";
+    content << "    // ---- Projected Fields ----\n\n";
+
+    for (const auto& view_field : view.fields)
+    {
+        const Type& field = _find_field(view.source_name, view_field.name);
+        std::string member_type = field.get_cpp_type();
+        if (!view_field.view_name.empty())
+        {
+            member_type = field.is_list() ? "std::vector<" + view_field.view_name + ">" : view_field.view_name;
+        }
+        content << "    " << member_type << " " << view_field.name << "{"
+                << (field.has_default_value() ? TypeConverter::get_default_value(field) : "") << "};\n";
+    }
+    content << "\n";
+
+    content << "    // ---- Decoding ----\n\n";
+
+    content << "    /// @brief Decode the projected fields from a serialized " << view.source_name << ".\n";
+    content << "    /// @param data Pointer to the data buffer.\n";
+    content << "    /// @param size Size of the data buffer in bytes.\n";
+    content << "    /// @return True if deserialization succeeded, false otherwise.\n";
+    content << "    bool deserialize(const std::uint8_t* data, std::size_t size)\n";
+    content << "    {\n";
+    content << "        try\n";
+    content << "        {\n";
+    content << "            kj::ArrayPtr<const capnp::word> words(reinterpret_cast<const capnp::word*>(data),\n";
+    content << "                                                  size / sizeof(capnp::word));\n";
+    content << "            ::capnp::FlatArrayMessageReader reader(words);\n";
+    content << "            from_capnp(reader);\n";
+    content << "            return true;\n";
+    content << "        }\n";
+    content << "        catch (...)\n";
+    content << "        {\n";
+    content << "            return false;\n";
+    content << "        }\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Decode the projected fields from a serialized " << view.source_name << ".\n";
+    content << "    /// @param data The serialized data.\n";
+    content << "    /// @return True if deserialization succeeded, false otherwise.\n";
+    content << "    bool deserialize(const std::vector<std::uint8_t>& data)\n";
+    content << "    {\n";
+    content << "        return deserialize(data.data(), data.size());\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Decode the projected fields from a Cap'n Proto message reader.\n";
+    content << "    /// @param message_reader The reader holding a " << view.source_name << ".\n";
+    content << "    void from_capnp(::capnp::MessageReader& message_reader)\n";
+    content << "    {\n";
+    content << "        from_capnp_struct(message_reader.getRoot<::" << capnp_ns << "::" << view.source_name << ">());\n";
+    content << "    }\n\n";
+
+    content << "    /// @brief Decode the projected fields from a Cap'n Proto struct reader.\n";
+    content << "    /// @tparam StructReader The " << view.source_name << " (or derived) struct reader type.\n";
+    content << "    /// @param reader The reader to read from.\n";
+    content << "    template<typename StructReader>\n";
+    content << "    void from_capnp_struct(const StructReader& reader)\n";
+    content << "    {\n";
+    for (const auto& view_field : view.fields)
+    {
+        content << _generate_field_decode(_find_field(view.source_name, view_field.name), view_field.view_name);
+    }
+    content << "    }\n";
+    content << "};\n\n";
+
+    // Close namespace
+    content << "} // namespace " << ns << "\n\n";
+
+    // Close header guard
+    content << "#endif // " << guard_name << "\n";
+
+    return content.str();
+}
+
+std::string CppViewGenerator::_generate_field_decode(const Type& field, const std::string& view_name)
+{
+    std::ostringstream code;
+    const std::string& field_name = field.get_field_name();
+    const std::string capnp_method = _to_capnp_method_name(field_name);
+
+    // Element (for lists) or field type, classified once for both shapes
+    const Type* value_type = field.is_list() ? field.get_element_type() : &field;
+    const bool is_message = !view_name.empty() ||
+                            (value_type->is_custom() && _schema.messages.count(value_type->get_custom_name()) > 0);
+    const bool is_enum = value_type->is_custom() &&
+                         (_is_schema_enum(value_type->get_custom_name()) || value_type->get_custom_name() == "MessageType");
+    const bool is_bytes = value_type->is_primitive() && value_type->get_cpp_type() == "std::vector<uint8_t>";
+    const bool is_checked_text = _validateUtf8 && value_type->is_primitive() && value_type->get_cpp_type() == "std::string";
+
+    if (field.is_map() || (field.is_list() && (value_type->is_list() || value_type->is_map())))
+    {
+        // Containers of containers take the generic conversion path
+        std::set<std::string> enum_names;
+        for (const auto& [enum_name, enum_decl] : _schema.enums)
+        {
+            enum_names.insert(enum_name);
+        }
+        code << TypeConverter::generate_from_capnp_code(field, "reader", field_name, 2, enum_names, _validateUtf8);
+        return code.str();
+    }
+
+    if (field.is_list())
+    {
+        code << "        if (reader.has" << capnp_method << "())\n";
+        code << "        {\n";
+        code << "            auto list_reader = reader.get" << capnp_method << "();\n";
+        code << "            " << field_name << ".clear();\n";
+        code << "            " << field_name << ".resize(list_reader.size());\n";
+        code << "            for (unsigned int i = 0; i < list_reader.size(); ++i)\n";
+        code << "            {\n";
+        if (is_message)
+        {
+            code << "                " << field_name << "[i].from_capnp_struct(list_reader[i]);\n";
+        }
+        else if (is_enum)
+        {
+            code << "                " << field_name << "[i] = static_cast<" << value_type->get_custom_name()
+                 << ">(list_reader[i]);\n";
+        }
+        else if (is_bytes)
+        {
+            code << "                auto data = list_reader[i];\n";
+            code << "                " << field_name << "[i].assign(data.begin(), data.end());\n";
+        }
+        else if (is_checked_text)
+        {
+            code << "                auto text = list_reader[i];\n";
+            code << "                MessageBase::requireUtf8(text.begin(), text.size(), \"" << field_name << "\");\n";
+            code << "                " << field_name << "[i].assign(text.begin(), text.size());\n";
+        }
+        else
+        {
+            code << "                " << field_name << "[i] = list_reader[i];\n";
+        }
+        code << "            }\n";
+        code << "        }\n";
+    }
+    else if (is_message)
+    {
+        code << "        if (reader.has" << capnp_method << "())\n";
+        code << "        {\n";
+        code << "            " << field_name << ".from_capnp_struct(reader.get" << capnp_method << "());\n";
+        code << "        }\n";
+    }
+    else if (is_enum)
+    {
+        code << "        " << field_name << " = static_cast<" << field.get_custom_name()
+             << ">(reader.get" << capnp_method << "());\n";
+    }
+    else if (is_bytes)
+    {
+        code << "        {\n";
+        code << "            auto data = reader.get" << capnp_method << "();\n";
+        code << "            " << field_name << ".assign(data.begin(), data.end());\n";
+        code << "        }\n";
+    }
+    else if (is_checked_text)
+    {
+        code << "        {\n";
+        code << "            auto text = reader.get" << capnp_method << "();\n";
+        code << "            MessageBase::requireUtf8(text.begin(), text.size(), \"" << field_name << "\");\n";
+        code << "            " << field_name << ".assign(text.begin(), text.size());\n";
+        code << "        }\n";
+    }
+    else
+    {
+        code << "        " << field_name << " = reader.get" << capnp_method << "();\n";
+    }
+
+    return code.str();
+}
+
+} // namespace curious::dsl::capnpgen
@@ -1,6 +1,7 @@
 #include "lexer.hpp"
 
 #include <cctype>
+#include <stdexcept>
 
 namespace curious::dsl::capnpgen
 {
@@ -120,6 +121,12 @@ Lexer::Token Lexer::next_token()
         return _read_identifier();
     }
 
+    // Handle string literals (default values)
+    if (current_char == '"')
+    {
+        return _read_string();
+    }
+
     // Handle numbers (start with digit, +, or -)
     if (std::isdigit(static_cast<unsigned char>(current_char)) ||
         current_char == '+' || current_char == '-')
@@ -231,4 +238,32 @@ Lexer::Token Lexer::_read_number()
     return Token{token_text, false};
 }
 
+Lexer::Token Lexer::_read_string()
+{
+    std::size_t start = _position;
+
+    // Skip opening quote
+    ++_position;
+
+    while (_position < _source.size() && _source[_position] != '"')
+    {
+        // Keep escape sequences intact, including escaped quotes
+        if (_source[_position] == '\\' && _position + 1 < _source.size())
+        {
+            ++_position;
+        }
+        ++_position;
+    }
+
+    if (_position >= _source.size())
+    {
+        throw std::runtime_error("Unterminated string literal");
+    }
+
+    ++_position; // Consume closing quote
+
+    std::string token_text = _source.substr(start, _position - start);
+    return Token{token_text, false};
+}
+
 } // namespace curious::dsl::capnpgen
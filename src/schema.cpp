@@ -2,9 +2,13 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cmath>
 #include <iomanip>
+#include <limits>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
+#include <string_view>
 #include <unordered_set>
 
 #include "lexer.hpp"
@@ -13,6 +17,23 @@
 namespace curious::dsl::capnpgen
 {
 
+// ---- UnionDecl methods ----
+
+std::string UnionDecl::get_member_name() const
+{
+    return name.empty() ? "alternative" : name;
+}
+
+std::string UnionDecl::get_cpp_type() const
+{
+    std::string cpp_type = "std::variant<";
+    for (std::size_t i = 0; i < arms.size(); ++i)
+    {
+        cpp_type += (i == 0 ? "" : ", ") + arms[i].get_cpp_type();
+    }
+    return cpp_type + ">";
+}
+
 // ---- Message methods ----
 
 std::string Message::get_capnp_id_string() const
@@ -50,6 +71,7 @@ void Schema::parse_from_file(const std::string& file_path)
     wrapper_namespace_name.clear();
     messages.clear();
     enums.clear();
+    views.clear();
     _messageOrder.clear();
 
     // Parse top-level declarations
@@ -77,12 +99,24 @@ void Schema::parse_from_file(const std::string& file_path)
         {
             _parse_message();
         }
+        else if (token->is_keyword("view"))
+        {
+            _parse_view();
+        }
         else
         {
-            _throw_parse_error("Expected 'namespace', 'wrapper_namespace', 'enum', or 'message'");
+            _throw_parse_error("Expected 'namespace', 'wrapper_namespace', 'enum', 'message', or 'view'");
         }
     }
 
+    // @value fields and views may reference messages declared after them
+    _validate_unions();
+    _validate_optional_fields();
+    _expand_value_types();
+    _expand_chunked_fields();
+    _validate_views();
+    _validate_default_values();
+
     // Ensure MessageType enum is properly populated
     _ensure_message_type_enum();
 }
@@ -380,16 +414,691 @@ void Schema::_parse_message()
 
     for (auto& field_line : field_lines)
     {
+        // A union block has no trailing ';', so whatever follows it shares its item
+        while (string_utils::starts_with_keyword(field_line, "union"))
+        {
+            field_line = _parse_union(message, field_line);
+        }
+
         if (!field_line.empty())
         {
             _add_field_line_to_message(message, field_line + ";");
         }
     }
 
+    _validate_field_annotations(message);
+
+    for (const auto& field : message.fields)
+    {
+        if (field.has_annotation("key"))
+        {
+            message.key_field = field.get_field_name();
+        }
+    }
+
     _messageOrder.push_back(message.name);
     messages[message.name] = std::move(message);
 }
 
+std::string Schema::_parse_union(Message& message, const std::string& line)
+{
+    std::size_t open_brace = line.find('{');
+    if (open_brace == std::string::npos)
+    {
+        _throw_parse_error("Expected '{' after 'union' in message " + message.name);
+    }
+
+    std::size_t close_brace = std::string::npos;
+    int brace_depth = 0;
+    for (std::size_t i = open_brace; i < line.size(); ++i)
+    {
+        if (line[i] == '{')
+        {
+            ++brace_depth;
+        }
+        else if (line[i] == '}' && --brace_depth == 0)
+        {
+            close_brace = i;
+            break;
+        }
+    }
+    if (close_brace == std::string::npos)
+    {
+        _throw_parse_error("Unterminated union in message " + message.name);
+    }
+
+    UnionDecl union_decl;
+    union_decl.name = string_utils::trim(line.substr(5, open_brace - 5));
+    union_decl.position = message.fields.size();
+
+    if (!union_decl.name.empty() &&
+        (!std::isalpha(static_cast<unsigned char>(union_decl.name.front())) ||
+         !std::all_of(union_decl.name.begin(), union_decl.name.end(),
+                      [](unsigned char c) { return std::isalnum(c) || c == '_'; })))
+    {
+        _throw_parse_error("Invalid union name '" + union_decl.name + "' in message " + message.name);
+    }
+
+    std::string body = line.substr(open_brace + 1, close_brace - open_brace - 1);
+    for (const auto& arm_line : string_utils::split_respecting_nesting(body, ';'))
+    {
+        std::string normalized_line = _normalize_field_line(arm_line);
+        if (!normalized_line.empty())
+        {
+            union_decl.arms.emplace_back(Type::parse_from_line(normalized_line));
+        }
+    }
+
+    message.unions.push_back(std::move(union_decl));
+    return string_utils::trim(line.substr(close_brace + 1));
+}
+
+void Schema::_parse_view()
+{
+    _lexer->next_token(); // Consume 'view'
+
+    auto name_token = _lexer->next_token();
+    if (!name_token.is_identifier())
+    {
+        _throw_parse_error("Expected view name");
+    }
+
+    View view;
+    view.name = name_token.text;
+
+    auto of_token = _lexer->next_token();
+    if (!of_token.is_keyword("of"))
+    {
+        _throw_parse_error("Expected 'of' after view name");
+    }
+
+    auto source_token = _lexer->next_token();
+    if (!source_token.is_identifier())
+    {
+        _throw_parse_error("Expected message name after 'of'");
+    }
+
+    view.source_name = source_token.text;
+
+    // Parse view body: "field;" or "field: NestedView;"
+    std::string body = _read_braced_block();
+    for (auto& line : string_utils::split_respecting_nesting(body, ';'))
+    {
+        std::string entry;
+        for (char c : line)
+        {
+            if (!std::isspace(static_cast<unsigned char>(c)))
+            {
+                entry += c;
+            }
+        }
+        if (entry.empty())
+        {
+            continue;
+        }
+
+        ViewField view_field;
+        std::size_t colon_pos = entry.find(':');
+        view_field.name = entry.substr(0, colon_pos);
+        if (colon_pos != std::string::npos)
+        {
+            view_field.view_name = entry.substr(colon_pos + 1);
+        }
+        view.fields.push_back(std::move(view_field));
+    }
+
+    if (views.count(view.name) > 0)
+    {
+        _throw_parse_error("View name '" + view.name + "' is already declared");
+    }
+
+    views[view.name] = std::move(view);
+}
+
+void Schema::_expand_value_types()
+{
+    // Iterate by name: creating value types inserts into the map
+    for (const auto& message_name : _messageOrder)
+    {
+        for (std::size_t i = 0; i < messages.at(message_name).fields.size(); ++i)
+        {
+            Type& field = messages.at(message_name).fields[i];
+            if (!field.has_annotation("value"))
+            {
+                continue;
+            }
+
+            const Type* nested_type = field.is_list() ? field.get_element_type() : &field;
+            if (nested_type == nullptr || !nested_type->is_custom() ||
+                messages.count(nested_type->get_custom_name()) == 0)
+            {
+                _throw_parse_error("'@value' requires a message or list of messages: " +
+                                   message_name + "." + field.get_field_name());
+            }
+
+            std::string value_name = _ensure_value_type(nested_type->get_custom_name());
+            messages.at(message_name).fields[i].set_custom_name(std::move(value_name));
+        }
+    }
+}
+
+std::string Schema::_ensure_value_type(const std::string& message_name)
+{
+    const std::string value_name = message_name + "Data";
+    auto existing_it = messages.find(value_name);
+    if (existing_it != messages.end())
+    {
+        if (existing_it->second.value_of != message_name)
+        {
+            _throw_parse_error("Value type name '" + value_name + "' is already declared");
+        }
+        return value_name;
+    }
+
+    // Flatten the message and its parents, dropping the msgType header
+    std::vector<const Message*> chain;
+    for (auto it = messages.find(message_name); it != messages.end(); it = messages.find(it->second.parent_name))
+    {
+        chain.insert(chain.begin(), &it->second);
+    }
+
+    Message value_type;
+    value_type.name = value_name;
+    value_type.value_of = message_name;
+    for (const Message* message : chain)
+    {
+        // Unions keep their place relative to the flattened fields
+        auto copy_unions_at = [&](std::size_t position)
+        {
+            for (const auto& union_decl : message->unions)
+            {
+                if (union_decl.position == position)
+                {
+                    value_type.unions.push_back(union_decl);
+                    value_type.unions.back().position = value_type.fields.size();
+                }
+            }
+        };
+
+        for (std::size_t i = 0; i < message->fields.size(); ++i)
+        {
+            copy_unions_at(i);
+            const Type& field = message->fields[i];
+            if (field.get_field_name() == "msgType" && field.get_custom_name() == "MessageType")
+            {
+                continue;
+            }
+            value_type.fields.push_back(field);
+            // Storage hints do not apply to plain structs, but presence is part of the value
+            value_type.fields.back().clear_annotations("optional");
+        }
+        copy_unions_at(message->fields.size());
+    }
+
+    // Register before recursing so self-referencing messages terminate
+    messages[value_name] = value_type;
+
+    // Nested messages become value types too, keeping the struct a plain aggregate
+    for (auto& field : value_type.fields)
+    {
+        const Type* nested_type = field.is_list() ? field.get_element_type() : &field;
+        if (nested_type != nullptr && nested_type->is_custom() &&
+            messages.count(nested_type->get_custom_name()) > 0 &&
+            !messages.at(nested_type->get_custom_name()).is_value_type())
+        {
+            field.set_custom_name(_ensure_value_type(nested_type->get_custom_name()));
+        }
+    }
+    for (auto& union_decl : value_type.unions)
+    {
+        for (auto& arm : union_decl.arms)
+        {
+            const Type* nested_type = arm.is_list() ? arm.get_element_type() : &arm;
+            if (nested_type != nullptr && nested_type->is_custom() &&
+                messages.count(nested_type->get_custom_name()) > 0 &&
+                !messages.at(nested_type->get_custom_name()).is_value_type())
+            {
+                arm.set_custom_name(_ensure_value_type(nested_type->get_custom_name()));
+            }
+        }
+    }
+
+    messages[value_name] = std::move(value_type);
+    return value_name;
+}
+
+void Schema::_expand_chunked_fields()
+{
+    // Default chunk size: large enough to amortize framing, small enough for one latency budget
+    constexpr std::uint64_t k_default_chunk_bytes = 1024 * 1024;
+
+    for (const auto& message_name : _messageOrder)
+    {
+        Message& message = messages.at(message_name);
+        for (const auto& field : message.fields)
+        {
+            if (!field.has_annotation("chunked"))
+            {
+                continue;
+            }
+
+            const std::string location = message_name + "." + field.get_field_name();
+            if (!message.chunked_field.empty())
+            {
+                _throw_parse_error("Only one '@chunked' field is allowed per message: " + location);
+            }
+
+            std::uint64_t max_bytes = k_default_chunk_bytes;
+            const std::string arguments = string_utils::trim(field.get_annotation_arguments("chunked"));
+            if (!arguments.empty())
+            {
+                const std::size_t equals_pos = arguments.find('=');
+                std::optional<std::uint64_t> parsed;
+                if (equals_pos != std::string::npos &&
+                    string_utils::trim(arguments.substr(0, equals_pos)) == "max_bytes")
+                {
+                    parsed = string_utils::parse_byte_size(arguments.substr(equals_pos + 1));
+                }
+                if (!parsed || *parsed == 0)
+                {
+                    _throw_parse_error("Expected '@chunked(max_bytes=<size>)' on " + location);
+                }
+                max_bytes = *parsed;
+            }
+
+            message.chunked_field = field.get_field_name();
+            message.chunk_max_bytes = max_bytes;
+        }
+
+        if (message.chunked_field.empty())
+        {
+            continue;
+        }
+
+        // Continuation header; both stay 0 for messages sent whole
+        for (const Message* current = &message; current != nullptr;)
+        {
+            for (const auto& field : current->fields)
+            {
+                if (field.get_field_name() == "chunkIndex" || field.get_field_name() == "chunkCount")
+                {
+                    _throw_parse_error("'@chunked' message " + message_name + " may not declare field '" +
+                                       field.get_field_name() + "'");
+                }
+            }
+            auto parent_it = messages.find(current->parent_name);
+            current = parent_it != messages.end() ? &parent_it->second : nullptr;
+        }
+        message.add_field_from_line("uint32 chunkIndex");
+        message.add_field_from_line("uint32 chunkCount");
+    }
+}
+
+void Schema::_validate_views() const
+{
+    for (const auto& [view_name, view] : views)
+    {
+        if (messages.count(view_name) > 0 || enums.count(view_name) > 0)
+        {
+            _throw_parse_error("View name '" + view_name + "' is already declared");
+        }
+
+        auto source_it = messages.find(view.source_name);
+        if (source_it == messages.end())
+        {
+            _throw_parse_error("View '" + view_name + "' projects unknown message '" + view.source_name + "'");
+        }
+
+        std::unordered_set<std::string> projected;
+        for (const auto& view_field : view.fields)
+        {
+            if (!projected.insert(view_field.name).second)
+            {
+                _throw_parse_error("View field '" + view_name + "." + view_field.name + "' is projected more than once");
+            }
+
+            // Look the field up in the message and its parents
+            const Type* field = nullptr;
+            for (const Message* message = &source_it->second; message != nullptr && field == nullptr;)
+            {
+                for (const auto& candidate : message->fields)
+                {
+                    if (candidate.get_field_name() == view_field.name)
+                    {
+                        field = &candidate;
+                        break;
+                    }
+                }
+                auto parent_it = messages.find(message->parent_name);
+                message = parent_it != messages.end() ? &parent_it->second : nullptr;
+            }
+
+            const std::string location = view_name + "." + view_field.name;
+            if (field == nullptr)
+            {
+                _throw_parse_error("View field '" + location + "' does not exist in '" + view.source_name + "'");
+            }
+
+            if (view_field.view_name.empty())
+            {
+                continue;
+            }
+
+            // A nested view must project the field's message type (or its list element type)
+            const Type* nested_type = field->is_list() ? field->get_element_type() : field;
+            auto nested_view_it = views.find(view_field.view_name);
+            if (nested_view_it == views.end())
+            {
+                _throw_parse_error("Unknown view '" + view_field.view_name + "' for '" + location + "'");
+            }
+            if (nested_type == nullptr || !nested_type->is_custom() ||
+                nested_type->get_custom_name() != nested_view_it->second.source_name)
+            {
+                _throw_parse_error("View '" + view_field.view_name + "' does not project the type of '" + location + "'");
+            }
+        }
+    }
+}
+
+void Schema::_validate_unions() const
+{
+    for (const auto& [message_name, message] : messages)
+    {
+        // Cap'n Proto flattens inherited members into one struct, so names are checked across the chain
+        std::unordered_set<std::string> member_names;
+        std::size_t unnamed_unions = 0;
+        for (auto it = messages.find(message_name); it != messages.end(); it = messages.find(it->second.parent_name))
+        {
+            for (const auto& field : it->second.fields)
+            {
+                member_names.insert(field.get_field_name());
+            }
+        }
+        for (auto it = messages.find(message_name); it != messages.end(); it = messages.find(it->second.parent_name))
+        {
+            for (const auto& union_decl : it->second.unions)
+            {
+                unnamed_unions += union_decl.name.empty() ? 1 : 0;
+                if (unnamed_unions > 1)
+                {
+                    _throw_parse_error("Only one unnamed union is allowed per message: " + message_name);
+                }
+                if (!member_names.insert(union_decl.get_member_name()).second)
+                {
+                    _throw_parse_error("Duplicate member '" + union_decl.get_member_name() + "' in message " +
+                                       message_name);
+                }
+                for (const auto& arm : union_decl.arms)
+                {
+                    if (!member_names.insert(arm.get_field_name()).second)
+                    {
+                        _throw_parse_error("Duplicate member '" + arm.get_field_name() + "' in message " +
+                                           message_name);
+                    }
+                }
+            }
+        }
+
+        for (const auto& union_decl : message.unions)
+        {
+            const std::string location = message_name + "." + union_decl.get_member_name();
+            if (union_decl.arms.size() < 2)
+            {
+                _throw_parse_error("A union needs at least two fields: " + location);
+            }
+            for (const auto& arm : union_decl.arms)
+            {
+                if (!arm.get_annotations().empty() || arm.has_default_value())
+                {
+                    _throw_parse_error("Union fields take no annotations or default values: " + location + "." +
+                                       arm.get_field_name());
+                }
+                if (arm.is_custom() && arm.get_custom_name() == "MessageType")
+                {
+                    _throw_parse_error("The msgType header cannot be a union field: " + location);
+                }
+            }
+        }
+    }
+}
+
+void Schema::_validate_optional_fields() const
+{
+    for (const auto& [message_name, message] : messages)
+    {
+        for (const auto& field : message.fields)
+        {
+            // Scalars and enums live in the data section and have no has() bit on the wire
+            if (field.has_annotation("optional") && field.is_custom() &&
+                enums.find(field.get_custom_name()) != enums.end())
+            {
+                _throw_parse_error("'@optional' requires a string, bytes, list, map or message field: " +
+                                   message_name + "." + field.get_field_name());
+            }
+        }
+    }
+}
+
+void Schema::_validate_default_values()
+{
+    for (auto& [message_name, message] : messages)
+    {
+        for (auto& field : message.fields)
+        {
+            if (!field.has_default_value())
+            {
+                continue;
+            }
+
+            const std::string location = message_name + "." + field.get_field_name();
+            const std::string& literal = field.get_default_value();
+
+            // Cap'n Proto only stores defaults for scalars, enums and text inline
+            if (field.is_custom())
+            {
+                auto enum_it = enums.find(field.get_custom_name());
+                if (enum_it == enums.end() || field.get_custom_name() == "MessageType")
+                {
+                    _throw_parse_error("Default values require a scalar, enum or string field: " + location);
+                }
+                const auto& values = enum_it->second.values;
+                if (std::none_of(values.begin(), values.end(),
+                                 [&](const EnumValue& value) { return value.name == literal; }))
+                {
+                    _throw_parse_error("Unknown enumerant '" + literal + "' in default value of " + location);
+                }
+                continue;
+            }
+
+            const std::string capnp_type = field.is_primitive() ? field.get_capnp_type() : std::string{};
+            if (capnp_type == "Text")
+            {
+                if (literal.size() < 2 || literal.front() != '"' || literal.back() != '"')
+                {
+                    _throw_parse_error("String default value must be a quoted literal: " + location);
+                }
+            }
+            else if (capnp_type == "Bool")
+            {
+                if (literal != "true" && literal != "false")
+                {
+                    _throw_parse_error("Bool default value must be 'true' or 'false': " + location);
+                }
+            }
+            else if (capnp_type == "Float32" || capnp_type == "Float64")
+            {
+                std::istringstream input(literal);
+                double value = 0.0;
+                input >> value;
+                if (input.fail() || !input.eof() || !std::isfinite(value))
+                {
+                    _throw_parse_error("Invalid floating-point default value '" + literal + "': " + location);
+                }
+
+                // Shortest text that round-trips, always spelled as a floating-point literal
+                const bool is_float32 = capnp_type == "Float32";
+                if (is_float32 && std::abs(value) > std::numeric_limits<float>::max())
+                {
+                    _throw_parse_error("Float32 default value out of range '" + literal + "': " + location);
+                }
+                std::string canonical;
+                for (int precision = 1; precision <= 17; ++precision)
+                {
+                    std::ostringstream output;
+                    output << std::setprecision(precision) << value;
+                    canonical = output.str();
+                    double parsed = std::stod(canonical);
+                    if (is_float32 ? static_cast<float>(parsed) == static_cast<float>(value) : parsed == value)
+                    {
+                        break;
+                    }
+                }
+                if (canonical.find_first_of(".e") == std::string::npos)
+                {
+                    canonical += ".0";
+                }
+                field.set_default_value(std::move(canonical));
+            }
+            else if (capnp_type.rfind("Int", 0) == 0 || capnp_type.rfind("UInt", 0) == 0)
+            {
+                const bool is_unsigned = capnp_type.front() == 'U';
+                const int bits = std::stoi(capnp_type.substr(is_unsigned ? 4 : 3));
+                std::size_t consumed = 0;
+                std::string canonical;
+                std::string_view digits(literal);
+                if (!digits.empty() && (digits.front() == '+' || digits.front() == '-'))
+                {
+                    digits.remove_prefix(1);
+                }
+                const int base = digits.rfind("0x", 0) == 0 || digits.rfind("0X", 0) == 0 ? 16 : 10;
+
+                try
+                {
+                    if (is_unsigned)
+                    {
+                        if (!literal.empty() && literal.front() == '-')
+                        {
+                            throw std::out_of_range(literal);
+                        }
+                        unsigned long long value = std::stoull(literal, &consumed, base);
+                        if (bits < 64 && value >> bits != 0)
+                        {
+                            throw std::out_of_range(literal);
+                        }
+                        canonical = std::to_string(value);
+                    }
+                    else
+                    {
+                        long long value = std::stoll(literal, &consumed, base);
+                        const long long limit = bits < 64 ? (1LL << (bits - 1)) : 0;
+                        if (bits < 64 && (value < -limit || value >= limit))
+                        {
+                            throw std::out_of_range(literal);
+                        }
+                        canonical = std::to_string(value);
+                    }
+                }
+                catch (const std::logic_error&)
+                {
+                    _throw_parse_error("Invalid " + capnp_type + " default value '" + literal + "': " + location);
+                }
+
+                if (consumed != literal.size())
+                {
+                    _throw_parse_error("Invalid " + capnp_type + " default value '" + literal + "': " + location);
+                }
+                field.set_default_value(std::move(canonical));
+            }
+            else
+            {
+                _throw_parse_error("Default values require a scalar, enum or string field: " + location);
+            }
+        }
+    }
+}
+
+void Schema::_validate_field_annotations(const Message& message) const
+{
+    for (const auto& field : message.fields)
+    {
+        for (const auto& annotation : field.get_annotations())
+        {
+            const std::string location = message.name + "." + field.get_field_name();
+
+            if (annotation.name == "shared")
+            {
+                // Copy-on-write sharing only pays off for heap-backed containers
+                if (!field.is_list() && !field.is_map())
+                {
+                    _throw_parse_error("'@shared' requires a list or map field: " + location);
+                }
+            }
+            else if (annotation.name == "hot" || annotation.name == "cold")
+            {
+                // Member placement hints only; the wire layout is unaffected
+                if (field.has_annotation("hot") && field.has_annotation("cold"))
+                {
+                    _throw_parse_error("'@hot' and '@cold' are mutually exclusive: " + location);
+                }
+            }
+            else if (annotation.name == "value")
+            {
+                // Checked against the message table once all messages are parsed
+            }
+            else if (annotation.name == "chunked")
+            {
+                // Slices are cut between elements, so elements must be self-contained
+                const Type* element_type = field.is_list() ? field.get_element_type() : nullptr;
+                if (element_type == nullptr || element_type->is_list() || element_type->is_map())
+                {
+                    _throw_parse_error("'@chunked' requires a list of messages, strings, bytes or scalars: " +
+                                       location);
+                }
+            }
+            else if (annotation.name == "optional")
+            {
+                // Enum fields are rejected in _validate_optional_fields() once all enums are known
+                if (field.is_primitive() && field.get_capnp_type() != "Text" && field.get_capnp_type() != "Data")
+                {
+                    _throw_parse_error("'@optional' requires a string, bytes, list, map or message field: " +
+                                       location);
+                }
+                if (field.has_annotation("shared") || field.has_annotation("chunked") ||
+                    field.has_annotation("key"))
+                {
+                    _throw_parse_error("'@optional' cannot be combined with '@shared', '@chunked' or '@key': " +
+                                       location);
+                }
+                if (field.has_default_value())
+                {
+                    _throw_parse_error("'@optional' fields cannot declare a default value: " + location);
+                }
+            }
+            else if (annotation.name == "key")
+            {
+                // Snapshot indexes compare keys as strings or integers
+                const std::string capnp_type = field.get_capnp_type();
+                if (!field.is_primitive() ||
+                    (capnp_type != "Text" && capnp_type.rfind("Int", 0) != 0 && capnp_type.rfind("UInt", 0) != 0))
+                {
+                    _throw_parse_error("'@key' requires a string or integer field: " + location);
+                }
+                for (const auto& other : message.fields)
+                {
+                    if (&other != &field && other.has_annotation("key"))
+                    {
+                        _throw_parse_error("Only one '@key' field is allowed per message: " + location);
+                    }
+                }
+            }
+            else
+            {
+                _throw_parse_error("Unknown annotation '@" + annotation.name + "' on " + location);
+            }
+        }
+    }
+}
+
 void Schema::_ensure_message_type_enum()
 {
     EnumDecl& message_type_enum = enums["MessageType"];
@@ -51,7 +51,9 @@ std::string strip_comments(const std::string& input)
         AfterSlash,
         InLineComment,
         InBlockComment,
-        AfterStar
+        AfterStar,
+        InString,
+        InStringEscape
     };
 
     std::string output;
@@ -76,10 +78,32 @@ std::string strip_comments(const std::string& input)
                 }
                 else
                 {
+                    // String literals (default values) may contain '//' and '#'
+                    if (c == '"')
+                    {
+                        state = State::InString;
+                    }
                     output.push_back(c);
                 }
                 break;
 
+            case State::InString:
+                output.push_back(c);
+                if (c == '\\')
+                {
+                    state = State::InStringEscape;
+                }
+                else if (c == '"')
+                {
+                    state = State::Normal;
+                }
+                break;
+
+            case State::InStringEscape:
+                output.push_back(c);
+                state = State::InString;
+                break;
+
             case State::AfterSlash:
                 if (c == '/')
                 {
@@ -95,7 +119,7 @@ std::string strip_comments(const std::string& input)
                 {
                     output.back() = '/'; // Restore the slash
                     output.push_back(c);
-                    state = State::Normal;
+                    state = c == '"' ? State::InString : State::Normal;
                 }
                 break;
 
@@ -141,9 +165,36 @@ std::vector<std::string> split_respecting_nesting(const std::string& str, char d
     int angle_bracket_depth = 0;
     int paren_depth = 0;
     int brace_depth = 0;
+    bool in_string = false;
+    bool escaped = false;
 
     for (char c : str)
     {
+        // Delimiters and brackets inside string literals are plain characters
+        if (in_string)
+        {
+            current.push_back(c);
+            if (escaped)
+            {
+                escaped = false;
+            }
+            else if (c == '\\')
+            {
+                escaped = true;
+            }
+            else if (c == '"')
+            {
+                in_string = false;
+            }
+            continue;
+        }
+        if (c == '"')
+        {
+            in_string = true;
+            current.push_back(c);
+            continue;
+        }
+
         // Track nesting levels
         if (c == '<') ++angle_bracket_depth;
         else if (c == '>') --angle_bracket_depth;
@@ -251,5 +302,55 @@ std::string to_lower_camel_case(const std::string& str)
     return result;
 }
 
+std::optional<std::uint64_t> parse_byte_size(const std::string& str)
+{
+    std::string digits;
+    std::string unit;
+    for (char c : str)
+    {
+        if (std::isspace(static_cast<unsigned char>(c)))
+        {
+            continue;
+        }
+        if (std::isdigit(static_cast<unsigned char>(c)) && unit.empty())
+        {
+            digits += c;
+        }
+        else
+        {
+            unit += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+    }
+
+    if (digits.empty() || digits.size() > 15)
+    {
+        return std::nullopt;
+    }
+
+    std::uint64_t multiplier = 0;
+    if (unit.empty() || unit == "b")
+    {
+        multiplier = 1;
+    }
+    else if (unit == "kib" || unit == "kb")
+    {
+        multiplier = 1024;
+    }
+    else if (unit == "mib" || unit == "mb")
+    {
+        multiplier = 1024 * 1024;
+    }
+    else if (unit == "gib" || unit == "gb")
+    {
+        multiplier = 1024 * 1024 * 1024;
+    }
+    else
+    {
+        return std::nullopt;
+    }
+
+    return std::stoull(digits) * multiplier;
+}
+
 } // namespace string_utils
 } // namespace curious::dsl::capnpgen
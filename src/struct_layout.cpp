@@ -0,0 +1,292 @@
+#include "struct_layout.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace curious::dsl::capnpgen
+{
+
+// ---- Public static methods ----
+
+std::vector<DataFieldSlot> StructLayout::compute_data_slots(const Schema& schema, const Message& message)
+{
+    // Flatten fields in ordinal order: parents first, as CapnpFileGenerator writes them
+    std::vector<const Type*> all_fields;
+    std::vector<const Message*> chain;
+    for (const Message* current = &message; current != nullptr;)
+    {
+        chain.insert(chain.begin(), current);
+        auto parent_it = schema.messages.find(current->parent_name);
+        current = parent_it != schema.messages.end() ? &parent_it->second : nullptr;
+    }
+    // Union members share slots and add a discriminant; fields after the first union are not modeled
+    bool reached_union = false;
+    for (const Message* current : chain)
+    {
+        for (std::size_t i = 0; i < current->fields.size() && !reached_union; ++i)
+        {
+            reached_union = std::any_of(current->unions.begin(), current->unions.end(),
+                                        [i](const UnionDecl& union_decl) { return union_decl.position <= i; });
+            if (!reached_union)
+            {
+                all_fields.push_back(&current->fields[i]);
+            }
+        }
+        reached_union = reached_union || !current->unions.empty();
+    }
+
+    StructLayout layout;
+    std::vector<DataFieldSlot> slots;
+
+    // A msgType field is synthesized at ordinal 0 when the message does not start with one
+    bool has_message_type_first = !all_fields.empty() &&
+                                  all_fields.front()->get_field_name() == "msgType" &&
+                                  all_fields.front()->get_custom_name() == "MessageType";
+    if (!has_message_type_first)
+    {
+        layout._add_data(4);
+    }
+
+    for (const Type* field : all_fields)
+    {
+        auto lg_size = get_data_lg_size(schema, *field);
+        if (!lg_size)
+        {
+            continue;
+        }
+
+        std::uint32_t offset = layout._add_data(*lg_size);
+        slots.push_back({field->get_field_name(), *lg_size, offset << *lg_size});
+    }
+
+    return slots;
+}
+
+std::optional<unsigned> StructLayout::get_data_lg_size(const Schema& schema, const Type& field)
+{
+    if (field.is_custom() || field.is_enum())
+    {
+        // Enums are UInt16 on the wire; other custom types are nested structs (pointers)
+        const std::string& type_name = field.get_custom_name();
+        if (field.is_enum() || schema.enums.count(type_name) > 0 || type_name == "MessageType")
+        {
+            return 4;
+        }
+        return std::nullopt;
+    }
+
+    if (!field.is_primitive())
+    {
+        return std::nullopt;
+    }
+
+    const std::string cpp_type = field.get_cpp_type();
+    if (cpp_type == "bool")
+    {
+        return 0;
+    }
+    if (cpp_type == "int8_t" || cpp_type == "uint8_t")
+    {
+        return 3;
+    }
+    if (cpp_type == "int16_t" || cpp_type == "uint16_t")
+    {
+        return 4;
+    }
+    if (cpp_type == "int32_t" || cpp_type == "uint32_t" || cpp_type == "float")
+    {
+        return 5;
+    }
+    if (cpp_type == "int64_t" || cpp_type == "uint64_t" || cpp_type == "double")
+    {
+        return 6;
+    }
+    return std::nullopt;
+}
+
+std::string StructLayout::get_enum_underlying_type(const EnumDecl& enum_decl)
+{
+    bool is_signed = std::any_of(enum_decl.values.begin(), enum_decl.values.end(),
+                                 [](const EnumValue& value) { return value.value < 0; });
+    return (is_signed ? "std::int" : "std::uint") + std::to_string(_get_enum_underlying_size(enum_decl) * 8) + "_t";
+}
+
+std::vector<Type> StructLayout::order_members(const Schema& schema, const Message& message)
+{
+    if (message.is_value_type())
+    {
+        return message.fields;
+    }
+
+    auto rank = [&schema](const Type& field)
+    {
+        int group = field.has_annotation("hot") ? 0 : (field.has_annotation("cold") ? 2 : 1);
+        return std::make_pair(group, -static_cast<long>(_estimate_member_size(schema, field, true).alignment));
+    };
+
+    std::vector<Type> ordered = message.fields;
+    std::stable_sort(ordered.begin(), ordered.end(),
+                     [&rank](const Type& lhs, const Type& rhs) { return rank(lhs) < rank(rhs); });
+    return ordered;
+}
+
+ObjectSizeEstimate StructLayout::estimate_object_size(const Schema& schema, const Message& message, bool optimized)
+{
+    ObjectSizeEstimate estimate;
+
+    // Members start after the parent's data (its tail padding is reused) or the vtable pointer
+    if (!message.parent_name.empty() && schema.messages.count(message.parent_name) > 0)
+    {
+        estimate = estimate_object_size(schema, schema.messages.at(message.parent_name), optimized);
+    }
+    else if (!message.is_value_type())
+    {
+        estimate.data_size = sizeof(void*);
+        estimate.alignment = alignof(void*);
+    }
+
+    const std::vector<Type> members = optimized ? order_members(schema, message) : message.fields;
+    for (const auto& field : members)
+    {
+        ObjectSizeEstimate member = _estimate_member_size(schema, field, optimized);
+        estimate.data_size = (estimate.data_size + member.alignment - 1) / member.alignment * member.alignment;
+        estimate.data_size += member.size;
+        estimate.alignment = std::max(estimate.alignment, member.alignment);
+    }
+
+    estimate.size = (estimate.data_size + estimate.alignment - 1) / estimate.alignment * estimate.alignment;
+    return estimate;
+}
+
+// ---- Private static methods ----
+
+std::size_t StructLayout::_get_enum_underlying_size(const EnumDecl& enum_decl)
+{
+    std::int64_t min_value = 0;
+    std::int64_t max_value = 0;
+    for (const auto& value : enum_decl.values)
+    {
+        min_value = std::min(min_value, value.value);
+        max_value = std::max(max_value, value.value);
+    }
+
+    auto fits = [min_value, max_value](auto type_tag)
+    {
+        using T = decltype(type_tag);
+        return min_value >= static_cast<std::int64_t>(std::numeric_limits<T>::min()) &&
+               static_cast<std::uint64_t>(max_value) <= static_cast<std::uint64_t>(std::numeric_limits<T>::max());
+    };
+
+    // Enums cross the wire as UInt16, so every raw wire value must stay representable
+    if (min_value >= 0)
+    {
+        return fits(std::uint16_t{}) ? 2 : fits(std::uint32_t{}) ? 4 : 8;
+    }
+    return fits(std::int16_t{}) ? 2 : fits(std::int32_t{}) ? 4 : 8;
+}
+
+ObjectSizeEstimate StructLayout::_estimate_member_size(const Schema& schema, const Type& field, bool optimized)
+{
+    auto fixed = [](std::size_t size, std::size_t alignment) { return ObjectSizeEstimate{size, size, alignment}; };
+
+    if (field.has_annotation("shared"))
+    {
+        return fixed(16, 8); // SharedField<T> holds a std::shared_ptr
+    }
+    if (field.has_annotation("optional"))
+    {
+        // std::optional<T> appends an engaged flag, padded to T's alignment
+        Type value_type = field;
+        value_type.clear_annotations();
+        ObjectSizeEstimate value = _estimate_member_size(schema, value_type, optimized);
+        std::size_t size = (value.size + 1 + value.alignment - 1) / value.alignment * value.alignment;
+        return fixed(size, value.alignment);
+    }
+    if (field.is_list())
+    {
+        return fixed(24, 8);
+    }
+    if (field.is_map())
+    {
+        return fixed(56, 8);
+    }
+
+    if (field.is_custom() || field.is_enum())
+    {
+        auto enum_it = schema.enums.find(field.get_custom_name());
+        if (enum_it != schema.enums.end())
+        {
+            std::size_t size = optimized ? _get_enum_underlying_size(enum_it->second) : sizeof(std::int64_t);
+            return fixed(size, size);
+        }
+
+        auto message_it = schema.messages.find(field.get_custom_name());
+        if (message_it != schema.messages.end())
+        {
+            ObjectSizeEstimate nested = estimate_object_size(schema, message_it->second, optimized);
+            return fixed(nested.size, nested.alignment);
+        }
+        return fixed(8, 8);
+    }
+
+    const std::string cpp_type = field.get_cpp_type();
+    if (cpp_type == "std::string")
+    {
+        return fixed(32, 8);
+    }
+    if (cpp_type == "std::vector<uint8_t>")
+    {
+        return fixed(24, 8);
+    }
+
+    auto lg_size = get_data_lg_size(schema, field);
+    std::size_t size = lg_size && *lg_size > 3 ? (std::size_t{1} << *lg_size) / 8 : 1;
+    return fixed(size, size);
+}
+
+// ---- Private instance methods ----
+
+std::uint32_t StructLayout::_add_data(unsigned lg_size_bits)
+{
+    if (auto hole = _try_allocate_hole(lg_size_bits))
+    {
+        return *hole;
+    }
+
+    // Grow by one word; the rest of the word becomes one hole per smaller-or-equal size class
+    std::uint32_t offset = _dataWordCount++ << (6 - lg_size_bits);
+    std::uint32_t hole_offset = offset + 1;
+    for (unsigned lg_size = lg_size_bits; lg_size < 6; ++lg_size)
+    {
+        _holes[lg_size] = hole_offset;
+        hole_offset = (hole_offset + 1) / 2;
+    }
+    return offset;
+}
+
+std::optional<std::uint32_t> StructLayout::_try_allocate_hole(unsigned lg_size_bits)
+{
+    if (lg_size_bits >= _holes.size())
+    {
+        return std::nullopt;
+    }
+
+    if (_holes[lg_size_bits] != 0)
+    {
+        std::uint32_t result = _holes[lg_size_bits];
+        _holes[lg_size_bits] = 0;
+        return result;
+    }
+
+    // Split the next larger hole: use the lower half, keep the upper half free
+    if (auto larger = _try_allocate_hole(lg_size_bits + 1))
+    {
+        std::uint32_t result = *larger * 2;
+        _holes[lg_size_bits] = result + 1;
+        return result;
+    }
+
+    return std::nullopt;
+}
+
+} // namespace curious::dsl::capnpgen
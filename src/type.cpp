@@ -1,8 +1,11 @@
 #include "type.hpp"
 
+#include <algorithm>
 #include <cctype>
 #include <stdexcept>
 
+#include "string_utils.hpp"
+
 namespace curious::dsl::capnpgen
 {
 
@@ -22,8 +25,27 @@ public:
     Type parse()
     {
         _skip_whitespace();
+        std::vector<FieldAnnotation> annotations = _parse_annotations();
+        const bool optional_wrapper = _try_consume_optional_wrapper();
         Type result = _parse_type();
+        if (optional_wrapper)
+        {
+            // optional<T> is shorthand for "@optional T"
+            _expect_char('>');
+            const bool already_annotated = std::any_of(
+                annotations.begin(), annotations.end(),
+                [](const FieldAnnotation& annotation) { return annotation.name == "optional"; });
+            if (!already_annotated)
+            {
+                annotations.push_back(FieldAnnotation{"optional", {}});
+            }
+        }
+        result._annotations = std::move(annotations);
         result._fieldName = _parse_field_name();
+        if (_try_consume('='))
+        {
+            result._defaultValue = _parse_default_value();
+        }
         _skip_whitespace();
 
         // Optional trailing semicolon
@@ -140,6 +162,38 @@ private:
                identifier_lower == "std::unordered_map";
     }
 
+    /// @brief Check if an identifier is an optional keyword.
+    /// @param identifier_lower The lowercase identifier.
+    /// @return True if it names std::optional.
+    static bool _is_optional_keyword(const std::string& identifier_lower)
+    {
+        return identifier_lower == "optional" ||
+               identifier_lower == "std::optional";
+    }
+
+    /// @brief Consume a leading "optional<" if present.
+    /// @return True if the wrapper was consumed; the caller must expect the closing '>'.
+    bool _try_consume_optional_wrapper()
+    {
+        const std::size_t saved_position = _position;
+        _skip_whitespace();
+        if (_position >= _source.size() ||
+            !(std::isalpha(static_cast<unsigned char>(_source[_position])) || _source[_position] == '_'))
+        {
+            _position = saved_position;
+            return false;
+        }
+
+        const std::string identifier_lower = _to_lower(_read_identifier());
+        if (_is_optional_keyword(identifier_lower) && _try_consume('<'))
+        {
+            return true;
+        }
+
+        _position = saved_position;
+        return false;
+    }
+
     /// @brief Try to resolve an identifier as a primitive type.
     /// @param identifier The identifier to check.
     /// @param out_type Output parameter for the resolved DslType.
@@ -173,6 +227,11 @@ private:
         std::string identifier = _read_identifier();
         std::string identifier_lower = _to_lower(identifier);
 
+        if (_is_optional_keyword(identifier_lower))
+        {
+            throw std::runtime_error("optional<T> is only allowed as the outermost type of a field");
+        }
+
         // Handle list types
         if (_is_list_keyword(identifier_lower))
         {
@@ -215,12 +274,106 @@ private:
         return result;
     }
 
+    /// @brief Parse leading field annotations (e.g., "@shared", "@chunked(max_bytes=1MiB)").
+    /// @return The annotations in declaration order.
+    std::vector<FieldAnnotation> _parse_annotations()
+    {
+        std::vector<FieldAnnotation> annotations;
+
+        while (_try_consume('@'))
+        {
+            FieldAnnotation annotation;
+            annotation.name = _read_identifier();
+
+            if (_try_consume('('))
+            {
+                std::size_t start = _position;
+                int depth = 1;
+
+                while (_position < _source.size())
+                {
+                    char c = _source[_position];
+                    if (c == '(')
+                    {
+                        ++depth;
+                    }
+                    else if (c == ')' && --depth == 0)
+                    {
+                        break;
+                    }
+                    ++_position;
+                }
+
+                if (depth != 0)
+                {
+                    throw std::runtime_error("Unterminated arguments for annotation '@" +
+                                             annotation.name + "'");
+                }
+
+                annotation.arguments = string_utils::trim(
+                    std::string(_source.substr(start, _position - start)));
+                ++_position; // Consume ')'
+            }
+
+            annotations.push_back(std::move(annotation));
+        }
+
+        return annotations;
+    }
+
     /// @brief Parse the field name.
     /// @return The field name string.
     std::string _parse_field_name()
     {
         return _read_identifier();
     }
+
+    /// @brief Parse the literal after '=' up to the terminating ';'.
+    /// @details String literals are kept verbatim; other literals drop the spaces the
+    ///          tokenizer inserts between tokens (e.g., "1 . 5" becomes "1.5").
+    /// @return The default value literal.
+    std::string _parse_default_value()
+    {
+        _skip_whitespace();
+        std::string value;
+
+        if (_position < _source.size() && _source[_position] == '"')
+        {
+            std::size_t start = _position++;
+            while (_position < _source.size() && _source[_position] != '"')
+            {
+                if (_source[_position] == '\\')
+                {
+                    ++_position;
+                }
+                ++_position;
+            }
+            if (_position >= _source.size())
+            {
+                throw std::runtime_error("Unterminated string literal in default value");
+            }
+            ++_position; // Consume closing quote
+            value = std::string(_source.substr(start, _position - start));
+        }
+        else
+        {
+            while (_position < _source.size() && _source[_position] != ';')
+            {
+                if (!std::isspace(static_cast<unsigned char>(_source[_position])))
+                {
+                    value.push_back(_source[_position]);
+                }
+                ++_position;
+            }
+        }
+
+        if (value.empty())
+        {
+            throw std::runtime_error("Expected default value after '='");
+        }
+
+        return value;
+    }
 };
 
 // ---- Type constructors and assignment ----
@@ -293,6 +446,35 @@ const std::vector<std::string>& Type::get_enum_values() const noexcept
     return _enumValues;
 }
 
+const std::vector<FieldAnnotation>& Type::get_annotations() const noexcept
+{
+    return _annotations;
+}
+
+bool Type::has_annotation(std::string_view name) const noexcept
+{
+    for (const auto& annotation : _annotations)
+    {
+        if (annotation.name == name)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string Type::get_annotation_arguments(std::string_view name) const
+{
+    for (const auto& annotation : _annotations)
+    {
+        if (annotation.name == name)
+        {
+            return annotation.arguments;
+        }
+    }
+    return {};
+}
+
 const Type* Type::get_element_type() const noexcept
 {
     return _elementType.get();
@@ -308,6 +490,37 @@ const Type* Type::get_value_type() const noexcept
     return _valueType.get();
 }
 
+void Type::set_custom_name(std::string custom_name)
+{
+    if (_kind == Kind::List && _elementType)
+    {
+        _elementType->set_custom_name(std::move(custom_name));
+        return;
+    }
+
+    _customName = std::move(custom_name);
+}
+
+void Type::clear_annotations(std::string_view keep) noexcept
+{
+    std::erase_if(_annotations, [keep](const FieldAnnotation& annotation) { return annotation.name != keep; });
+}
+
+bool Type::has_default_value() const noexcept
+{
+    return !_defaultValue.empty();
+}
+
+const std::string& Type::get_default_value() const noexcept
+{
+    return _defaultValue;
+}
+
+void Type::set_default_value(std::string value)
+{
+    _defaultValue = std::move(value);
+}
+
 // ---- Type conversion methods ----
 
 std::string Type::get_cpp_type() const
@@ -371,6 +584,8 @@ void Type::_copy_from(const Type& other)
     _customName = other._customName;
     _enumValues = other._enumValues;
     _fieldName = other._fieldName;
+    _annotations = other._annotations;
+    _defaultValue = other._defaultValue;
 
     // Deep copy unique_ptr members
     _elementType.reset(other._elementType ? new Type(*other._elementType) : nullptr);
@@ -1,6 +1,7 @@
 #include "type_converter.hpp"
 
 #include <cctype>
+#include <unordered_map>
 
 namespace curious::dsl::capnpgen
 {
@@ -25,6 +26,32 @@ std::string TypeConverter::to_capnp_method_name(const std::string& field_name)
     return result;
 }
 
+std::string TypeConverter::to_capnp_enumerant_name(const std::string& field_name)
+{
+    // Mirrors capnpc-c++: every upper-case letter after the first starts a new word
+    std::string result;
+    result.reserve(field_name.size() + 4);
+
+    for (char c : field_name)
+    {
+        if (std::islower(static_cast<unsigned char>(c)))
+        {
+            result.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+        }
+        else if (!result.empty() && std::isupper(static_cast<unsigned char>(c)))
+        {
+            result.push_back('_');
+            result.push_back(c);
+        }
+        else
+        {
+            result.push_back(c);
+        }
+    }
+
+    return result;
+}
+
 bool TypeConverter::is_enum_type(const Type& type, const std::set<std::string>& known_enums)
 {
     if (type.is_enum())
@@ -47,13 +74,45 @@ std::string TypeConverter::generate_from_capnp_code(const Type& field,
                                                       const std::string& reader_expr,
                                                       const std::string& target_var,
                                                       int indent_level,
-                                                      const std::set<std::string>& known_enums)
+                                                      const std::set<std::string>& known_enums,
+                                                      bool validate_utf8)
+{
+    if (!has_presence(field, known_enums))
+    {
+        return generate_from_capnp_body(field, reader_expr, target_var, indent_level, known_enums, validate_utf8);
+    }
+
+    // Pointer fields: an absent value leaves the target untouched
+    std::ostringstream code;
+    std::string ind = indent(indent_level);
+
+    code << ind << "if (" << reader_expr << ".has" << to_capnp_method_name(field.get_field_name()) << "())\n";
+    code << ind << "{\n";
+    code << generate_from_capnp_body(field, reader_expr, target_var, indent_level + 1, known_enums, validate_utf8);
+    code << ind << "}\n";
+
+    return code.str();
+}
+
+std::string TypeConverter::generate_from_capnp_body(const Type& field,
+                                                      const std::string& reader_expr,
+                                                      const std::string& target_var,
+                                                      int indent_level,
+                                                      const std::set<std::string>& known_enums,
+                                                      bool validate_utf8)
 {
     std::ostringstream code;
     std::string ind = indent(indent_level);
 
     std::string getter_name = to_capnp_method_name(field.get_field_name());
 
+    // Text checks name the field in the decode error
+    auto utf8_check = [&field](const std::string& text_expr)
+    {
+        return "MessageBase::requireUtf8(" + text_expr + ".begin(), " + text_expr + ".size(), \"" +
+               field.get_field_name() + "\");\n";
+    };
+
     if (field.is_primitive())
     {
         std::string cpp_type = field.get_cpp_type();
@@ -65,6 +124,15 @@ std::string TypeConverter::generate_from_capnp_code(const Type& field,
             code << ind << "    " << target_var << ".assign(data.begin(), data.end());\n";
             code << ind << "}\n";
         }
+        else if (validate_utf8 && cpp_type == "std::string")
+        {
+            // Validate while the text is cache-hot, right before the copy
+            code << ind << "{\n";
+            code << ind << "    auto text = " << reader_expr << ".get" << getter_name << "();\n";
+            code << ind << "    " << utf8_check("text");
+            code << ind << "    " << target_var << ".assign(text.begin(), text.size());\n";
+            code << ind << "}\n";
+        }
         else
         {
             // Other primitive types: direct assignment
@@ -80,85 +148,99 @@ std::string TypeConverter::generate_from_capnp_code(const Type& field,
     }
     else if (field.is_custom())
     {
-        // Custom message types: use has* check
-        std::string type_name = field.get_custom_name();
-
-        code << ind << "if (" << reader_expr << ".has" << getter_name << "())\n";
-        code << ind << "{\n";
-        code << ind << "    " << target_var << ".from_capnp_struct("
+        // Custom message types: decode in place
+        code << ind << target_var << ".from_capnp_struct("
              << reader_expr << ".get" << getter_name << "());\n";
-        code << ind << "}\n";
     }
     else if (field.is_list())
     {
         const Type* element_type = field.get_element_type();
 
-        code << ind << "if (" << reader_expr << ".has" << getter_name << "())\n";
-        code << ind << "{\n";
-        code << ind << "    auto list_reader = " << reader_expr << ".get" << getter_name << "();\n";
-        code << ind << "    " << target_var << ".clear();\n";
-        code << ind << "    " << target_var << ".reserve(list_reader.size());\n";
-        code << ind << "    for (const auto& item : list_reader)\n";
-        code << ind << "    {\n";
+        code << ind << "auto list_reader = " << reader_expr << ".get" << getter_name << "();\n";
 
-        if (element_type->is_primitive())
+        if (is_fixed_width_primitive(*element_type))
         {
-            code << ind << "        " << target_var << ".push_back(item);\n";
+            // Wire layout matches the host on little-endian: bulk copy
+            code << ind << "MessageBase::bulkCopyFromList(list_reader, " << target_var << ");\n";
         }
-        else if (is_enum_type(*element_type, known_enums))
+        else if (element_type->is_custom() && !is_enum_type(*element_type, known_enums))
         {
-            std::string elem_type_name = element_type->get_custom_name();
-            code << ind << "        " << target_var << ".push_back(static_cast<"
-                 << elem_type_name << ">(item));\n";
+            // Decode nested messages in place instead of constructing and moving temporaries
+            code << ind << target_var << ".clear();\n";
+            code << ind << target_var << ".resize(list_reader.size());\n";
+            code << ind << "for (unsigned int i = 0; i < list_reader.size(); ++i)\n";
+            code << ind << "{\n";
+            code << ind << "    " << target_var << "[i].from_capnp_struct(list_reader[i]);\n";
+            code << ind << "}\n";
         }
-        else if (element_type->is_custom())
+        else
         {
-            std::string elem_type_name = element_type->get_custom_name();
-            code << ind << "        " << elem_type_name << " elem;\n";
-            code << ind << "        elem.from_capnp_struct(item);\n";
-            code << ind << "        " << target_var << ".push_back(std::move(elem));\n";
-        }
+            code << ind << target_var << ".clear();\n";
+            code << ind << target_var << ".reserve(list_reader.size());\n";
+            code << ind << "for (const auto& item : list_reader)\n";
+            code << ind << "{\n";
 
-        code << ind << "    }\n";
-        code << ind << "}\n";
+            if (element_type->is_primitive())
+            {
+                if (validate_utf8 && element_type->get_cpp_type() == "std::string")
+                {
+                    code << ind << "    " << utf8_check("item");
+                }
+                code << ind << "    " << target_var << ".push_back(item);\n";
+            }
+            else if (is_enum_type(*element_type, known_enums))
+            {
+                std::string elem_type_name = element_type->get_custom_name();
+                code << ind << "    " << target_var << ".push_back(static_cast<"
+                     << elem_type_name << ">(item));\n";
+            }
+
+            code << ind << "}\n";
+        }
     }
     else if (field.is_map())
     {
         const Type* key_type = field.get_key_type();
         const Type* value_type = field.get_value_type();
 
-        code << ind << "if (" << reader_expr << ".has" << getter_name << "())\n";
+        code << ind << "auto map_reader = " << reader_expr << ".get" << getter_name << "();\n";
+        code << ind << target_var << ".clear();\n";
+        code << ind << "if (map_reader.hasEntries())\n";
         code << ind << "{\n";
-        code << ind << "    auto map_reader = " << reader_expr << ".get" << getter_name << "();\n";
-        code << ind << "    " << target_var << ".clear();\n";
-        code << ind << "    if (map_reader.hasEntries())\n";
+        code << ind << "    auto entries = map_reader.getEntries();\n";
+        code << ind << "    for (const auto& entry : entries)\n";
         code << ind << "    {\n";
-        code << ind << "        auto entries = map_reader.getEntries();\n";
-        code << ind << "        for (const auto& entry : entries)\n";
-        code << ind << "        {\n";
 
         // Read key
         std::string key_read = "entry.getKey()";
         std::string value_read = "entry.getValue()";
 
+        if (validate_utf8 && key_type->is_primitive() && key_type->get_cpp_type() == "std::string")
+        {
+            code << ind << "        " << utf8_check(key_read);
+        }
+        if (validate_utf8 && value_type->is_primitive() && value_type->get_cpp_type() == "std::string")
+        {
+            code << ind << "        " << utf8_check(value_read);
+        }
+
         if (key_type->is_primitive())
         {
             if (value_type->is_primitive())
             {
-                code << ind << "            " << target_var << "[" << key_read << "] = "
+                code << ind << "        " << target_var << "[" << key_read << "] = "
                      << value_read << ";\n";
             }
             else if (value_type->is_custom())
             {
                 std::string val_type_name = value_type->get_custom_name();
-                code << ind << "            " << val_type_name << " val;\n";
-                code << ind << "            val.from_capnp_struct(" << value_read << ");\n";
-                code << ind << "            " << target_var << "[" << key_read
+                code << ind << "        " << val_type_name << " val;\n";
+                code << ind << "        val.from_capnp_struct(" << value_read << ");\n";
+                code << ind << "        " << target_var << "[" << key_read
                      << "] = std::move(val);\n";
             }
         }
 
-        code << ind << "        }\n";
         code << ind << "    }\n";
         code << ind << "}\n";
     }
@@ -172,6 +254,40 @@ std::string TypeConverter::generate_to_capnp_code(const Type& field,
                                                     const std::string& field_name_capnp,
                                                     int indent_level,
                                                     const std::set<std::string>& known_enums)
+{
+    if (!has_presence(field, known_enums))
+    {
+        return generate_to_capnp_body(field, builder_expr, source_var, field_name_capnp, indent_level,
+                                      known_enums);
+    }
+
+    std::ostringstream code;
+    std::string ind = indent(indent_level);
+
+    if (field.is_custom())
+    {
+        // Nested messages are always written; the scope keeps the builder name local
+        code << ind << "{\n";
+    }
+    else
+    {
+        // Empty lists and maps are left unset on the wire
+        code << ind << "if (!" << source_var << ".empty())\n";
+        code << ind << "{\n";
+    }
+    code << generate_to_capnp_body(field, builder_expr, source_var, field_name_capnp, indent_level + 1,
+                                   known_enums);
+    code << ind << "}\n";
+
+    return code.str();
+}
+
+std::string TypeConverter::generate_to_capnp_body(const Type& field,
+                                                    const std::string& builder_expr,
+                                                    const std::string& source_var,
+                                                    const std::string& field_name_capnp,
+                                                    int indent_level,
+                                                    const std::set<std::string>& known_enums)
 {
     std::ostringstream code;
     std::string ind = indent(indent_level);
@@ -205,89 +321,347 @@ std::string TypeConverter::generate_to_capnp_code(const Type& field,
     else if (field.is_custom())
     {
         // Custom message: call to_capnp_struct
-        code << ind << "{\n";
-        code << ind << "    auto nested_builder = " << builder_expr << "."
-             << init_name << "();\n";
-        code << ind << "    " << source_var << ".to_capnp_struct(nested_builder);\n";
-        code << ind << "}\n";
+        code << ind << "auto nested_builder = " << builder_expr << "." << init_name << "();\n";
+        code << ind << source_var << ".to_capnp_struct(nested_builder);\n";
     }
     else if (field.is_list())
     {
         const Type* element_type = field.get_element_type();
 
-        code << ind << "if (!" << source_var << ".empty())\n";
-        code << ind << "{\n";
-        code << ind << "    auto list_builder = " << builder_expr << "." << init_name
+        code << ind << "auto list_builder = " << builder_expr << "." << init_name
              << "(" << source_var << ".size());\n";
-        code << ind << "    for (size_t i = 0; i < " << source_var << ".size(); ++i)\n";
-        code << ind << "    {\n";
 
-        if (element_type->is_primitive())
-        {
-            code << ind << "        list_builder.set(i, " << source_var << "[i]);\n";
-        }
-        else if (is_enum_type(*element_type, known_enums))
+        if (is_fixed_width_primitive(*element_type))
         {
-            std::string elem_type_name = element_type->get_custom_name();
-            code << ind << "        list_builder.set(i, static_cast<::curious::message::"
-                 << elem_type_name << ">(" << source_var << "[i]));\n";
+            // Wire layout matches the host on little-endian: bulk copy
+            code << ind << "MessageBase::bulkCopyToList(" << source_var << ", list_builder);\n";
         }
-        else if (element_type->is_custom())
+        else
         {
-            code << ind << "        auto item_builder = list_builder[i];\n";
-            code << ind << "        " << source_var << "[i].to_capnp_struct(item_builder);\n";
-        }
+            code << ind << "for (size_t i = 0; i < " << source_var << ".size(); ++i)\n";
+            code << ind << "{\n";
 
-        code << ind << "    }\n";
-        code << ind << "}\n";
+            if (element_type->is_primitive())
+            {
+                code << ind << "    list_builder.set(i, " << source_var << "[i]);\n";
+            }
+            else if (is_enum_type(*element_type, known_enums))
+            {
+                std::string elem_type_name = element_type->get_custom_name();
+                code << ind << "    list_builder.set(i, static_cast<::curious::message::"
+                     << elem_type_name << ">(" << source_var << "[i]));\n";
+            }
+            else if (element_type->is_custom())
+            {
+                // Warm the heap storage of upcoming elements while encoding this one
+                code << ind << "    if (i + MessageBase::_k_list_prefetch_distance < " << source_var << ".size())\n";
+                code << ind << "    {\n";
+                code << ind << "        " << source_var << "[i + MessageBase::_k_list_prefetch_distance].prefetch();\n";
+                code << ind << "    }\n";
+                code << ind << "    auto item_builder = list_builder[i];\n";
+                code << ind << "    " << source_var << "[i].to_capnp_struct(item_builder);\n";
+            }
+
+            code << ind << "}\n";
+        }
     }
     else if (field.is_map())
     {
         const Type* key_type = field.get_key_type();
         const Type* value_type = field.get_value_type();
 
-        code << ind << "if (!" << source_var << ".empty())\n";
-        code << ind << "{\n";
-        code << ind << "    auto map_builder = " << builder_expr << "." << init_name << "();\n";
-        code << ind << "    auto entries_builder = map_builder.initEntries("
+        code << ind << "auto map_builder = " << builder_expr << "." << init_name << "();\n";
+        code << ind << "auto entries_builder = map_builder.initEntries("
              << source_var << ".size());\n";
-        code << ind << "    size_t idx = 0;\n";
-        code << ind << "    for (const auto& [key, value] : " << source_var << ")\n";
-        code << ind << "    {\n";
-        code << ind << "        auto entry_builder = entries_builder[idx++];\n";
+        code << ind << "size_t idx = 0;\n";
+        code << ind << "for (const auto& [key, value] : " << source_var << ")\n";
+        code << ind << "{\n";
+        code << ind << "    auto entry_builder = entries_builder[idx++];\n";
 
         // Set key
         if (key_type->is_primitive())
         {
-            code << ind << "        entry_builder.setKey(key);\n";
+            code << ind << "    entry_builder.setKey(key);\n";
         }
 
         // Set value
         if (value_type->is_primitive())
         {
-            code << ind << "        entry_builder.setValue(value);\n";
+            code << ind << "    entry_builder.setValue(value);\n";
         }
         else if (is_enum_type(*value_type, known_enums))
         {
             std::string val_type_name = value_type->get_custom_name();
-            code << ind << "        entry_builder.setValue(static_cast<::curious::message::"
+            code << ind << "    entry_builder.setValue(static_cast<::curious::message::"
                  << val_type_name << ">(value));\n";
         }
         else if (value_type->is_custom())
         {
-            code << ind << "        auto value_builder = entry_builder.initValue();\n";
-            code << ind << "        value.to_capnp_struct(value_builder);\n";
+            code << ind << "    auto value_builder = entry_builder.initValue();\n";
+            code << ind << "    value.to_capnp_struct(value_builder);\n";
         }
 
-        code << ind << "    }\n";
         code << ind << "}\n";
     }
 
     return code.str();
 }
 
+std::string TypeConverter::generate_optional_to_capnp_code(const Type& field,
+                                                             const std::string& builder_expr,
+                                                             int indent_level,
+                                                             const std::set<std::string>& known_enums)
+{
+    std::ostringstream code;
+    std::string ind = indent(indent_level);
+    const std::string& member = field.get_field_name();
+
+    // Written without the empty check, so an engaged but empty list or map still reaches the wire
+    code << ind << "if (" << member << ")\n";
+    code << ind << "{\n";
+    code << generate_to_capnp_body(field, builder_expr, get_value_expr(field, member), member, indent_level + 1,
+                                   known_enums);
+    code << ind << "}\n";
+
+    return code.str();
+}
+
+std::string TypeConverter::generate_optional_from_capnp_code(const Type& field,
+                                                               const std::string& reader_expr,
+                                                               int indent_level,
+                                                               const std::set<std::string>& known_enums,
+                                                               bool validate_utf8)
+{
+    std::ostringstream code;
+    std::string ind = indent(indent_level);
+    const std::string& member = field.get_field_name();
+
+    code << ind << "if (" << reader_expr << ".has" << to_capnp_method_name(member) << "())\n";
+    code << ind << "{\n";
+    code << ind << "    auto& " << member << "_value = " << get_engaged_expr(member) << ";\n";
+    code << generate_from_capnp_body(field, reader_expr, member + "_value", indent_level + 1, known_enums,
+                                     validate_utf8);
+    code << ind << "}\n";
+    code << ind << "else\n";
+    code << ind << "{\n";
+    code << ind << "    " << member << ".reset();\n";
+    code << ind << "}\n";
+
+    return code.str();
+}
+
+std::string TypeConverter::generate_union_to_capnp_code(const UnionDecl& union_decl,
+                                                          const std::string& builder_expr,
+                                                          int indent_level,
+                                                          const std::set<std::string>& known_enums)
+{
+    std::ostringstream code;
+    std::string ind = indent(indent_level);
+    const std::string member = union_decl.get_member_name();
+
+    code << ind << "{\n";
+
+    // Members of a named union are set through its group builder
+    std::string union_builder = builder_expr;
+    if (!union_decl.name.empty())
+    {
+        union_builder = member + "_builder";
+        code << ind << "    auto " << union_builder << " = " << builder_expr << ".get"
+             << to_capnp_method_name(member) << "();\n";
+    }
+
+    code << ind << "    switch (" << member << ".index())\n";
+    code << ind << "    {\n";
+    for (std::size_t i = 0; i < union_decl.arms.size(); ++i)
+    {
+        const Type& arm = union_decl.arms[i];
+        const std::string value = "std::get<" + std::to_string(i) + ">(" + member + ")";
+        const std::string init_name = "init" + to_capnp_method_name(arm.get_field_name());
+
+        code << ind << "        case " << i << ":\n";
+        code << ind << "        {\n";
+
+        // The list and map encoders skip empty values, but the discriminant must still be set
+        if (arm.is_list())
+        {
+            code << ind << "            if (" << value << ".empty())\n";
+            code << ind << "            {\n";
+            code << ind << "                " << union_builder << "." << init_name << "(0);\n";
+            code << ind << "            }\n";
+        }
+        else if (arm.is_map())
+        {
+            code << ind << "            if (" << value << ".empty())\n";
+            code << ind << "            {\n";
+            code << ind << "                " << union_builder << "." << init_name << "();\n";
+            code << ind << "            }\n";
+        }
+
+        code << generate_to_capnp_code(arm, union_builder, value, arm.get_field_name(), indent_level + 3,
+                                       known_enums);
+        code << ind << "            break;\n";
+        code << ind << "        }\n";
+    }
+    code << ind << "    }\n";
+    code << ind << "}\n";
+
+    return code.str();
+}
+
+std::string TypeConverter::generate_union_from_capnp_code(const UnionDecl& union_decl,
+                                                            const std::string& reader_expr,
+                                                            int indent_level,
+                                                            const std::set<std::string>& known_enums,
+                                                            bool validate_utf8)
+{
+    std::ostringstream code;
+    std::string ind = indent(indent_level);
+    const std::string member = union_decl.get_member_name();
+
+    code << ind << "{\n";
+
+    std::string union_reader = reader_expr;
+    if (!union_decl.name.empty())
+    {
+        union_reader = member + "_reader";
+        code << ind << "    auto " << union_reader << " = " << reader_expr << ".get"
+             << to_capnp_method_name(member) << "();\n";
+    }
+
+    // Only the active alternative is read; the others are never touched
+    code << ind << "    switch (" << union_reader << ".which())\n";
+    code << ind << "    {\n";
+    for (std::size_t i = 0; i < union_decl.arms.size(); ++i)
+    {
+        const Type& arm = union_decl.arms[i];
+        code << ind << "        case decltype(" << union_reader << ".which())::"
+             << to_capnp_enumerant_name(arm.get_field_name()) << ":\n";
+        code << ind << "        {\n";
+        code << ind << "            auto& arm_value = " << member << ".emplace<" << i << ">();\n";
+        code << generate_from_capnp_code(arm, union_reader, "arm_value", indent_level + 3, known_enums,
+                                         validate_utf8);
+        code << ind << "            break;\n";
+        code << ind << "        }\n";
+    }
+    code << ind << "        default:\n";
+    code << ind << "            break;\n";
+    code << ind << "    }\n";
+    code << ind << "}\n";
+
+    return code.str();
+}
+
+bool TypeConverter::is_fixed_width_primitive(const Type& type)
+{
+    if (!type.is_primitive())
+    {
+        return false;
+    }
+
+    // Same size and representation in std::vector<T> and on the wire (bool is bit-packed)
+    static const std::set<std::string> fixed_width_types = {
+        "int8_t", "int16_t", "int32_t", "int64_t",
+        "uint8_t", "uint16_t", "uint32_t", "uint64_t",
+        "float", "double"};
+
+    return fixed_width_types.count(type.get_cpp_type()) > 0;
+}
+
+bool TypeConverter::has_presence(const Type& field, const std::set<std::string>& known_enums)
+{
+    return field.is_list() || field.is_map() || (field.is_custom() && !is_enum_type(field, known_enums));
+}
+
+std::string TypeConverter::get_engaged_expr(const std::string& member_expr)
+{
+    return "(" + member_expr + " ? *" + member_expr + " : " + member_expr + ".emplace())";
+}
+
+std::string TypeConverter::get_member_type(const Type& field)
+{
+    if (field.has_annotation("shared"))
+    {
+        return "SharedField<" + field.get_cpp_type() + ">";
+    }
+    if (field.has_annotation("optional"))
+    {
+        return "std::optional<" + field.get_cpp_type() + ">";
+    }
+
+    return field.get_cpp_type();
+}
+
+std::string TypeConverter::get_value_expr(const Type& field, const std::string& member_expr)
+{
+    if (field.has_annotation("shared"))
+    {
+        return member_expr + ".get()";
+    }
+    if (field.has_annotation("optional"))
+    {
+        return "(*" + member_expr + ")";
+    }
+
+    return member_expr;
+}
+
+std::string TypeConverter::get_capnp_cpp_type(const Type& type, const std::string& capnp_namespace)
+{
+    if (type.is_list() && type.get_element_type() != nullptr)
+    {
+        return "::capnp::List<" + get_capnp_cpp_type(*type.get_element_type(), capnp_namespace) + ">";
+    }
+    if (type.is_custom() || type.is_enum())
+    {
+        return "::" + capnp_namespace + "::" + type.get_capnp_type();
+    }
+
+    static const std::unordered_map<std::string, std::string> primitive_types = {
+        {"Bool", "bool"},
+        {"Int8", "std::int8_t"},
+        {"Int16", "std::int16_t"},
+        {"Int32", "std::int32_t"},
+        {"Int64", "std::int64_t"},
+        {"UInt8", "std::uint8_t"},
+        {"UInt16", "std::uint16_t"},
+        {"UInt32", "std::uint32_t"},
+        {"UInt64", "std::uint64_t"},
+        {"Float32", "float"},
+        {"Float64", "double"},
+        {"Text", "::capnp::Text"},
+        {"Data", "::capnp::Data"},
+    };
+    auto it = primitive_types.find(type.get_capnp_type());
+    return it != primitive_types.end() ? it->second : "::capnp::AnyPointer";
+}
+
 std::string TypeConverter::get_default_value(const Type& field)
 {
+    // Declared defaults are validated and canonicalized by the schema
+    if (field.has_default_value())
+    {
+        const std::string& literal = field.get_default_value();
+        const std::string capnp_type = field.get_capnp_type();
+
+        if (field.is_custom())
+        {
+            return field.get_custom_name() + "::" + literal;
+        }
+        else if (capnp_type.rfind("UInt", 0) == 0)
+        {
+            return literal + "u";
+        }
+        else if (capnp_type == "Int64" && literal == "-9223372036854775808")
+        {
+            return "(-9223372036854775807 - 1)";
+        }
+        else if (capnp_type == "Float32")
+        {
+            return literal + "f";
+        }
+        return literal;
+    }
+
     if (field.is_primitive())
     {
         std::string cpp_type = field.get_cpp_type();
@@ -0,0 +1,43 @@
+// Compiles the generated MessageBase.hpp and checks its UTF-8 validator.
+
+#include <cstdio>
+#include <cstring>
+
+#include <messages/MessageBase.hpp>
+
+namespace
+{
+
+int failures = 0;
+
+void expect(bool condition, const char* what)
+{
+    if (!condition)
+    {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+bool valid(const char* text)
+{
+    return curious::net::MessageBase::isValidUtf8(text, std::strlen(text));
+}
+
+} // namespace
+
+int main()
+{
+    expect(valid(""), "empty string");
+    expect(valid("plain ASCII that is longer than one 32-byte vector step"), "ASCII");
+    expect(valid("caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80"), "2-, 3- and 4-byte sequences");
+    expect(!valid("\xC0\xAF"), "overlong 2-byte sequence");
+    expect(!valid("\xE0\x80\xAF"), "overlong 3-byte sequence");
+    expect(!valid("\xED\xA0\x80"), "UTF-16 surrogate");
+    expect(!valid("\xF4\x90\x80\x80"), "code point above U+10FFFF");
+    expect(!valid("\xE2\x82"), "truncated sequence");
+    expect(!valid("\x80"), "stray continuation byte");
+    expect(!valid("\xFF"), "invalid lead byte");
+
+    return failures == 0 ? 0 : 1;
+}